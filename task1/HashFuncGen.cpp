@@ -1,15 +1,195 @@
 #include "HashFuncGen.h"
+#include "HashFuncGenSimd.h"
+#include "HashPolicies.h"
 #include <iostream>
 #include <vector>
 #include <cmath>
 #include <iomanip>
+#include <cstring>
+#include <type_traits>
 
 HashFuncGen::HashFuncGen(uint32_t seed) : seed(seed) {}
 
-uint32_t HashFuncGen::hash(const std::string& str) const {
+namespace {
+
+// Векторное ядро при поддержке процессором, иначе scalar(key) для каждого ключа
+template <typename Key, typename Scalar>
+void hashBatchImpl(const Key* keys, size_t count, uint32_t seed, uint32_t* out,
+                   Scalar scalar) {
+    if (hashsimd::hasAvx512()) {
+        hashsimd::murmur3_32_avx512(keys, count, seed, out);
+    } else if (hashsimd::hasAvx2()) {
+        hashsimd::murmur3_32_avx2(keys, count, seed, out);
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = scalar(keys[i]);
+        }
+    }
+}
+
+template <typename Key, typename Scalar>
+void hashBatch64Impl(const Key* keys, size_t count, uint32_t seed, uint64_t* out,
+                     Scalar scalar) {
+    if (hashsimd::hasAvx512()) {
+        hashsimd::murmur3_64_avx512(keys, count, seed, out);
+    } else if (hashsimd::hasAvx2()) {
+        hashsimd::murmur3_64_avx2(keys, count, seed, out);
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = scalar(keys[i]);
+        }
+    }
+}
+
+} // namespace
+
+uint32_t HashFuncGen::hash(std::string_view str) const {
     return murmur3_32(str, seed);
 }
 
+void HashFuncGen::hashBatch(const std::string* keys, size_t count, uint32_t* out) const {
+    hashBatchImpl(keys, count, seed, out, [this](std::string_view key) { return hash(key); });
+}
+
+void HashFuncGen::hashBatch(const std::string_view* keys, size_t count, uint32_t* out) const {
+    hashBatchImpl(keys, count, seed, out, [this](std::string_view key) { return hash(key); });
+}
+
+uint32_t HashFuncGen::hash(const void* data, size_t length) const {
+    return murmur3_32(std::string_view(static_cast<const char*>(data), length), seed);
+}
+
+uint32_t HashFuncGen::hash(uint64_t key) const {
+    return static_cast<uint32_t>(mixIntKey(key) >> 32);
+}
+
+void HashFuncGen::hashBatch(const uint64_t* keys, size_t count, uint32_t* out) const {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<uint32_t>(mixIntKey(keys[i]) >> 32);
+    }
+}
+
+uint64_t HashFuncGen::hash64(std::string_view str) const {
+    uint64_t out[2];
+    murmur3_x64_128(str, seed, out);
+    return out[0];
+}
+
+void HashFuncGen::hashBatch64(const std::string* keys, size_t count, uint64_t* out) const {
+    hashBatch64Impl(keys, count, seed, out, [this](std::string_view key) { return hash64(key); });
+}
+
+void HashFuncGen::hashBatch64(const std::string_view* keys, size_t count, uint64_t* out) const {
+    hashBatch64Impl(keys, count, seed, out, [this](std::string_view key) { return hash64(key); });
+}
+
+uint64_t HashFuncGen::hash64(const void* data, size_t length) const {
+    return hash64(std::string_view(static_cast<const char*>(data), length));
+}
+
+uint64_t HashFuncGen::hash64(uint64_t key) const {
+    return mixIntKey(key);
+}
+
+void HashFuncGen::hashBatch64(const uint64_t* keys, size_t count, uint64_t* out) const {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = mixIntKey(keys[i]);
+    }
+}
+
+namespace {
+
+// Скалярный пакет для семейств без векторного ядра
+template <HashKind Kind, typename Key>
+void hashBatchPolicy(const Key* keys, size_t count, uint32_t seed, uint64_t* out) {
+    for (size_t i = 0; i < count; ++i) {
+        if constexpr (std::is_same_v<Key, uint64_t>) {
+            out[i] = HashPolicy<Kind>::hash(keys[i], seed);
+        } else {
+            out[i] = HashPolicy<Kind>::hash(keys[i].data(), keys[i].size(), seed);
+        }
+    }
+}
+
+template <typename Key>
+void hashBatch64Kind(const HashFuncGen& hasher, const Key* keys, size_t count,
+                            uint64_t* out, HashKind kind) {
+    switch (kind) {
+        case HashKind::XXH64:
+            hashBatchPolicy<HashKind::XXH64>(keys, count, hasher.getSeed(), out);
+            break;
+        case HashKind::WyHash:
+            hashBatchPolicy<HashKind::WyHash>(keys, count, hasher.getSeed(), out);
+            break;
+        case HashKind::Crc32c:
+            hashBatchPolicy<HashKind::Crc32c>(keys, count, hasher.getSeed(), out);
+            break;
+        default:
+            hasher.hashBatch64(keys, count, out);
+            break;
+    }
+}
+
+} // namespace
+
+const char* hashKindName(HashKind kind) {
+    switch (kind) {
+        case HashKind::Murmur3_32:  return HashPolicy<HashKind::Murmur3_32>::NAME;
+        case HashKind::Murmur3_128: return HashPolicy<HashKind::Murmur3_128>::NAME;
+        case HashKind::XXH64:       return HashPolicy<HashKind::XXH64>::NAME;
+        case HashKind::WyHash:      return HashPolicy<HashKind::WyHash>::NAME;
+        case HashKind::Crc32c:      return HashPolicy<HashKind::Crc32c>::NAME;
+    }
+    return "unknown";
+}
+
+uint64_t HashFuncGen::hash64(const void* data, size_t length, HashKind kind) const {
+    switch (kind) {
+        case HashKind::XXH64:  return HashPolicy<HashKind::XXH64>::hash(data, length, seed);
+        case HashKind::WyHash: return HashPolicy<HashKind::WyHash>::hash(data, length, seed);
+        case HashKind::Crc32c: return HashPolicy<HashKind::Crc32c>::hash(data, length, seed);
+        default:               return hash64(data, length);
+    }
+}
+
+uint64_t HashFuncGen::hash64(std::string_view str, HashKind kind) const {
+    return hash64(str.data(), str.size(), kind);
+}
+
+uint64_t HashFuncGen::hash64(uint64_t key, HashKind kind) const {
+    switch (kind) {
+        case HashKind::XXH64:  return HashPolicy<HashKind::XXH64>::hash(key, seed);
+        case HashKind::WyHash: return HashPolicy<HashKind::WyHash>::hash(key, seed);
+        case HashKind::Crc32c: return HashPolicy<HashKind::Crc32c>::hash(key, seed);
+        default:               return mixIntKey(key);
+    }
+}
+
+void HashFuncGen::hashBatch64(const std::string* keys, size_t count, uint64_t* out,
+                              HashKind kind) const {
+    hashBatch64Kind(*this, keys, count, out, kind);
+}
+
+void HashFuncGen::hashBatch64(const std::string_view* keys, size_t count, uint64_t* out,
+                              HashKind kind) const {
+    hashBatch64Kind(*this, keys, count, out, kind);
+}
+
+void HashFuncGen::hashBatch64(const uint64_t* keys, size_t count, uint64_t* out,
+                              HashKind kind) const {
+    hashBatch64Kind(*this, keys, count, out, kind);
+}
+
+const char* HashFuncGen::batchBackend() {
+    if (hashsimd::hasAvx512()) {
+        return "avx512";
+    }
+    if (hashsimd::hasAvx2()) {
+        return "avx2";
+    }
+    return "scalar";
+}
+
 uint32_t HashFuncGen::getSeed() const {
     return seed;
 }
@@ -19,21 +199,22 @@ void HashFuncGen::setSeed(uint32_t new_seed) {
 }
 
 // MurmurHash3 32-bit implementation
-uint32_t HashFuncGen::murmur3_32(const std::string& key, uint32_t seed) {
-    const uint8_t* data = reinterpret_cast<const uint8_t*>(key.c_str());
-    const int len = key.length();
-    const int nblocks = len / 4;
+uint32_t HashFuncGen::murmur3_32(std::string_view key, uint32_t seed) {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(key.data());
+    const size_t len = key.length();
+    const size_t nblocks = len / 4;
     
     uint32_t h1 = seed;
     
     const uint32_t c1 = 0xcc9e2d51;
     const uint32_t c2 = 0x1b873593;
     
-    // Body
-    const uint32_t* blocks = reinterpret_cast<const uint32_t*>(data + nblocks * 4);
-    
-    for (int i = -nblocks; i; i++) {
-        uint32_t k1 = blocks[i];
+    // Body: блоки читаются через memcpy - разыменование uint32_t* по
+    // невыровненному адресу является неопределенным поведением, а memcpy
+    // компилируется в одну обычную загрузку
+    for (size_t i = 0; i < nblocks; i++) {
+        uint32_t k1;
+        std::memcpy(&k1, data + i * 4, sizeof(k1));
         
         k1 *= c1;
         k1 = rotl32(k1, 15);
@@ -59,12 +240,98 @@ uint32_t HashFuncGen::murmur3_32(const std::string& key, uint32_t seed) {
     }
     
     // Finalization
-    h1 ^= len;
+    h1 ^= static_cast<uint32_t>(len);
     h1 = fmix32(h1);
     
     return h1;
 }
 
+// MurmurHash3 x64_128 implementation
+void HashFuncGen::murmur3_x64_128(std::string_view key, uint32_t seed, uint64_t out[2]) {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(key.data());
+    const size_t len = key.length();
+    const size_t nblocks = len / 16;
+    
+    uint64_t h1 = seed;
+    uint64_t h2 = seed;
+    
+    const uint64_t c1 = 0x87c37b91114253d5ULL;
+    const uint64_t c2 = 0x4cf5ad432745937fULL;
+    
+    // Body
+    for (size_t i = 0; i < nblocks; i++) {
+        uint64_t k1, k2;
+        std::memcpy(&k1, data + i * 16, sizeof(k1));
+        std::memcpy(&k2, data + i * 16 + 8, sizeof(k2));
+        
+        k1 *= c1;
+        k1 = rotl64(k1, 31);
+        k1 *= c2;
+        h1 ^= k1;
+        
+        h1 = rotl64(h1, 27);
+        h1 += h2;
+        h1 = h1 * 5 + 0x52dce729;
+        
+        k2 *= c2;
+        k2 = rotl64(k2, 33);
+        k2 *= c1;
+        h2 ^= k2;
+        
+        h2 = rotl64(h2, 31);
+        h2 += h1;
+        h2 = h2 * 5 + 0x38495ab5;
+    }
+    
+    // Tail
+    const uint8_t* tail = data + nblocks * 16;
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+    
+    switch (len & 15) {
+        case 15: k2 ^= static_cast<uint64_t>(tail[14]) << 48; [[fallthrough]];
+        case 14: k2 ^= static_cast<uint64_t>(tail[13]) << 40; [[fallthrough]];
+        case 13: k2 ^= static_cast<uint64_t>(tail[12]) << 32; [[fallthrough]];
+        case 12: k2 ^= static_cast<uint64_t>(tail[11]) << 24; [[fallthrough]];
+        case 11: k2 ^= static_cast<uint64_t>(tail[10]) << 16; [[fallthrough]];
+        case 10: k2 ^= static_cast<uint64_t>(tail[9]) << 8;   [[fallthrough]];
+        case 9:  k2 ^= static_cast<uint64_t>(tail[8]);
+                 k2 *= c2;
+                 k2 = rotl64(k2, 33);
+                 k2 *= c1;
+                 h2 ^= k2;
+                 [[fallthrough]];
+        case 8:  k1 ^= static_cast<uint64_t>(tail[7]) << 56; [[fallthrough]];
+        case 7:  k1 ^= static_cast<uint64_t>(tail[6]) << 48; [[fallthrough]];
+        case 6:  k1 ^= static_cast<uint64_t>(tail[5]) << 40; [[fallthrough]];
+        case 5:  k1 ^= static_cast<uint64_t>(tail[4]) << 32; [[fallthrough]];
+        case 4:  k1 ^= static_cast<uint64_t>(tail[3]) << 24; [[fallthrough]];
+        case 3:  k1 ^= static_cast<uint64_t>(tail[2]) << 16; [[fallthrough]];
+        case 2:  k1 ^= static_cast<uint64_t>(tail[1]) << 8;  [[fallthrough]];
+        case 1:  k1 ^= static_cast<uint64_t>(tail[0]);
+                 k1 *= c1;
+                 k1 = rotl64(k1, 31);
+                 k1 *= c2;
+                 h1 ^= k1;
+    }
+    
+    // Finalization
+    h1 ^= len;
+    h2 ^= len;
+    
+    h1 += h2;
+    h2 += h1;
+    
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+    
+    h1 += h2;
+    h2 += h1;
+    
+    out[0] = h1;
+    out[1] = h2;
+}
+
 void HashFuncGen::testUniformity(const std::vector<std::string>& data,
                                   uint32_t seed,
                                   int num_buckets) {
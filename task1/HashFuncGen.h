@@ -2,15 +2,39 @@
 #define HASHFUNCGEN_H
 
 #include <string>
+#include <string_view>
 #include <cstdint>
 #include <functional>
+#include <vector>
+
+// Семейство хеш-функций (реализации - HashPolicy<Kind> в HashPolicies.h)
+enum class HashKind : uint8_t {
+    Murmur3_32 = 0,   // MurmurHash3 x86_32: U -> 2^32
+    Murmur3_128 = 1,  // MurmurHash3 x64_128 (первые 64 бита): U -> 2^64
+    XXH64 = 2,        // xxHash XXH64: U -> 2^64
+    WyHash = 3,       // wyhash final4: U -> 2^64
+    Crc32c = 4        // Две цепочки CRC32C (SSE4.2) и fmix64: U -> 2^64
+};
+
+constexpr size_t HASH_KIND_COUNT = 5;
+
+// Разрядность хеша: 32 только для Murmur3_32
+constexpr int hashBits(HashKind kind) {
+    return kind == HashKind::Murmur3_32 ? 32 : 64;
+}
+
+// Короткое имя (совпадает с HashPolicy<Kind>::NAME)
+const char* hashKindName(HashKind kind);
 
 class HashFuncGen {
 private:
     uint32_t seed;
     
     // MurmurHash3 32-bit версия
-    static uint32_t murmur3_32(const std::string& key, uint32_t seed);
+    static uint32_t murmur3_32(std::string_view key, uint32_t seed);
+    
+    // MurmurHash3 x64_128, в out записываются обе 64-битные половины
+    static void murmur3_x64_128(std::string_view key, uint32_t seed, uint64_t out[2]);
     
     // Вспомогательные функции для MurmurHash3
     static inline uint32_t rotl32(uint32_t x, int8_t r) {
@@ -26,12 +50,65 @@ private:
         return h;
     }
     
+    static inline uint64_t rotl64(uint64_t x, int8_t r) {
+        return (x << r) | (x >> (64 - r));
+    }
+    
+    // Смешивание seed с целочисленным ключом перед fmix64
+    inline uint64_t mixIntKey(uint64_t key) const {
+        return fmix64(key ^ (static_cast<uint64_t>(seed) * 0x9E3779B97F4A7C15ULL));
+    }
+    
+    static inline uint64_t fmix64(uint64_t k) {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        k *= 0xc4ceb9fe1a85ec53ULL;
+        k ^= k >> 33;
+        return k;
+    }
+    
 public:
     // Конструктор с seed для хеш-функции
     HashFuncGen(uint32_t seed = 42);
     
     // Основная хеш-функция: U -> M = 2^32
-    uint32_t hash(const std::string& str) const;
+    uint32_t hash(std::string_view str) const;
+    uint32_t hash(const void* data, size_t length) const;
+    
+    // Хеш целочисленного ключа: финализатор fmix64 от ключа, смешанного
+    // с seed (старшие 32 бита). Не совпадает с хешем байтов ключа
+    uint32_t hash(uint64_t key) const;
+    
+    // Пакетное хеширование: out[i] = hash(keys[i]).
+    // Ключи обрабатываются по 8 (AVX2) или 16 (AVX-512) за раз,
+    // реализация выбирается во время выполнения
+    void hashBatch(const std::string* keys, size_t count, uint32_t* out) const;
+    void hashBatch(const std::string_view* keys, size_t count, uint32_t* out) const;
+    void hashBatch(const uint64_t* keys, size_t count, uint32_t* out) const;
+    
+    // 64-битная хеш-функция: U -> M = 2^64 (первая половина MurmurHash3 x64_128)
+    uint64_t hash64(std::string_view str) const;
+    uint64_t hash64(const void* data, size_t length) const;
+    uint64_t hash64(uint64_t key) const;
+    
+    // Пакетное 64-битное хеширование: out[i] = hash64(keys[i]).
+    // Ключи обрабатываются по 8 за раз (AVX-512), иначе скалярно
+    void hashBatch64(const std::string* keys, size_t count, uint64_t* out) const;
+    void hashBatch64(const std::string_view* keys, size_t count, uint64_t* out) const;
+    void hashBatch64(const uint64_t* keys, size_t count, uint64_t* out) const;
+    
+    // 64-битный хеш выбранного семейства (hashBits(kind) == 64);
+    // для Murmur3_128 совпадает с функциями выше
+    uint64_t hash64(std::string_view str, HashKind kind) const;
+    uint64_t hash64(const void* data, size_t length, HashKind kind) const;
+    uint64_t hash64(uint64_t key, HashKind kind) const;
+    void hashBatch64(const std::string* keys, size_t count, uint64_t* out, HashKind kind) const;
+    void hashBatch64(const std::string_view* keys, size_t count, uint64_t* out, HashKind kind) const;
+    void hashBatch64(const uint64_t* keys, size_t count, uint64_t* out, HashKind kind) const;
+    
+    // Название выбранной реализации пакетного хеширования
+    static const char* batchBackend();
     
     // Получение seed
     uint32_t getSeed() const;
@@ -0,0 +1,586 @@
+#include "HashFuncGenSimd.h"
+#include <immintrin.h>
+#include <cstring>
+#include <algorithm>
+
+// Схема ядер: ключи группы раскладываются по дорожкам, каждая дорожка
+// загружается "строкой" из 32 байт (байты за концом ключа обнуляются),
+// затем строки транспонируются так, что i-й вектор содержит i-й 4-байтный
+// блок всех ключей. Нулевое дополнение делает блок, следующий за последним
+// полным, равным хвостовому k1 из скалярной версии, поэтому body и tail
+// обрабатываются одним проходом по блокам без ветвлений на дорожку.
+
+namespace {
+
+constexpr uint32_t C1 = 0xcc9e2d51;
+constexpr uint32_t C2 = 0x1b873593;
+
+// Длина части ключа, попадающей в сегмент из 32 байт с началом offset
+inline uint32_t segmentLength(uint32_t len, uint32_t offset) {
+    return len > offset ? std::min<uint32_t>(len - offset, 32) : 0;
+}
+
+// Адрес пустых дорожек: к нему, как и к указателю ключа, можно прибавить 0
+const uint8_t EMPTY_KEY[1] = {0};
+
+// Раскладка группы ключей по дорожкам; пустые дорожки имеют длину 0
+template <int LANES, typename Key>
+inline uint32_t prepareLanes(const Key* keys, size_t n,
+                             const uint8_t** ptr, uint32_t* len) {
+    uint32_t max_len = 0;
+    for (int lane = 0; lane < LANES; ++lane) {
+        if (static_cast<size_t>(lane) < n) {
+            ptr[lane] = reinterpret_cast<const uint8_t*>(keys[lane].data());
+            len[lane] = static_cast<uint32_t>(keys[lane].size());
+        } else {
+            ptr[lane] = EMPTY_KEY;
+            len[lane] = 0;
+        }
+        max_len = std::max(max_len, len[lane]);
+    }
+    return max_len;
+}
+
+// ---------------------------------------------------------------- AVX2
+
+// Загрузка n (1..32) байт ключа с обнулением остальных байтов строки.
+// Читаются только байты ключа: целые 4-байтные слова - маскированной
+// загрузкой (слова вне маски не читаются и не вызывают ошибок доступа),
+// 1-3 байта неполного слова - без ветвлений, тремя байтовыми чтениями
+// (первый, средний и последний байт, как в хвосте скалярной версии)
+__attribute__((target("avx2")))
+inline __m256i loadRowAvx2(const uint8_t* p, uint32_t n) {
+    if (n >= 32) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+    const __m256i iota = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i words = _mm256_set1_epi32(static_cast<int>(n / 4));
+    __m256i row = _mm256_maskload_epi32(reinterpret_cast<const int*>(p),
+                                        _mm256_cmpgt_epi32(words, iota));
+    // При n % 4 == 0 индексы смещаются на байт назад (внутрь ключа),
+    // а результат обнуляется
+    const uint32_t rem = n & 3;
+    const uint32_t empty = rem == 0;
+    const uint32_t first = n - rem - empty;
+    uint32_t tail = p[first] |
+                    (uint32_t(p[first + rem / 2]) << (8 * (rem / 2))) |
+                    (uint32_t(p[n - 1]) << (8 * ((rem - 1) & 3)));
+    tail &= empty - 1;
+    return _mm256_blendv_epi8(row, _mm256_set1_epi32(static_cast<int>(tail)),
+                              _mm256_cmpeq_epi32(words, iota));
+}
+
+// Транспонирование 8x8 32-битных слов: на выходе c[j] = j-е слово каждой строки
+__attribute__((target("avx2")))
+inline void transpose8x8(const __m256i* r, __m256i* c) {
+    __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+    __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+    __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+    __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+    __m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+    __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+    __m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+    
+    __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+    __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+    __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+    __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+    __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+    __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+    __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+    __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+    
+    c[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    c[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    c[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    c[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    c[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    c[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    c[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    c[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+template <int R>
+__attribute__((target("avx2")))
+inline __m256i rotl8x32(__m256i x) {
+    return _mm256_or_si256(_mm256_slli_epi32(x, R), _mm256_srli_epi32(x, 32 - R));
+}
+
+__attribute__((target("avx2")))
+inline __m256i mixK8(__m256i k) {
+    k = _mm256_mullo_epi32(k, _mm256_set1_epi32(C1));
+    k = rotl8x32<15>(k);
+    return _mm256_mullo_epi32(k, _mm256_set1_epi32(C2));
+}
+
+template <typename Key>
+__attribute__((target("avx2")))
+void murmurGroup8(const Key* keys, size_t n, uint32_t seed, uint32_t* out) {
+    const uint8_t* ptr[8];
+    alignas(32) uint32_t len[8];
+    const uint32_t max_len = prepareLanes<8>(keys, n, ptr, len);
+    
+    const __m256i lens = _mm256_load_si256(reinterpret_cast<const __m256i*>(len));
+    const __m256i nblocks = _mm256_srli_epi32(lens, 2);
+    const __m256i has_tail = _mm256_cmpgt_epi32(_mm256_and_si256(lens, _mm256_set1_epi32(3)),
+                                                _mm256_setzero_si256());
+    __m256i h = _mm256_set1_epi32(seed);
+    
+    const uint32_t total_blocks = (max_len + 3) / 4;
+    for (uint32_t base = 0; base < total_blocks; base += 8) {
+        __m256i rows[8];
+        __m256i cols[8];
+        for (int lane = 0; lane < 8; ++lane) {
+            // Указатель сдвигается только внутри ключа
+            const uint32_t n = segmentLength(len[lane], 4 * base);
+            rows[lane] = n ? loadRowAvx2(ptr[lane] + 4 * base, n) : _mm256_setzero_si256();
+        }
+        transpose8x8(rows, cols);
+        
+        const uint32_t count = std::min<uint32_t>(8, total_blocks - base);
+        for (uint32_t i = 0; i < count; ++i) {
+            const __m256i b = _mm256_set1_epi32(base + i);
+            __m256i k = mixK8(cols[i]);
+            
+            // Body: дорожки, у которых блоки закончились, сохраняют свой h
+            __m256i hn = rotl8x32<13>(_mm256_xor_si256(h, k));
+            hn = _mm256_add_epi32(_mm256_mullo_epi32(hn, _mm256_set1_epi32(5)),
+                                  _mm256_set1_epi32(0xe6546b64));
+            __m256i body = _mm256_cmpgt_epi32(nblocks, b);
+            
+            // Tail: блок с номером nblocks у ключей с len % 4 != 0
+            __m256i tail = _mm256_and_si256(_mm256_cmpeq_epi32(nblocks, b), has_tail);
+            
+            h = _mm256_blendv_epi8(h, hn, body);
+            h = _mm256_blendv_epi8(h, _mm256_xor_si256(h, k), tail);
+        }
+    }
+    
+    // Finalization
+    h = _mm256_xor_si256(h, lens);
+    h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+    h = _mm256_mullo_epi32(h, _mm256_set1_epi32(0x85ebca6b));
+    h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 13));
+    h = _mm256_mullo_epi32(h, _mm256_set1_epi32(0xc2b2ae35));
+    h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+    
+    alignas(32) uint32_t res[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(res), h);
+    std::memcpy(out, res, n * sizeof(uint32_t));
+}
+
+// Транспонирование 4 строк по 4 64-битных слова: c[j] = j-е слово каждой строки
+__attribute__((target("avx2")))
+inline void transpose4x4(const __m256i* r, __m256i* c) {
+    __m256i t0 = _mm256_unpacklo_epi64(r[0], r[1]);
+    __m256i t1 = _mm256_unpackhi_epi64(r[0], r[1]);
+    __m256i t2 = _mm256_unpacklo_epi64(r[2], r[3]);
+    __m256i t3 = _mm256_unpackhi_epi64(r[2], r[3]);
+    c[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+    c[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+    c[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+    c[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+}
+
+// Умножение 64-битных дорожек на константу: в AVX2 нет vpmullq,
+// произведение собирается из трех 32x32 -> 64 умножений
+__attribute__((target("avx2")))
+inline __m256i mul64x4(__m256i a, uint64_t c) {
+    const __m256i lo = _mm256_set1_epi64x(static_cast<int64_t>(c & 0xFFFFFFFF));
+    const __m256i hi = _mm256_set1_epi64x(static_cast<int64_t>(c >> 32));
+    __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), lo),
+                                      _mm256_mul_epu32(a, hi));
+    return _mm256_add_epi64(_mm256_mul_epu32(a, lo), _mm256_slli_epi64(cross, 32));
+}
+
+template <int R>
+__attribute__((target("avx2")))
+inline __m256i rotl4x64(__m256i x) {
+    return _mm256_or_si256(_mm256_slli_epi64(x, R), _mm256_srli_epi64(x, 64 - R));
+}
+
+__attribute__((target("avx2")))
+inline __m256i fmix64x4(__m256i k) {
+    k = _mm256_xor_si256(k, _mm256_srli_epi64(k, 33));
+    k = mul64x4(k, 0xff51afd7ed558ccdULL);
+    k = _mm256_xor_si256(k, _mm256_srli_epi64(k, 33));
+    k = mul64x4(k, 0xc4ceb9fe1a85ec53ULL);
+    return _mm256_xor_si256(k, _mm256_srli_epi64(k, 33));
+}
+
+// MurmurHash3 x64_128 для 16 ключей: четыре независимые четверки 64-битных
+// дорожек (цепочки умножений четверок перекрываются).
+// Хвост обрабатывается так же, как в ядре AVX-512 (см. murmur128Group16)
+template <typename Key>
+__attribute__((target("avx2")))
+void murmur128Group16Avx2(const Key* keys, size_t n, uint32_t seed, uint64_t* out) {
+    const uint64_t c1 = 0x87c37b91114253d5ULL;
+    const uint64_t c2 = 0x4cf5ad432745937fULL;
+    
+    const uint8_t* ptr[16];
+    alignas(32) uint32_t len[16];
+    const uint32_t max_len = prepareLanes<16>(keys, n, ptr, len);
+    
+    __m256i lens[4];
+    __m256i nblocks[4];
+    __m256i h1[4];
+    __m256i h2[4];
+    #pragma GCC unroll 4
+    for (int part = 0; part < 4; ++part) {
+        lens[part] = _mm256_cvtepu32_epi64(_mm_load_si128(reinterpret_cast<const __m128i*>(len + 4 * part)));
+        nblocks[part] = _mm256_srli_epi64(lens[part], 4);
+        h1[part] = _mm256_set1_epi64x(seed);
+        h2[part] = _mm256_set1_epi64x(seed);
+    }
+    
+    const uint32_t total_blocks = max_len / 16 + 1;
+    for (uint32_t base = 0; base < total_blocks; base += 2) {
+        __m256i rows[16];
+        __m256i cols[4][4];
+        for (int lane = 0; lane < 16; ++lane) {
+            const uint32_t n = segmentLength(len[lane], 16 * base);
+            rows[lane] = n ? loadRowAvx2(ptr[lane] + 16 * base, n) : _mm256_setzero_si256();
+        }
+        #pragma GCC unroll 4
+        for (int part = 0; part < 4; ++part) {
+            transpose4x4(rows + 4 * part, cols[part]);
+        }
+        
+        const uint32_t count = std::min<uint32_t>(2, total_blocks - base);
+        for (uint32_t i = 0; i < count; ++i) {
+            const __m256i b = _mm256_set1_epi64x(base + i);
+            #pragma GCC unroll 4
+            for (int part = 0; part < 4; ++part) {
+                __m256i k1 = rotl4x64<31>(mul64x4(cols[part][2 * i], c1));
+                k1 = mul64x4(k1, c2);
+                __m256i k2 = rotl4x64<33>(mul64x4(cols[part][2 * i + 1], c2));
+                k2 = mul64x4(k2, c1);
+                
+                // Body
+                __m256i n1 = rotl4x64<27>(_mm256_xor_si256(h1[part], k1));
+                n1 = _mm256_add_epi64(n1, h2[part]);
+                n1 = _mm256_add_epi64(_mm256_add_epi64(_mm256_slli_epi64(n1, 2), n1),
+                                      _mm256_set1_epi64x(0x52dce729));
+                __m256i n2 = rotl4x64<31>(_mm256_xor_si256(h2[part], k2));
+                n2 = _mm256_add_epi64(n2, n1);
+                n2 = _mm256_add_epi64(_mm256_add_epi64(_mm256_slli_epi64(n2, 2), n2),
+                                      _mm256_set1_epi64x(0x38495ab5));
+                __m256i body = _mm256_cmpgt_epi64(nblocks[part], b);
+                
+                // Tail
+                __m256i tail = _mm256_cmpeq_epi64(nblocks[part], b);
+                
+                h1[part] = _mm256_blendv_epi8(h1[part], n1, body);
+                h2[part] = _mm256_blendv_epi8(h2[part], n2, body);
+                h1[part] = _mm256_xor_si256(h1[part], _mm256_and_si256(k1, tail));
+                h2[part] = _mm256_xor_si256(h2[part], _mm256_and_si256(k2, tail));
+            }
+        }
+    }
+    
+    // Finalization
+    alignas(32) uint64_t res[16];
+    #pragma GCC unroll 4
+    for (int part = 0; part < 4; ++part) {
+        __m256i a = _mm256_xor_si256(h1[part], lens[part]);
+        __m256i c = _mm256_xor_si256(h2[part], lens[part]);
+        a = _mm256_add_epi64(a, c);
+        c = _mm256_add_epi64(c, a);
+        a = fmix64x4(a);
+        c = fmix64x4(c);
+        if (n == 16) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 4 * part), _mm256_add_epi64(a, c));
+        } else {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(res + 4 * part), _mm256_add_epi64(a, c));
+        }
+    }
+    if (n < 16) {
+        std::memcpy(out, res, n * sizeof(uint64_t));
+    }
+}
+
+// ------------------------------------------------------------- AVX-512
+
+// GCC 12 выдаёт ложные -Wuninitialized на _mm512_undefined_epi32()
+// внутри интринсиков сдвига
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+#define AVX512_TARGET __attribute__((target("avx2,avx512f,avx512bw,avx512vl,avx512dq")))
+
+// Маскированная загрузка не обращается к байтам за концом ключа
+AVX512_TARGET
+inline __m256i loadRowAvx512(const uint8_t* p, uint32_t n) {
+    __mmask32 mask = n >= 32 ? ~0U : (1U << n) - 1;
+    return _mm256_maskz_loadu_epi8(mask, p);
+}
+
+AVX512_TARGET
+inline __m512i mixK16(__m512i k) {
+    k = _mm512_mullo_epi32(k, _mm512_set1_epi32(C1));
+    k = _mm512_rol_epi32(k, 15);
+    return _mm512_mullo_epi32(k, _mm512_set1_epi32(C2));
+}
+
+template <typename Key>
+AVX512_TARGET
+void murmurGroup16(const Key* keys, size_t n, uint32_t seed, uint32_t* out) {
+    const uint8_t* ptr[16];
+    alignas(64) uint32_t len[16];
+    const uint32_t max_len = prepareLanes<16>(keys, n, ptr, len);
+    
+    const __m512i lens = _mm512_load_si512(len);
+    const __m512i nblocks = _mm512_srli_epi32(lens, 2);
+    const __mmask16 has_tail = _mm512_test_epi32_mask(lens, _mm512_set1_epi32(3));
+    __m512i h = _mm512_set1_epi32(seed);
+    
+    const uint32_t total_blocks = (max_len + 3) / 4;
+    for (uint32_t base = 0; base < total_blocks; base += 8) {
+        __m256i rows[16];
+        __m256i lo[8];
+        __m256i hi[8];
+        for (int lane = 0; lane < 16; ++lane) {
+            const uint32_t n = segmentLength(len[lane], 4 * base);
+            rows[lane] = n ? loadRowAvx512(ptr[lane] + 4 * base, n) : _mm256_setzero_si256();
+        }
+        transpose8x8(rows, lo);
+        transpose8x8(rows + 8, hi);
+        
+        const uint32_t count = std::min<uint32_t>(8, total_blocks - base);
+        for (uint32_t i = 0; i < count; ++i) {
+            const __m512i b = _mm512_set1_epi32(base + i);
+            __m512i k = mixK16(_mm512_inserti64x4(_mm512_castsi256_si512(lo[i]), hi[i], 1));
+            
+            // Body
+            __m512i hn = _mm512_rol_epi32(_mm512_xor_si512(h, k), 13);
+            hn = _mm512_add_epi32(_mm512_mullo_epi32(hn, _mm512_set1_epi32(5)),
+                                  _mm512_set1_epi32(0xe6546b64));
+            __mmask16 body = _mm512_cmpgt_epu32_mask(nblocks, b);
+            
+            // Tail
+            __mmask16 tail = _mm512_mask_cmpeq_epu32_mask(has_tail, nblocks, b);
+            
+            h = _mm512_mask_mov_epi32(h, body, hn);
+            h = _mm512_mask_xor_epi32(h, tail, h, k);
+        }
+    }
+    
+    // Finalization
+    h = _mm512_xor_si512(h, lens);
+    h = _mm512_xor_si512(h, _mm512_srli_epi32(h, 16));
+    h = _mm512_mullo_epi32(h, _mm512_set1_epi32(0x85ebca6b));
+    h = _mm512_xor_si512(h, _mm512_srli_epi32(h, 13));
+    h = _mm512_mullo_epi32(h, _mm512_set1_epi32(0xc2b2ae35));
+    h = _mm512_xor_si512(h, _mm512_srli_epi32(h, 16));
+    
+    alignas(64) uint32_t res[16];
+    _mm512_store_si512(res, h);
+    std::memcpy(out, res, n * sizeof(uint32_t));
+}
+
+// Транспонирование 8 строк по 4 64-битных слова: c[j] = j-е слово каждой строки
+AVX512_TARGET
+inline void transpose8x4(const __m256i* r, __m512i* c) {
+    const __m512i lo = _mm512_setr_epi64(0, 4, 8, 12, 1, 5, 9, 13);
+    const __m512i hi = _mm512_setr_epi64(2, 6, 10, 14, 3, 7, 11, 15);
+    const __m512i first = _mm512_setr_epi64(0, 1, 2, 3, 8, 9, 10, 11);
+    const __m512i second = _mm512_setr_epi64(4, 5, 6, 7, 12, 13, 14, 15);
+    
+    __m512i r01 = _mm512_inserti64x4(_mm512_castsi256_si512(r[0]), r[1], 1);
+    __m512i r23 = _mm512_inserti64x4(_mm512_castsi256_si512(r[2]), r[3], 1);
+    __m512i r45 = _mm512_inserti64x4(_mm512_castsi256_si512(r[4]), r[5], 1);
+    __m512i r67 = _mm512_inserti64x4(_mm512_castsi256_si512(r[6]), r[7], 1);
+    
+    // Слова 0-1 и 2-3 строк 0..3 и 4..7
+    __m512i a01 = _mm512_permutex2var_epi64(r01, lo, r23);
+    __m512i a23 = _mm512_permutex2var_epi64(r01, hi, r23);
+    __m512i b01 = _mm512_permutex2var_epi64(r45, lo, r67);
+    __m512i b23 = _mm512_permutex2var_epi64(r45, hi, r67);
+    
+    c[0] = _mm512_permutex2var_epi64(a01, first, b01);
+    c[1] = _mm512_permutex2var_epi64(a01, second, b01);
+    c[2] = _mm512_permutex2var_epi64(a23, first, b23);
+    c[3] = _mm512_permutex2var_epi64(a23, second, b23);
+}
+
+AVX512_TARGET
+inline __m512i fmix64x8(__m512i k) {
+    k = _mm512_xor_si512(k, _mm512_srli_epi64(k, 33));
+    k = _mm512_mullo_epi64(k, _mm512_set1_epi64(0xff51afd7ed558ccdULL));
+    k = _mm512_xor_si512(k, _mm512_srli_epi64(k, 33));
+    k = _mm512_mullo_epi64(k, _mm512_set1_epi64(0xc4ceb9fe1a85ec53ULL));
+    return _mm512_xor_si512(k, _mm512_srli_epi64(k, 33));
+}
+
+// Блок b (k1 = w1, k2 = w2) MurmurHash3 x64_128 для 8 дорожек: body у
+// дорожек с nblocks > b, хвост у дорожек с nblocks == b
+AVX512_TARGET
+inline void murmur128Block8(__m512i& h1, __m512i& h2, __m512i nblocks,
+                            __m512i w1, __m512i w2, __m512i b) {
+    const uint64_t c1 = 0x87c37b91114253d5ULL;
+    const uint64_t c2 = 0x4cf5ad432745937fULL;
+    
+    __m512i k1 = _mm512_mullo_epi64(w1, _mm512_set1_epi64(c1));
+    k1 = _mm512_rol_epi64(k1, 31);
+    k1 = _mm512_mullo_epi64(k1, _mm512_set1_epi64(c2));
+    
+    __m512i k2 = _mm512_mullo_epi64(w2, _mm512_set1_epi64(c2));
+    k2 = _mm512_rol_epi64(k2, 33);
+    k2 = _mm512_mullo_epi64(k2, _mm512_set1_epi64(c1));
+    
+    // Body
+    __m512i n1 = _mm512_rol_epi64(_mm512_xor_si512(h1, k1), 27);
+    n1 = _mm512_add_epi64(n1, h2);
+    n1 = _mm512_add_epi64(_mm512_add_epi64(_mm512_slli_epi64(n1, 2), n1),
+                          _mm512_set1_epi64(0x52dce729));
+    __m512i n2 = _mm512_rol_epi64(_mm512_xor_si512(h2, k2), 31);
+    n2 = _mm512_add_epi64(n2, n1);
+    n2 = _mm512_add_epi64(_mm512_add_epi64(_mm512_slli_epi64(n2, 2), n2),
+                          _mm512_set1_epi64(0x38495ab5));
+    __mmask8 body = _mm512_cmpgt_epu64_mask(nblocks, b);
+    
+    // Tail
+    __mmask8 tail = _mm512_cmpeq_epu64_mask(nblocks, b);
+    
+    h1 = _mm512_mask_mov_epi64(h1, body, n1);
+    h2 = _mm512_mask_mov_epi64(h2, body, n2);
+    h1 = _mm512_mask_xor_epi64(h1, tail, h1, k1);
+    h2 = _mm512_mask_xor_epi64(h2, tail, h2, k2);
+}
+
+// MurmurHash3 x64_128 для 16 ключей: две независимые половины по 8
+// дорожек, в out пишется первая половина хеша. Хвост (len % 16 байт) с
+// нулевым дополнением даёт те же k1/k2, что и switch в скалярной версии,
+// а нулевые k1/k2 не меняют h1/h2
+template <typename Key>
+AVX512_TARGET
+void murmur128Group16(const Key* keys, size_t n, uint32_t seed, uint64_t* out) {
+    const uint8_t* ptr[16];
+    alignas(64) uint32_t len[16];
+    const uint32_t max_len = prepareLanes<16>(keys, n, ptr, len);
+    
+    __m512i lens[2];
+    __m512i nblocks[2];
+    __m512i h1[2];
+    __m512i h2[2];
+    #pragma GCC unroll 2
+    for (int half = 0; half < 2; ++half) {
+        lens[half] = _mm512_cvtepu32_epi64(
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(len + 8 * half)));
+        nblocks[half] = _mm512_srli_epi64(lens[half], 4);
+        h1[half] = _mm512_set1_epi64(seed);
+        h2[half] = _mm512_set1_epi64(seed);
+    }
+    
+    const uint32_t total_blocks = max_len / 16 + 1;
+    for (uint32_t base = 0; base < total_blocks; base += 2) {
+        __m256i rows[16];
+        __m512i cols[2][4];
+        for (int lane = 0; lane < 16; ++lane) {
+            const uint32_t offset = std::min<uint32_t>(16 * base, len[lane]);
+            rows[lane] = loadRowAvx512(ptr[lane] + offset, std::min<uint32_t>(len[lane] - offset, 32));
+        }
+        transpose8x4(rows, cols[0]);
+        transpose8x4(rows + 8, cols[1]);
+        
+        // Блок base и, если он есть, base + 1
+        #pragma GCC unroll 2
+        for (int half = 0; half < 2; ++half) {
+            murmur128Block8(h1[half], h2[half], nblocks[half], cols[half][0], cols[half][1],
+                            _mm512_set1_epi64(base));
+        }
+        if (base + 1 < total_blocks) {
+            #pragma GCC unroll 2
+            for (int half = 0; half < 2; ++half) {
+                murmur128Block8(h1[half], h2[half], nblocks[half], cols[half][2], cols[half][3],
+                                _mm512_set1_epi64(base + 1));
+            }
+        }
+    }
+    
+    // Finalization; неполная группа пишется по маске
+    #pragma GCC unroll 2
+    for (int half = 0; half < 2; ++half) {
+        __m512i a = _mm512_xor_si512(h1[half], lens[half]);
+        __m512i c = _mm512_xor_si512(h2[half], lens[half]);
+        a = _mm512_add_epi64(a, c);
+        c = _mm512_add_epi64(c, a);
+        a = fmix64x8(a);
+        c = fmix64x8(c);
+        const size_t done = std::min<size_t>(n, 8 * half);
+        const __mmask8 mask = static_cast<__mmask8>((1U << std::min<size_t>(n - done, 8)) - 1);
+        _mm512_mask_storeu_epi64(out + done, mask, _mm512_add_epi64(a, c));
+    }
+}
+
+#undef AVX512_TARGET
+
+// Обработка count ключей группами по GROUP ключей ядром kernel
+template <size_t GROUP, typename Key, typename Hash, typename Kernel>
+inline void hashGroups(Kernel kernel, const Key* keys, size_t count, uint32_t seed, Hash* out) {
+    for (size_t i = 0; i < count; i += GROUP) {
+        kernel(keys + i, std::min<size_t>(GROUP, count - i), seed, out + i);
+    }
+}
+#pragma GCC diagnostic pop
+
+} // namespace
+
+namespace hashsimd {
+
+bool hasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+bool hasAvx512() {
+    static const bool supported = __builtin_cpu_supports("avx512f") &&
+                                  __builtin_cpu_supports("avx512bw") &&
+                                  __builtin_cpu_supports("avx512vl") &&
+                                  __builtin_cpu_supports("avx512dq");
+    return supported;
+}
+
+void murmur3_32_avx2(const std::string* keys, size_t count,
+                     uint32_t seed, uint32_t* out) {
+    hashGroups<8>(murmurGroup8<std::string>, keys, count, seed, out);
+}
+
+void murmur3_32_avx2(const std::string_view* keys, size_t count,
+                     uint32_t seed, uint32_t* out) {
+    hashGroups<8>(murmurGroup8<std::string_view>, keys, count, seed, out);
+}
+
+void murmur3_32_avx512(const std::string* keys, size_t count,
+                       uint32_t seed, uint32_t* out) {
+    hashGroups<16>(murmurGroup16<std::string>, keys, count, seed, out);
+}
+
+void murmur3_32_avx512(const std::string_view* keys, size_t count,
+                       uint32_t seed, uint32_t* out) {
+    hashGroups<16>(murmurGroup16<std::string_view>, keys, count, seed, out);
+}
+
+void murmur3_64_avx2(const std::string* keys, size_t count,
+                     uint32_t seed, uint64_t* out) {
+    hashGroups<16>(murmur128Group16Avx2<std::string>, keys, count, seed, out);
+}
+
+void murmur3_64_avx2(const std::string_view* keys, size_t count,
+                     uint32_t seed, uint64_t* out) {
+    hashGroups<16>(murmur128Group16Avx2<std::string_view>, keys, count, seed, out);
+}
+
+void murmur3_64_avx512(const std::string* keys, size_t count,
+                       uint32_t seed, uint64_t* out) {
+    hashGroups<16>(murmur128Group16<std::string>, keys, count, seed, out);
+}
+
+void murmur3_64_avx512(const std::string_view* keys, size_t count,
+                       uint32_t seed, uint64_t* out) {
+    hashGroups<16>(murmur128Group16<std::string_view>, keys, count, seed, out);
+}
+
+} // namespace hashsimd
@@ -0,0 +1,42 @@
+#ifndef HASHFUNCGENSIMD_H
+#define HASHFUNCGENSIMD_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+// Векторные ядра MurmurHash3 для HashFuncGen::hashBatch/hashBatch64.
+// Ядра компилируются с атрибутом target, поэтому вызывать их можно
+// только после проверки поддержки набора инструкций процессором.
+namespace hashsimd {
+
+// Проверка возможностей процессора (результат кешируется)
+bool hasAvx2();
+bool hasAvx512();
+
+// Хеширование count ключей группами по 8 (AVX2) или 16 (AVX-512) ключей.
+// Результат побитно совпадает со скалярным murmur3_32
+void murmur3_32_avx2(const std::string* keys, size_t count,
+                     uint32_t seed, uint32_t* out);
+void murmur3_32_avx2(const std::string_view* keys, size_t count,
+                     uint32_t seed, uint32_t* out);
+void murmur3_32_avx512(const std::string* keys, size_t count,
+                       uint32_t seed, uint32_t* out);
+void murmur3_32_avx512(const std::string_view* keys, size_t count,
+                       uint32_t seed, uint32_t* out);
+
+// MurmurHash3 x64_128 (первая половина) группами по 16 ключей (AVX2 и
+// AVX-512). Результат побитно совпадает с HashFuncGen::hash64
+void murmur3_64_avx2(const std::string* keys, size_t count,
+                     uint32_t seed, uint64_t* out);
+void murmur3_64_avx2(const std::string_view* keys, size_t count,
+                     uint32_t seed, uint64_t* out);
+void murmur3_64_avx512(const std::string* keys, size_t count,
+                       uint32_t seed, uint64_t* out);
+void murmur3_64_avx512(const std::string_view* keys, size_t count,
+                       uint32_t seed, uint64_t* out);
+
+} // namespace hashsimd
+
+#endif // HASHFUNCGENSIMD_H
@@ -0,0 +1,320 @@
+#ifndef HASHPOLICIES_H
+#define HASHPOLICIES_H
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <nmmintrin.h>
+#include "HashFuncGen.h"
+
+// Хеш-функции как политики времени компиляции: HashPolicy<Kind> дает
+//   Result                      - uint32_t или uint64_t (hashBits(Kind) бит)
+//   hash(data, length, seed)    - хеш байтов
+//   hash(key, seed)             - хеш целочисленного ключа
+//   NAME                        - короткое имя для вывода
+// FixedHyperLogLog<B, Kind> вызывает политику напрямую (без ветвлений по
+// виду хеша), HashFuncGen::hash64(..., kind) выбирает ее во время работы.
+// Целочисленные ключи для Murmur3 хешируются финализатором fmix64 (как
+// HashFuncGen::hash(uint64_t)), для остальных функций - как 8 байт ключа
+template <HashKind Kind>
+struct HashPolicy;
+
+namespace hashpolicy {
+
+inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t read64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t fmix64(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+// XXH64 (Collet), эталонный алгоритм
+constexpr uint64_t XXH_P1 = 11400714785074694791ULL;
+constexpr uint64_t XXH_P2 = 14029467366897019727ULL;
+constexpr uint64_t XXH_P3 = 1609587929392839161ULL;
+constexpr uint64_t XXH_P4 = 9650029242287828579ULL;
+constexpr uint64_t XXH_P5 = 2870177450012600261ULL;
+
+inline uint64_t xxhRound(uint64_t acc, uint64_t input) {
+    acc += input * XXH_P2;
+    acc = rotl64(acc, 31);
+    return acc * XXH_P1;
+}
+
+inline uint64_t xxhMerge(uint64_t acc, uint64_t value) {
+    acc ^= xxhRound(0, value);
+    return acc * XXH_P1 + XXH_P4;
+}
+
+inline uint64_t xxh64(const void* data, size_t length, uint64_t seed) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* end = p + length;
+    uint64_t h;
+
+    if (length >= 32) {
+        uint64_t v1 = seed + XXH_P1 + XXH_P2;
+        uint64_t v2 = seed + XXH_P2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - XXH_P1;
+        do {
+            v1 = xxhRound(v1, read64(p));
+            v2 = xxhRound(v2, read64(p + 8));
+            v3 = xxhRound(v3, read64(p + 16));
+            v4 = xxhRound(v4, read64(p + 24));
+            p += 32;
+        } while (p + 32 <= end);
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xxhMerge(h, v1);
+        h = xxhMerge(h, v2);
+        h = xxhMerge(h, v3);
+        h = xxhMerge(h, v4);
+    } else {
+        h = seed + XXH_P5;
+    }
+    h += length;
+
+    for (; p + 8 <= end; p += 8) {
+        h ^= xxhRound(0, read64(p));
+        h = rotl64(h, 27) * XXH_P1 + XXH_P4;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(read32(p)) * XXH_P1;
+        h = rotl64(h, 23) * XXH_P2 + XXH_P3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        h ^= *p * XXH_P5;
+        h = rotl64(h, 11) * XXH_P1;
+    }
+
+    h ^= h >> 33;
+    h *= XXH_P2;
+    h ^= h >> 29;
+    h *= XXH_P3;
+    h ^= h >> 32;
+    return h;
+}
+
+// wyhash (Wang Yi), версия final4 с секретом по умолчанию
+constexpr uint64_t WY_SECRET[4] = {
+    0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL
+};
+
+inline void wymum(uint64_t& a, uint64_t& b) {
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    a = static_cast<uint64_t>(r);
+    b = static_cast<uint64_t>(r >> 64);
+}
+
+inline uint64_t wymix(uint64_t a, uint64_t b) {
+    wymum(a, b);
+    return a ^ b;
+}
+
+inline uint64_t wyhash(const void* data, size_t length, uint64_t seed) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    seed ^= wymix(seed ^ WY_SECRET[0], WY_SECRET[1]);
+    uint64_t a, b;
+    if (length <= 16) {
+        if (length >= 4) {
+            a = (static_cast<uint64_t>(read32(p)) << 32) | read32(p + ((length >> 3) << 2));
+            b = (static_cast<uint64_t>(read32(p + length - 4)) << 32) |
+                read32(p + length - 4 - ((length >> 3) << 2));
+        } else if (length > 0) {
+            a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[length >> 1]) << 8) |
+                p[length - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = length;
+        if (i >= 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = wymix(read64(p) ^ WY_SECRET[1], read64(p + 8) ^ seed);
+                see1 = wymix(read64(p + 16) ^ WY_SECRET[2], read64(p + 24) ^ see1);
+                see2 = wymix(read64(p + 32) ^ WY_SECRET[3], read64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i >= 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = wymix(read64(p) ^ WY_SECRET[1], read64(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = read64(p + i - 16);
+        b = read64(p + i - 8);
+    }
+    a ^= WY_SECRET[1];
+    b ^= seed;
+    wymum(a, b);
+    return wymix(a ^ WY_SECRET[0] ^ length, b ^ WY_SECRET[1]);
+}
+
+// CRC32C (полином Кастаньоли 0x82F63B78): таблица для процессоров без SSE4.2
+constexpr std::array<uint32_t, 256> makeCrc32cTable() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int k = 0; k < 8; ++k) {
+            crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+inline constexpr std::array<uint32_t, 256> CRC32C_TABLE = makeCrc32cTable();
+
+// Шаг CRC32C по 8 байтам (как _mm_crc32_u64) без SSE4.2
+inline uint32_t crc32cSoft(uint32_t crc, uint64_t word) {
+    for (int k = 0; k < 8; ++k) {
+        crc = CRC32C_TABLE[(crc ^ static_cast<uint8_t>(word)) & 0xFF] ^ (crc >> 8);
+        word >>= 8;
+    }
+    return crc;
+}
+
+// CRC-хеш: две независимые цепочки инструкции crc32 по 8-байтовым словам;
+// вторая получает слово, умноженное на нечетную константу, - CRC линеен
+// над GF(2), а умножение нет, так что цепочки дают 64 бита вместо
+// 32 одинаковых. Хвост дополняется нулями, длина входит в финализатор
+// fmix64, который отвечает за лавинный эффект
+constexpr uint64_t CRC_MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+
+// Последние n < 8 байт ключа длины length как слово, дополненное нулями.
+// Чтение перекрывающимися словами вместо memcpy переменной длины, который
+// компилируется в вызов и записи в стек с неудачной передачей в загрузку
+inline uint64_t readTail(const uint8_t* p, size_t n, size_t length) {
+    if (length >= 8) {
+        return read64(p + n - 8) >> (64 - 8 * n);
+    }
+    if (n >= 4) {
+        return read32(p) | (static_cast<uint64_t>(read32(p + n - 4)) << (8 * (n - 4)));
+    }
+    return p[0] | (static_cast<uint64_t>(p[n >> 1]) << (8 * (n >> 1))) |
+           (static_cast<uint64_t>(p[n - 1]) << (8 * (n - 1)));
+}
+
+inline uint64_t crcFinish(uint32_t lo, uint32_t hi, size_t length) {
+    return fmix64(((static_cast<uint64_t>(hi) << 32) | lo) ^ (length * CRC_MULTIPLIER));
+}
+
+__attribute__((target("sse4.2")))
+inline uint64_t crcHashSse42(const void* data, size_t length, uint64_t seed) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    uint64_t lo = static_cast<uint32_t>(seed);
+    uint64_t hi = static_cast<uint32_t>(~seed);
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word = read64(p + i);
+        lo = _mm_crc32_u64(lo, word);
+        hi = _mm_crc32_u64(hi, word * CRC_MULTIPLIER);
+    }
+    if (i < length) {
+        uint64_t word = readTail(p + i, length - i, length);
+        lo = _mm_crc32_u64(lo, word);
+        hi = _mm_crc32_u64(hi, word * CRC_MULTIPLIER);
+    }
+    return crcFinish(static_cast<uint32_t>(lo), static_cast<uint32_t>(hi), length);
+}
+
+inline uint64_t crcHashPortable(const void* data, size_t length, uint64_t seed) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    uint32_t lo = static_cast<uint32_t>(seed);
+    uint32_t hi = static_cast<uint32_t>(~seed);
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word = read64(p + i);
+        lo = crc32cSoft(lo, word);
+        hi = crc32cSoft(hi, word * CRC_MULTIPLIER);
+    }
+    if (i < length) {
+        uint64_t word = readTail(p + i, length - i, length);
+        lo = crc32cSoft(lo, word);
+        hi = crc32cSoft(hi, word * CRC_MULTIPLIER);
+    }
+    return crcFinish(lo, hi, length);
+}
+
+inline uint64_t crc64(const void* data, size_t length, uint64_t seed) {
+    static const bool has_sse42 = __builtin_cpu_supports("sse4.2");
+    return has_sse42 ? crcHashSse42(data, length, seed) : crcHashPortable(data, length, seed);
+}
+
+} // namespace hashpolicy
+
+template <>
+struct HashPolicy<HashKind::Murmur3_32> {
+    using Result = uint32_t;
+    static constexpr const char* NAME = "murmur3_32";
+    static Result hash(const void* data, size_t length, uint32_t seed) {
+        return HashFuncGen(seed).hash(data, length);
+    }
+    static Result hash(uint64_t key, uint32_t seed) { return HashFuncGen(seed).hash(key); }
+};
+
+template <>
+struct HashPolicy<HashKind::Murmur3_128> {
+    using Result = uint64_t;
+    static constexpr const char* NAME = "murmur3_128";
+    static Result hash(const void* data, size_t length, uint32_t seed) {
+        return HashFuncGen(seed).hash64(data, length);
+    }
+    static Result hash(uint64_t key, uint32_t seed) { return HashFuncGen(seed).hash64(key); }
+};
+
+template <>
+struct HashPolicy<HashKind::XXH64> {
+    using Result = uint64_t;
+    static constexpr const char* NAME = "xxh64";
+    static Result hash(const void* data, size_t length, uint32_t seed) {
+        return hashpolicy::xxh64(data, length, seed);
+    }
+    static Result hash(uint64_t key, uint32_t seed) { return hash(&key, sizeof(key), seed); }
+};
+
+template <>
+struct HashPolicy<HashKind::WyHash> {
+    using Result = uint64_t;
+    static constexpr const char* NAME = "wyhash";
+    static Result hash(const void* data, size_t length, uint32_t seed) {
+        return hashpolicy::wyhash(data, length, seed);
+    }
+    static Result hash(uint64_t key, uint32_t seed) { return hash(&key, sizeof(key), seed); }
+};
+
+template <>
+struct HashPolicy<HashKind::Crc32c> {
+    using Result = uint64_t;
+    static constexpr const char* NAME = "crc32c";
+    static Result hash(const void* data, size_t length, uint32_t seed) {
+        return hashpolicy::crc64(data, length, seed);
+    }
+    static Result hash(uint64_t key, uint32_t seed) { return hash(&key, sizeof(key), seed); }
+};
+
+#endif // HASHPOLICIES_H
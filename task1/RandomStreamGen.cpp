@@ -1,5 +1,55 @@
 #include "RandomStreamGen.h"
 #include <iostream>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// splitmix64: биективное перемешивание 64-битного счетчика
+inline uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Случайное число из [0, range) по 32 случайным битам (умножение со сдвигом)
+inline uint32_t scaleTo(uint32_t bits, uint32_t range) {
+    return static_cast<uint32_t>((static_cast<uint64_t>(bits) * range) >> 32);
+}
+
+// Ключ элемента: k-е случайное 64-битное число элемента равно
+// splitmix64(key + k * GAMMA)
+constexpr uint64_t GAMMA = 0x9E3779B97F4A7C15ULL;
+
+inline uint64_t elementKey(uint64_t seed, uint64_t index) {
+    return splitmix64(splitmix64(seed) ^ index);
+}
+
+// Длина строки из [min_length, max_length]
+inline uint32_t elementLength(uint64_t key, uint32_t min_length, uint32_t max_length) {
+    return min_length + scaleTo(static_cast<uint32_t>(splitmix64(key)),
+                                max_length - min_length + 1);
+}
+
+// Вызов fn(begin, end) для threads непрерывных диапазонов [0, count)
+template <typename Fn>
+void parallelRanges(size_t count, unsigned threads, Fn fn) {
+    threads = std::max(1U, threads);
+    std::vector<std::thread> workers;
+    const size_t chunk = (count + threads - 1) / threads;
+    for (unsigned t = 1; t < threads; ++t) {
+        size_t begin = std::min(count, t * chunk);
+        size_t end = std::min(count, begin + chunk);
+        workers.emplace_back(fn, begin, end);
+    }
+    fn(size_t(0), std::min(count, chunk));
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+} // namespace
 
 constexpr char RandomStreamGen::CHARSET[];
 
@@ -7,7 +57,8 @@ RandomStreamGen::RandomStreamGen(size_t n_elements, unsigned int seed)
     : rng(seed),
       length_dist(1, 30),  // Длина строки от 1 до 30
       char_dist(0, CHARSET_SIZE - 1),
-      total_elements(n_elements) {
+      total_elements(n_elements),
+      seed(seed) {
 }
 
 std::string RandomStreamGen::generateRandomString() {
@@ -36,21 +87,99 @@ void RandomStreamGen::generateStream() {
     }
 }
 
+ArenaStream RandomStreamGen::generateArena(unsigned threads) const {
+    const uint32_t min_length = static_cast<uint32_t>(length_dist.a());
+    const uint32_t max_length = static_cast<uint32_t>(length_dist.b());
+    
+    ArenaStream arena;
+    arena.offsets.resize(total_elements + 1);
+    
+    // 1. Длины строк; в offsets[i + 1] временно записывается длина строки i
+    parallelRanges(total_elements, threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            arena.offsets[i + 1] = elementLength(elementKey(seed, i), min_length, max_length);
+        }
+    });
+    
+    // 2. Префиксные суммы длин дают смещения
+    arena.offsets[0] = 0;
+    for (size_t i = 1; i <= total_elements; ++i) {
+        arena.offsets[i] += arena.offsets[i - 1];
+    }
+    arena.chars.resize(arena.offsets[total_elements]);
+    
+    // 3. Символы: по два символа из каждого 64-битного числа
+    parallelRanges(total_elements, threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const uint64_t key = elementKey(seed, i);
+            char* out = arena.chars.data() + arena.offsets[i];
+            const size_t length = arena.offsets[i + 1] - arena.offsets[i];
+            for (size_t k = 0; k < length; k += 2) {
+                uint64_t bits = splitmix64(key + (k / 2 + 1) * GAMMA);
+                out[k] = CHARSET[scaleTo(static_cast<uint32_t>(bits), CHARSET_SIZE)];
+                if (k + 1 < length) {
+                    out[k + 1] = CHARSET[scaleTo(static_cast<uint32_t>(bits >> 32), CHARSET_SIZE)];
+                }
+            }
+        }
+    });
+    
+    return arena;
+}
+
+std::vector<std::string_view> ArenaStream::views() const {
+    std::vector<std::string_view> result;
+    result.reserve(size());
+    for (size_t i = 0; i < size(); ++i) {
+        result.push_back((*this)[i]);
+    }
+    return result;
+}
+
 std::vector<std::string> RandomStreamGen::getStreamPart(double percentage) const {
+    return getStreamView(percentage).toVector();
+}
+
+std::vector<std::string> RandomStreamGen::getStreamPartByIndex(size_t end_index) const {
+    return getStreamViewByIndex(end_index).toVector();
+}
+
+StreamView RandomStreamGen::getStreamView(double percentage) const {
     if (percentage < 0 || percentage > 100) {
         throw std::invalid_argument("Percentage must be between 0 and 100");
     }
     
     size_t end_index = static_cast<size_t>((percentage / 100.0) * stream.size());
-    return std::vector<std::string>(stream.begin(), stream.begin() + end_index);
+    return StreamView(stream.data(), end_index);
 }
 
-std::vector<std::string> RandomStreamGen::getStreamPartByIndex(size_t end_index) const {
+StreamView RandomStreamGen::getStreamViewByIndex(size_t end_index) const {
     if (end_index > stream.size()) {
         end_index = stream.size();
     }
     
-    return std::vector<std::string>(stream.begin(), stream.begin() + end_index);
+    return StreamView(stream.data(), end_index);
+}
+
+StreamView StreamView::subview(size_t offset, size_t length) const {
+    if (offset > count) {
+        offset = count;
+    }
+    if (length > count - offset) {
+        length = count - offset;
+    }
+    return StreamView(first + offset, length);
+}
+
+StreamChunks StreamView::chunks(size_t chunk_size) const {
+    return StreamChunks(*this, chunk_size);
+}
+
+StreamChunks::StreamChunks(StreamView whole, size_t chunk_size)
+    : whole(whole), chunk_size(chunk_size) {
+    if (chunk_size == 0) {
+        throw std::invalid_argument("Chunk size must be positive");
+    }
 }
 
 const std::vector<std::string>& RandomStreamGen::getFullStream() const {
@@ -2,8 +2,97 @@
 #define RANDOMSTREAMGEN_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <random>
+#include <thread>
+#include <cstdint>
+
+// Поток строк в одной непрерывной области символов: строка i занимает
+// chars[offsets[i], offsets[i + 1])
+struct ArenaStream {
+    std::vector<char> chars;
+    std::vector<uint64_t> offsets;  // size() + 1 элементов
+    
+    size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    
+    std::string_view operator[](size_t i) const {
+        return std::string_view(chars.data() + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+    
+    // Представления всех строк (для пакетных интерфейсов)
+    std::vector<std::string_view> views() const;
+};
+
+class StreamChunks;
+
+// Невладеющее представление непрерывного диапазона строк потока
+// (std::span<const std::string> в C++17 нет). Действительно, пока поток
+// не перегенерирован и не очищен
+class StreamView {
+private:
+    const std::string* first;
+    size_t count;
+    
+public:
+    using iterator = const std::string*;
+    
+    StreamView() : first(nullptr), count(0) {}
+    StreamView(const std::string* data, size_t count) : first(data), count(count) {}
+    
+    iterator begin() const { return first; }
+    iterator end() const { return first + count; }
+    const std::string* data() const { return first; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const std::string& operator[](size_t i) const { return first[i]; }
+    
+    // Поддиапазон [offset, offset + length), обрезается по концу представления
+    StreamView subview(size_t offset, size_t length) const;
+    
+    // Разбиение на последовательные пакеты по chunk_size строк (последний
+    // может быть короче)
+    StreamChunks chunks(size_t chunk_size) const;
+    
+    // Копия строк (для кода, которому нужен владеющий вектор)
+    std::vector<std::string> toVector() const { return std::vector<std::string>(begin(), end()); }
+};
+
+// Диапазон пакетов StreamView фиксированного размера:
+//   for (StreamView batch : streamGen.getStreamView(100).chunks(4096)) ...
+class StreamChunks {
+private:
+    StreamView whole;
+    size_t chunk_size;
+    
+public:
+    class iterator {
+    private:
+        StreamView whole;
+        size_t chunk_size;
+        size_t offset;
+        
+    public:
+        iterator(StreamView whole, size_t chunk_size, size_t offset)
+            : whole(whole), chunk_size(chunk_size), offset(offset) {}
+        
+        StreamView operator*() const { return whole.subview(offset, chunk_size); }
+        iterator& operator++() {
+            offset = offset + chunk_size < whole.size() ? offset + chunk_size : whole.size();
+            return *this;
+        }
+        bool operator==(const iterator& other) const { return offset == other.offset; }
+        bool operator!=(const iterator& other) const { return offset != other.offset; }
+    };
+    
+    StreamChunks(StreamView whole, size_t chunk_size);
+    
+    iterator begin() const { return iterator(whole, chunk_size, 0); }
+    iterator end() const { return iterator(whole, chunk_size, whole.size()); }
+    
+    // Количество пакетов
+    size_t size() const { return (whole.size() + chunk_size - 1) / chunk_size; }
+};
 
 class RandomStreamGen {
 private:
@@ -20,6 +109,7 @@ private:
     
     size_t total_elements;
     std::vector<std::string> stream;
+    unsigned int seed;
     
 public:
     // Конструктор
@@ -31,12 +121,23 @@ public:
     // Генерация всего потока
     void generateStream();
     
+    // Генерация потока в арену генератором на счетчике (splitmix64):
+    // строка i зависит только от seed и i, поэтому диапазоны индексов
+    // генерируются параллельно, а результат не зависит от числа потоков.
+    // Длины и символы распределены так же, как в generateStream(), но
+    // сами строки другие. Внутренний поток (getFullStream) не меняется
+    ArenaStream generateArena(unsigned threads = std::thread::hardware_concurrency()) const;
+    
     // Получение части потока (процент от 0 до 100)
     std::vector<std::string> getStreamPart(double percentage) const;
     
     // Получение части потока по индексу
     std::vector<std::string> getStreamPartByIndex(size_t end_index) const;
     
+    // То же без копирования: представление префикса хранимого потока
+    StreamView getStreamView(double percentage) const;
+    StreamView getStreamViewByIndex(size_t end_index) const;
+    
     // Получение всего потока
     const std::vector<std::string>& getFullStream() const;
     
@@ -48,10 +48,19 @@ int main() {
     
     std::vector<double> percentages = {10, 25, 50, 75, 100};
     for (double pct : percentages) {
-        auto part = streamGen.getStreamPart(pct);
+        StreamView part = streamGen.getStreamView(pct);
         std::cout << pct << "% потока: " << part.size() << " элементов" << std::endl;
     }
     
+    // Обход потока пакетами без копирования
+    size_t chunked_total = 0;
+    StreamChunks batches = streamGen.getStreamView(100).chunks(4096);
+    for (StreamView batch : batches) {
+        chunked_total += batch.size();
+    }
+    std::cout << "Пакетов по 4096: " << batches.size()
+              << ", элементов в пакетах: " << chunked_total << std::endl;
+    
     // 3. Тестирование HashFuncGen
     std::cout << "\n--- Тест 3: Хеш-функция ---" << std::endl;
     
@@ -100,13 +109,28 @@ int main() {
     std::cout << std::string(45, '-') << std::endl;
     
     for (int step : steps) {
-        auto part = streamGen.getStreamPart(step);
+        StreamView part = streamGen.getStreamView(step);
         std::unordered_set<std::string> unique_strings(part.begin(), part.end());
         std::cout << std::setw(9) << step << "%" 
                   << std::setw(15) << part.size()
                   << std::setw(20) << unique_strings.size() << std::endl;
     }
     
+    // 6. Параллельная генерация в арену
+    std::cout << "\n--- Тест 7: Генерация в арену на счетчике ---" << std::endl;
+    ArenaStream arena_one = streamGen.generateArena(1);
+    ArenaStream arena_many = streamGen.generateArena(4);
+    bool same = arena_one.chars == arena_many.chars && arena_one.offsets == arena_many.offsets;
+    std::cout << "Строк: " << arena_many.size() << ", символов: " << arena_many.chars.size()
+              << " (в среднем " << std::fixed << std::setprecision(2)
+              << static_cast<double>(arena_many.chars.size()) / arena_many.size() << ")" << std::endl;
+    std::cout << "Результат для 1 и 4 потоков совпадает: " << (same ? "да" : "НЕТ") << std::endl;
+    std::cout << "Первые строки:";
+    for (int i = 0; i < 3; ++i) {
+        std::cout << " \"" << arena_many[i] << "\"";
+    }
+    std::cout << std::endl;
+    
     std::cout << "\n=== Все тесты этапа 1 пройдены успешно! ===" << std::endl;
     
     return 0;
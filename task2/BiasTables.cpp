@@ -0,0 +1,505 @@
+// Сгенерировано gen_bias_tables, не редактировать вручную.
+// Средняя сырая оценка и ее смещение для n = 5m * i / 100, i = 1..100
+#include "BiasTables.h"
+
+namespace {
+
+const double RAW_B4[] = {
+    10.77, 11.24, 11.72, 12.22, 12.74, 13.27, 13.82, 14.38,
+    14.96, 15.56, 16.17, 16.79, 17.43, 18.09, 18.76, 19.45,
+    20.15, 20.87, 21.60, 22.35, 23.11, 23.88, 24.67, 25.47,
+    26.27, 27.09, 27.93, 28.77, 29.62, 30.49, 31.36, 32.24,
+    33.14, 34.04, 34.95, 35.86, 36.78, 37.71, 38.64, 39.58,
+    40.52, 41.46, 42.41, 43.37, 44.33, 45.30, 46.26, 47.23,
+    48.21, 49.18, 50.16, 51.14, 52.12, 53.11, 54.10, 55.08,
+    56.07, 57.06, 58.06, 59.04, 60.04, 61.04, 62.03, 63.03,
+    64.03, 65.03, 66.02, 67.02, 68.01, 69.01, 70.01, 71.01,
+    72.01, 73.01, 74.01, 75.01, 76.01, 77.00, 78.00, 78.99,
+    80.00
+};
+
+const double BIAS_B4[] = {
+    10.768, 10.238, 9.723, 9.223, 8.739, 8.271, 7.818, 7.381,
+    6.960, 6.556, 6.166, 5.793, 5.434, 5.091, 4.764, 4.452,
+    4.153, 3.872, 3.604, 3.350, 3.109, 2.882, 2.668, 2.466,
+    2.275, 2.094, 1.926, 1.770, 1.624, 1.486, 1.362, 1.243,
+    1.137, 1.037, 0.946, 0.858, 0.777, 0.706, 0.642, 0.577,
+    0.517, 0.459, 0.412, 0.369, 0.333, 0.296, 0.261, 0.234,
+    0.208, 0.183, 0.161, 0.138, 0.120, 0.107, 0.095, 0.083,
+    0.070, 0.063, 0.056, 0.043, 0.038, 0.041, 0.033, 0.028,
+    0.026, 0.026, 0.023, 0.016, 0.011, 0.011, 0.008, 0.010,
+    0.006, 0.009, 0.009, 0.009, 0.005, 0.001, -0.003, -0.007,
+    -0.003
+};
+
+const double RAW_B5[] = {
+    22.78, 23.75, 24.25, 25.27, 26.31, 26.85, 27.94, 28.50,
+    29.64, 30.80, 31.40, 32.61, 33.23, 34.49, 35.77, 36.42,
+    37.75, 38.43, 39.80, 41.20, 41.91, 43.35, 44.09, 45.56,
+    47.07, 47.83, 49.37, 50.16, 51.74, 53.34, 54.15, 55.78,
+    56.61, 58.28, 59.96, 60.81, 62.53, 63.39, 65.13, 66.88,
+    67.77, 69.55, 70.45, 72.26, 74.08, 74.99, 76.83, 77.75,
+    79.60, 81.46, 82.39, 84.27, 85.22, 87.11, 89.02, 89.97,
+    91.88, 92.85, 94.77, 96.69, 97.65, 99.60, 100.57, 102.51,
+    104.46, 105.44, 107.40, 108.37, 110.33, 112.30, 113.28, 115.25,
+    116.24, 118.21, 120.19, 121.18, 123.16, 124.16, 126.13, 128.12,
+    129.12, 131.11, 132.11, 134.09, 136.08, 137.08, 139.08, 140.07,
+    142.06, 144.05, 145.05, 147.04, 148.05, 150.04, 152.03, 153.03,
+    155.01, 156.02, 158.01, 160.01
+};
+
+const double BIAS_B5[] = {
+    21.779, 20.752, 20.249, 19.266, 18.313, 17.847, 16.940, 16.499,
+    15.636, 14.804, 14.400, 13.615, 13.232, 12.488, 11.771, 11.425,
+    10.752, 10.427, 9.801, 9.202, 8.910, 8.354, 8.085, 7.563,
+    7.067, 6.830, 6.374, 6.156, 5.735, 5.338, 5.150, 4.783,
+    4.610, 4.279, 3.963, 3.814, 3.529, 3.393, 3.128, 2.884,
+    2.770, 2.552, 2.450, 2.255, 2.076, 1.988, 1.825, 1.746,
+    1.599, 1.462, 1.394, 1.274, 1.219, 1.107, 1.015, 0.966,
+    0.883, 0.845, 0.770, 0.693, 0.653, 0.600, 0.573, 0.512,
+    0.463, 0.439, 0.395, 0.373, 0.331, 0.297, 0.276, 0.251,
+    0.236, 0.209, 0.191, 0.175, 0.161, 0.159, 0.135, 0.120,
+    0.123, 0.110, 0.110, 0.086, 0.082, 0.082, 0.077, 0.071,
+    0.063, 0.055, 0.055, 0.040, 0.046, 0.044, 0.031, 0.029,
+    0.008, 0.017, 0.009, 0.006
+};
+
+const double RAW_B6[] = {
+    46.82, 48.30, 49.81, 51.35, 53.46, 55.08, 56.74, 58.42,
+    60.15, 62.49, 64.29, 66.12, 67.97, 69.87, 72.45, 74.42,
+    76.42, 78.45, 80.51, 83.31, 85.43, 87.60, 89.79, 92.01,
+    95.01, 97.29, 99.59, 101.93, 104.28, 107.47, 109.88, 112.33,
+    114.80, 117.28, 120.64, 123.18, 125.73, 128.31, 130.91, 134.40,
+    137.04, 139.69, 142.36, 145.05, 148.65, 151.38, 154.12, 156.88,
+    159.64, 163.34, 166.13, 168.93, 171.73, 174.56, 178.33, 181.17,
+    184.02, 186.89, 189.76, 193.60, 196.50, 199.39, 202.28, 205.20,
+    209.09, 212.01, 214.93, 217.87, 220.79, 224.70, 227.64, 230.60,
+    233.54, 236.49, 240.42, 243.37, 246.32, 249.32, 252.28, 256.23,
+    259.20, 262.18, 265.13, 268.13, 272.10, 275.08, 278.04, 281.04,
+    284.02, 288.00, 290.98, 293.97, 296.96, 299.95, 303.95, 306.95,
+    309.95, 312.95, 315.95, 319.94
+};
+
+const double BIAS_B6[] = {
+    43.821, 42.299, 40.809, 39.354, 37.464, 36.084, 34.736, 33.423,
+    32.146, 30.491, 29.286, 28.115, 26.974, 25.870, 24.446, 23.418,
+    22.417, 21.449, 20.511, 19.306, 18.434, 17.596, 16.787, 16.006,
+    15.011, 14.292, 13.592, 12.928, 12.285, 11.472, 10.882, 10.327,
+    9.797, 9.281, 8.640, 8.177, 7.726, 7.308, 6.911, 6.399,
+    6.040, 5.686, 5.359, 5.053, 4.653, 4.380, 4.123, 3.878,
+    3.636, 3.336, 3.127, 2.925, 2.734, 2.555, 2.332, 2.174,
+    2.023, 1.891, 1.763, 1.604, 1.505, 1.387, 1.281, 1.198,
+    1.090, 1.008, 0.927, 0.869, 0.794, 0.703, 0.643, 0.596,
+    0.537, 0.489, 0.417, 0.370, 0.324, 0.324, 0.283, 0.230,
+    0.200, 0.176, 0.135, 0.129, 0.099, 0.076, 0.042, 0.040,
+    0.023, 0.004, -0.022, -0.035, -0.044, -0.046, -0.049, -0.051,
+    -0.053, -0.054, -0.046, -0.055
+};
+
+const double RAW_B7[] = {
+    94.46, 97.43, 100.98, 104.09, 107.81, 111.06, 114.38, 118.33,
+    121.79, 125.91, 129.51, 133.18, 137.53, 141.33, 145.86, 149.80,
+    153.80, 158.55, 162.69, 167.60, 171.87, 176.19, 181.30, 185.75,
+    190.99, 195.54, 200.15, 205.60, 210.30, 215.88, 220.71, 225.58,
+    231.31, 236.28, 242.15, 247.21, 252.32, 258.32, 263.51, 269.60,
+    274.88, 280.19, 286.38, 291.74, 298.03, 303.43, 308.90, 315.31,
+    320.83, 327.33, 332.89, 338.48, 345.04, 350.67, 357.25, 362.94,
+    368.61, 375.28, 381.01, 387.71, 393.48, 399.29, 406.03, 411.87,
+    418.63, 424.46, 430.29, 437.14, 442.96, 449.81, 455.68, 461.54,
+    468.40, 474.30, 481.19, 487.08, 493.01, 499.94, 505.90, 512.82,
+    518.77, 524.71, 531.66, 537.57, 544.50, 550.48, 556.42, 563.39,
+    569.36, 576.34, 582.34, 588.30, 595.27, 601.24, 608.25, 614.26,
+    620.26, 627.29, 633.26, 640.21
+};
+
+const double BIAS_B7[] = {
+    88.460, 85.431, 81.976, 79.090, 75.806, 73.058, 70.378, 67.331,
+    64.790, 61.909, 59.514, 57.177, 54.526, 52.334, 49.860, 47.803,
+    45.805, 43.551, 41.692, 39.599, 37.875, 36.191, 34.304, 32.751,
+    30.988, 29.539, 28.150, 26.595, 25.304, 23.881, 22.711, 21.578,
+    20.315, 19.283, 18.151, 17.209, 16.320, 15.321, 14.510, 13.601,
+    12.875, 12.186, 11.383, 10.738, 10.027, 9.434, 8.902, 8.310,
+    7.833, 7.333, 6.891, 6.481, 6.038, 5.674, 5.255, 4.941,
+    4.613, 4.277, 4.008, 3.708, 3.483, 3.286, 3.025, 2.866,
+    2.626, 2.464, 2.289, 2.138, 1.962, 1.808, 1.676, 1.543,
+    1.396, 1.295, 1.188, 1.082, 1.011, 0.944, 0.896, 0.816,
+    0.769, 0.710, 0.660, 0.570, 0.503, 0.479, 0.425, 0.391,
+    0.358, 0.336, 0.335, 0.302, 0.270, 0.244, 0.251, 0.259,
+    0.265, 0.285, 0.257, 0.208
+};
+
+const double RAW_B8[] = {
+    189.70, 196.16, 202.76, 209.53, 216.44, 222.96, 230.17, 237.53,
+    245.05, 252.70, 259.92, 267.87, 275.96, 284.22, 292.63, 300.51,
+    309.18, 317.99, 326.94, 336.05, 344.56, 353.89, 363.38, 372.98,
+    382.72, 391.82, 401.81, 411.88, 422.12, 432.44, 442.10, 452.67,
+    463.30, 474.08, 484.95, 495.05, 506.09, 517.23, 528.47, 539.76,
+    550.30, 561.73, 573.27, 584.87, 596.52, 607.34, 619.19, 631.05,
+    642.95, 654.94, 666.08, 678.15, 690.35, 702.55, 714.79, 726.14,
+    738.49, 750.85, 763.21, 775.60, 787.14, 799.59, 812.14, 824.72,
+    837.29, 848.96, 861.56, 874.28, 886.97, 899.65, 911.34, 924.07,
+    936.79, 949.57, 962.33, 974.21, 987.02, 999.90, 1012.79, 1025.65,
+    1037.52, 1050.41, 1063.35, 1076.25, 1089.14, 1101.07, 1113.99, 1126.92,
+    1139.87, 1152.77, 1164.65, 1177.62, 1190.55, 1203.46, 1216.50, 1228.43,
+    1241.41, 1254.38, 1267.33, 1280.31
+};
+
+const double BIAS_B8[] = {
+    177.697, 171.156, 164.761, 158.528, 152.444, 146.962, 141.174, 135.534,
+    130.047, 124.703, 119.918, 114.867, 109.960, 105.217, 100.634, 96.506,
+    92.180, 87.985, 83.941, 80.047, 76.562, 72.892, 69.376, 65.976,
+    62.724, 59.823, 56.807, 53.883, 51.121, 48.444, 46.101, 43.667,
+    41.301, 39.078, 36.954, 35.052, 33.089, 31.232, 29.474, 27.763,
+    26.302, 24.729, 23.272, 21.866, 20.517, 19.342, 18.187, 17.050,
+    15.951, 14.944, 14.078, 13.155, 12.349, 11.550, 10.786, 10.140,
+    9.493, 8.846, 8.207, 7.602, 7.136, 6.590, 6.142, 5.721,
+    5.289, 4.963, 4.556, 4.281, 3.968, 3.653, 3.341, 3.071,
+    2.789, 2.570, 2.333, 2.207, 2.022, 1.902, 1.786, 1.647,
+    1.515, 1.414, 1.355, 1.251, 1.144, 1.065, 0.990, 0.925,
+    0.867, 0.774, 0.649, 0.624, 0.548, 0.462, 0.496, 0.432,
+    0.406, 0.376, 0.331, 0.306
+};
+
+const double RAW_B9[] = {
+    380.68, 393.61, 406.33, 419.87, 433.70, 447.31, 461.75, 475.91,
+    490.92, 506.25, 521.28, 537.21, 552.80, 569.32, 586.08, 602.50,
+    619.83, 636.81, 654.77, 672.99, 690.74, 709.49, 727.76, 746.98,
+    766.42, 785.40, 805.40, 824.87, 845.25, 865.91, 886.03, 907.13,
+    927.61, 949.14, 970.79, 991.76, 1013.90, 1035.31, 1057.75, 1080.36,
+    1102.17, 1125.12, 1147.29, 1170.58, 1193.95, 1216.45, 1240.06, 1262.85,
+    1286.68, 1310.60, 1333.67, 1357.89, 1381.26, 1405.65, 1430.07, 1453.68,
+    1478.30, 1502.02, 1526.83, 1551.65, 1575.61, 1600.59, 1624.66, 1649.83,
+    1674.94, 1699.26, 1724.65, 1749.15, 1774.53, 1799.85, 1824.31, 1849.84,
+    1874.42, 1900.03, 1925.64, 1950.32, 1975.90, 2000.52, 2026.22, 2051.95,
+    2076.65, 2102.42, 2127.01, 2152.83, 2178.75, 2203.63, 2229.44, 2254.33,
+    2280.20, 2306.02, 2330.89, 2356.63, 2381.42, 2407.33, 2433.26, 2458.26,
+    2484.09, 2508.82, 2534.79, 2560.69
+};
+
+const double BIAS_B9[] = {
+    355.677, 342.611, 330.333, 317.875, 305.699, 294.309, 282.746, 271.912,
+    260.918, 250.251, 240.283, 230.208, 220.798, 211.315, 202.085, 193.497,
+    184.832, 176.814, 168.766, 160.988, 153.737, 146.487, 139.757, 132.979,
+    126.424, 120.396, 114.396, 108.866, 103.249, 97.906, 93.030, 88.133,
+    83.609, 79.136, 74.792, 70.757, 66.897, 63.312, 59.748, 56.360,
+    53.173, 50.117, 47.288, 44.583, 41.946, 39.452, 37.056, 34.850,
+    32.678, 30.597, 28.671, 26.892, 25.263, 23.654, 22.071, 20.679,
+    19.303, 18.024, 16.834, 15.653, 14.609, 13.590, 12.663, 11.825,
+    10.941, 10.256, 9.648, 9.147, 8.529, 7.846, 7.315, 6.844,
+    6.418, 6.034, 5.643, 5.323, 4.903, 4.516, 4.218, 3.949,
+    3.652, 3.416, 3.010, 2.827, 2.747, 2.631, 2.444, 2.328,
+    2.201, 2.018, 1.890, 1.628, 1.423, 1.329, 1.260, 1.260,
+    1.088, 0.816, 0.788, 0.694
+};
+
+const double RAW_B10[] = {
+    762.64, 788.01, 813.99, 840.55, 868.22, 895.92, 924.26, 953.15,
+    982.69, 1013.38, 1044.03, 1075.24, 1107.04, 1139.45, 1173.03, 1206.54,
+    1240.54, 1275.20, 1310.34, 1346.66, 1382.78, 1419.53, 1456.72, 1494.47,
+    1533.31, 1571.97, 1611.25, 1650.93, 1691.07, 1732.39, 1773.45, 1814.73,
+    1856.45, 1898.67, 1942.13, 1985.02, 2028.29, 2071.98, 2115.93, 2160.85,
+    2205.42, 2250.49, 2295.79, 2341.31, 2387.85, 2433.76, 2479.96, 2526.49,
+    2573.24, 2621.27, 2668.58, 2715.88, 2763.36, 2811.07, 2860.00, 2908.33,
+    2956.81, 3005.39, 3054.00, 3103.56, 3152.38, 3201.39, 3250.58, 3299.78,
+    3349.86, 3399.20, 3448.78, 3498.51, 3548.30, 3599.26, 3649.10, 3699.16,
+    3749.17, 3799.30, 3850.38, 3900.54, 3950.99, 4001.24, 4051.67, 4102.98,
+    4153.62, 4203.98, 4254.49, 4305.17, 4356.79, 4407.51, 4458.08, 4509.07,
+    4559.61, 4610.98, 4661.59, 4712.42, 4763.23, 4814.15, 4865.76, 4916.68,
+    4967.70, 5018.40, 5069.02, 5120.98
+};
+
+const double BIAS_B10[] = {
+    711.638, 686.006, 660.989, 636.553, 612.224, 588.922, 566.261, 544.150,
+    522.693, 501.377, 481.027, 461.235, 442.043, 423.450, 405.026, 387.540,
+    370.537, 354.201, 338.342, 322.660, 307.781, 293.525, 279.723, 266.474,
+    253.308, 240.969, 229.249, 217.930, 207.068, 196.386, 186.454, 176.728,
+    167.449, 158.670, 150.127, 142.023, 134.294, 126.978, 119.932, 112.845,
+    106.421, 100.495, 94.795, 89.306, 83.851, 78.765, 73.963, 69.490,
+    65.240, 61.271, 57.580, 53.881, 50.358, 47.065, 43.996, 41.329,
+    38.810, 36.387, 33.998, 31.557, 29.377, 27.389, 25.585, 23.777,
+    21.865, 20.205, 18.784, 17.507, 16.303, 15.262, 14.100, 13.161,
+    12.169, 11.298, 10.377, 9.537, 8.995, 8.236, 7.667, 6.984,
+    6.621, 5.982, 5.489, 5.166, 4.792, 4.514, 4.084, 4.071,
+    3.608, 2.982, 2.589, 2.421, 2.229, 2.145, 1.757, 1.684,
+    1.697, 1.398, 1.023, 0.984
+};
+
+const double RAW_B11[] = {
+    1526.06, 1576.87, 1629.35, 1682.55, 1737.46, 1792.95, 1849.66, 1908.09,
+    1967.11, 2027.90, 2089.23, 2151.72, 2216.01, 2280.75, 2347.23, 2414.39,
+    2482.51, 2552.32, 2622.50, 2694.71, 2767.23, 2840.78, 2915.98, 2991.52,
+    3068.55, 3145.95, 3224.38, 3304.34, 3384.32, 3466.25, 3548.06, 3630.88,
+    3715.18, 3799.56, 3885.20, 3970.68, 4057.36, 4145.68, 4233.64, 4323.21,
+    4412.65, 4502.62, 4593.69, 4684.48, 4776.97, 4869.01, 4961.72, 5055.80,
+    5149.43, 5244.31, 5338.67, 5433.86, 5530.16, 5625.54, 5722.65, 5818.89,
+    5915.52, 6013.45, 6110.54, 6208.80, 6306.57, 6404.84, 6504.17, 6602.83,
+    6702.40, 6801.06, 6899.93, 7000.44, 7099.53, 7200.81, 7300.32, 7400.54,
+    7501.94, 7602.54, 7704.25, 7804.42, 7905.23, 8007.37, 8107.77, 8208.72,
+    8309.59, 8410.81, 8512.83, 8614.20, 8716.34, 8818.00, 8919.28, 9022.00,
+    9123.74, 9225.98, 9327.46, 9428.85, 9531.22, 9633.68, 9735.94, 9837.32,
+    9939.69, 10042.24, 10143.75, 10246.39
+};
+
+const double BIAS_B11[] = {
+    1424.058, 1372.866, 1322.352, 1273.554, 1225.458, 1178.954, 1133.663, 1089.091,
+    1046.114, 1003.896, 963.233, 923.723, 885.014, 847.752, 811.229, 776.392,
+    742.515, 709.316, 677.499, 646.713, 617.230, 588.779, 560.980, 534.524,
+    508.546, 483.949, 460.380, 437.335, 415.316, 394.248, 374.060, 354.884,
+    336.180, 318.559, 301.199, 284.681, 269.362, 254.677, 240.642, 227.209,
+    214.648, 202.621, 190.695, 179.478, 168.972, 159.007, 149.720, 140.795,
+    132.430, 124.313, 116.671, 109.860, 103.160, 96.538, 90.653, 84.891,
+    79.520, 74.449, 69.541, 64.799, 60.568, 56.841, 53.174, 49.829,
+    46.403, 43.062, 39.932, 37.444, 34.528, 32.814, 30.322, 28.539,
+    26.943, 25.543, 24.252, 22.417, 21.227, 20.373, 18.766, 16.725,
+    15.586, 14.806, 13.835, 13.195, 12.336, 11.999, 11.276, 10.995,
+    10.740, 9.977, 9.460, 8.853, 8.223, 8.680, 7.936, 7.319,
+    7.690, 7.235, 6.750, 6.394
+};
+
+const double RAW_B12[] = {
+    3052.83, 3154.92, 3259.43, 3366.24, 3475.36, 3586.42, 3700.47, 3816.82,
+    3935.16, 4056.07, 4178.75, 4304.33, 4432.16, 4562.39, 4694.88, 4828.88,
+    4965.71, 5104.94, 5246.31, 5389.35, 5534.01, 5681.38, 5830.82, 5982.17,
+    6135.50, 6290.19, 6447.31, 6606.19, 6766.78, 6929.51, 7093.32, 7259.66,
+    7427.47, 7597.23, 7767.96, 7939.56, 8113.34, 8287.88, 8464.34, 8642.41,
+    8820.60, 9001.12, 9182.73, 9365.53, 9549.45, 9733.49, 9920.18, 10107.29,
+    10296.01, 10484.92, 10673.61, 10863.97, 11054.86, 11247.38, 11439.73, 11632.24,
+    11825.94, 12020.33, 12215.59, 12411.05, 12606.48, 12803.01, 13001.17, 13199.40,
+    13397.75, 13594.89, 13793.81, 13994.26, 14194.36, 14394.12, 14593.33, 14794.42,
+    14994.76, 15195.58, 15396.18, 15595.93, 15798.33, 16000.00, 16202.22, 16404.23,
+    16606.46, 16809.40, 17012.20, 17213.94, 17416.32, 17619.09, 17822.62, 18025.59,
+    18230.03, 18432.88, 18636.41, 18840.79, 19044.09, 19249.16, 19452.63, 19655.93,
+    19857.93, 20061.92, 20267.52, 20471.31
+};
+
+const double BIAS_B12[] = {
+    2848.833, 2745.915, 2645.428, 2547.243, 2451.359, 2358.420, 2267.467, 2178.816,
+    2092.158, 2008.071, 1926.755, 1847.325, 1770.158, 1695.393, 1622.876, 1552.883,
+    1484.707, 1418.943, 1355.308, 1293.351, 1234.011, 1176.383, 1120.819, 1067.169,
+    1015.502, 966.192, 918.310, 872.187, 827.784, 785.513, 745.320, 706.661,
+    669.466, 634.234, 599.962, 567.561, 536.345, 505.885, 477.337, 450.415,
+    424.599, 400.117, 376.731, 354.533, 333.448, 313.488, 295.178, 277.295,
+    261.013, 244.922, 229.609, 214.975, 200.857, 188.385, 175.727, 164.242,
+    152.945, 142.334, 132.592, 123.047, 114.476, 106.012, 99.166, 92.397,
+    85.753, 78.891, 72.812, 68.264, 63.359, 58.116, 53.333, 49.419,
+    44.757, 40.582, 36.178, 31.930, 29.329, 25.995, 23.220, 20.232,
+    18.463, 16.404, 14.195, 10.939, 8.317, 7.094, 5.616, 3.595,
+    3.035, 0.878, 0.409, -0.215, -1.909, -1.843, -3.372, -4.067,
+    -7.075, -8.085, -7.479, -8.693
+};
+
+const double RAW_B13[] = {
+    6107.16, 6311.27, 6519.64, 6733.17, 6951.62, 7174.30, 7402.11, 7634.21,
+    7871.37, 8113.36, 8359.40, 8610.62, 8865.94, 9126.27, 9391.40, 9659.90,
+    9933.64, 10211.32, 10494.12, 10780.77, 11071.07, 11366.04, 11665.11, 11968.56,
+    12276.29, 12586.54, 12901.30, 13218.52, 13540.60, 13866.50, 14193.95, 14525.62,
+    14860.46, 15199.41, 15541.10, 15885.19, 16233.22, 16583.36, 16937.44, 17293.33,
+    17651.31, 18012.50, 18375.10, 18740.66, 19109.99, 19479.13, 19850.33, 20222.63,
+    20598.36, 20974.59, 21354.25, 21736.90, 22118.53, 22502.60, 22887.91, 23273.05,
+    23660.10, 24048.35, 24438.01, 24832.26, 25224.52, 25618.59, 26012.58, 26406.34,
+    26802.61, 27198.35, 27595.82, 27994.91, 28395.15, 28796.37, 29198.66, 29597.96,
+    30000.67, 30403.35, 30805.33, 31205.46, 31608.77, 32012.08, 32417.45, 32821.76,
+    33228.08, 33634.34, 34039.33, 34445.42, 34852.04, 35257.96, 35663.96, 36070.59,
+    36476.59, 36883.38, 37290.05, 37698.52, 38106.47, 38515.51, 38927.98, 39337.09,
+    39744.49, 40149.88, 40559.07, 40965.09
+};
+
+const double BIAS_B13[] = {
+    5698.158, 5492.271, 5291.635, 5095.171, 4903.619, 4717.304, 4535.112, 4358.211,
+    4185.367, 4017.365, 3854.400, 3695.620, 3541.935, 3392.269, 3247.401, 3106.898,
+    2970.642, 2839.324, 2712.123, 2588.771, 2470.068, 2355.042, 2245.112, 2138.558,
+    2036.290, 1937.543, 1842.304, 1750.520, 1662.603, 1578.496, 1496.954, 1418.622,
+    1344.460, 1273.413, 1205.102, 1140.192, 1078.215, 1019.356, 963.443, 909.327,
+    858.308, 809.500, 763.096, 718.658, 677.986, 638.133, 599.333, 562.633,
+    528.363, 494.591, 465.248, 437.901, 410.526, 384.604, 359.913, 336.051,
+    313.100, 292.346, 272.015, 256.256, 239.524, 223.590, 208.584, 192.336,
+    178.606, 165.355, 152.824, 142.911, 133.151, 124.370, 117.663, 106.963,
+    100.667, 93.349, 85.334, 76.455, 69.769, 64.084, 59.446, 53.757,
+    51.080, 47.341, 43.335, 39.425, 36.037, 32.958, 28.961, 26.586,
+    22.591, 19.380, 17.045, 15.522, 14.471, 13.511, 15.982, 16.089,
+    13.489, 9.881, 9.070, 5.087
+};
+
+const double RAW_B14[] = {
+    12215.48, 12623.42, 13040.65, 13467.68, 13904.56, 14349.97, 14805.02, 15270.03,
+    15743.93, 16227.61, 16720.34, 17221.99, 17733.03, 18251.88, 18781.97, 19320.41,
+    19868.00, 20423.78, 20987.82, 21561.86, 22143.09, 22731.69, 23329.41, 23935.34,
+    24548.80, 25169.89, 25798.01, 26433.59, 27076.76, 27728.53, 28386.82, 29050.18,
+    29719.51, 30397.84, 31081.32, 31767.93, 32463.59, 33164.94, 33871.30, 34581.58,
+    35297.44, 36017.16, 36743.35, 37471.54, 38208.15, 38947.34, 39689.57, 40438.98,
+    41189.77, 41945.54, 42703.19, 43462.88, 44227.68, 44993.46, 45766.38, 46539.05,
+    47315.55, 48095.61, 48875.04, 49656.05, 50443.42, 51230.22, 52020.88, 52812.78,
+    53605.48, 54397.40, 55193.93, 55988.63, 56788.86, 57590.16, 58394.65, 59195.35,
+    59999.23, 60806.78, 61614.48, 62417.75, 63225.88, 64033.85, 64844.75, 65656.47,
+    66468.39, 67281.48, 68096.43, 68909.06, 69724.81, 70537.47, 71349.30, 72165.45,
+    72979.38, 73796.26, 74612.01, 75426.81, 76245.14, 77063.45, 77879.97, 78693.37,
+    79509.42, 80327.80, 81140.30, 81961.90
+};
+
+const double BIAS_B14[] = {
+    11396.485, 10985.420, 10583.648, 10191.678, 9808.557, 9434.966, 9071.019, 8717.028,
+    8371.926, 8035.607, 7709.335, 7391.995, 7084.033, 6783.880, 6493.969, 6213.407,
+    5942.002, 5678.777, 5423.817, 5177.861, 4940.094, 4709.693, 4488.414, 4275.340,
+    4068.802, 3870.890, 3680.012, 3496.585, 3320.757, 3152.529, 2991.817, 2836.180,
+    2686.512, 2545.837, 2409.320, 2276.933, 2153.586, 2035.936, 1923.296, 1813.581,
+    1710.438, 1611.157, 1518.345, 1427.536, 1344.149, 1264.344, 1187.568, 1117.984,
+    1049.771, 985.535, 924.187, 864.880, 810.675, 757.458, 710.380, 664.049,
+    621.552, 582.609, 543.041, 504.053, 472.424, 440.217, 411.879, 384.776,
+    357.481, 330.400, 307.928, 283.633, 264.856, 246.162, 231.651, 213.354,
+    198.228, 186.776, 174.477, 158.754, 147.880, 136.850, 128.754, 120.467,
+    113.386, 107.483, 103.435, 97.056, 92.807, 86.470, 79.299, 76.454,
+    71.381, 68.263, 65.007, 60.814, 60.144, 59.449, 55.968, 50.370,
+    47.417, 46.805, 40.301, 41.899
+};
+
+const double RAW_B15[] = {
+    24431.68, 25247.59, 26082.73, 26935.82, 27810.42, 28702.24, 29612.34, 30542.72,
+    31490.16, 32457.38, 33442.40, 34446.56, 35468.91, 36507.09, 37566.68, 38644.90,
+    39739.21, 40850.03, 41980.01, 43125.45, 44287.41, 45463.94, 46659.68, 47869.93,
+    49099.01, 50343.56, 51604.48, 52879.15, 54169.40, 55470.61, 56790.33, 58115.84,
+    59458.02, 60807.41, 62176.45, 63554.39, 64942.95, 66339.93, 67751.33, 69177.40,
+    70605.77, 72048.21, 73500.73, 74962.19, 76433.65, 77914.31, 79404.15, 80897.18,
+    82402.07, 83910.93, 85426.98, 86950.23, 88479.54, 90015.89, 91557.00, 93101.17,
+    94653.23, 96208.99, 97764.73, 99329.00, 100899.11, 102467.20, 104048.80, 105626.86,
+    107215.43, 108800.76, 110392.65, 111990.23, 113590.72, 115191.73, 116792.06, 118398.64,
+    120008.58, 121617.51, 123227.14, 124839.80, 126450.36, 128066.01, 129684.78, 131303.97,
+    132926.32, 134542.93, 136169.30, 137791.14, 139417.80, 141047.41, 142674.93, 144310.35,
+    145938.80, 147566.59, 149197.84, 150828.13, 152453.42, 154084.36, 155713.93, 157345.51,
+    158981.57, 160606.71, 162235.98, 163873.98
+};
+
+const double BIAS_B15[] = {
+    22793.680, 21971.591, 21167.727, 20382.823, 19618.424, 18872.238, 18144.343, 17435.720,
+    16745.157, 16073.377, 15420.395, 14786.557, 14169.905, 13570.093, 12990.682, 12430.896,
+    11887.215, 11359.026, 10851.008, 10357.446, 9881.414, 9419.941, 8976.683, 8548.928,
+    8139.005, 7745.561, 7368.484, 7004.154, 6656.401, 6318.614, 6000.332, 5687.836,
+    5391.018, 5102.407, 4832.449, 4572.391, 4322.948, 4080.925, 3854.334, 3641.397,
+    3431.772, 3236.214, 3049.726, 2873.186, 2705.653, 2548.309, 2400.149, 2254.184,
+    2121.067, 1990.929, 1868.979, 1754.235, 1644.541, 1542.893, 1445.003, 1351.171,
+    1265.234, 1181.987, 1099.729, 1025.004, 957.105, 887.197, 829.802, 769.856,
+    719.429, 666.755, 620.653, 579.229, 541.722, 503.727, 466.063, 434.642,
+    405.576, 376.510, 347.145, 321.802, 294.357, 271.007, 251.780, 231.971,
+    216.316, 194.934, 182.304, 166.139, 153.799, 145.408, 134.929, 131.354,
+    121.801, 110.591, 103.839, 96.126, 82.417, 75.360, 65.935, 59.506,
+    57.566, 43.706, 34.982, 33.980
+};
+
+const double RAW_B16[] = {
+    48864.88, 50495.63, 52164.65, 53872.38, 55617.11, 57397.97, 59218.42, 61075.51,
+    62972.95, 64906.18, 66875.92, 68884.81, 70932.32, 73011.90, 75128.73, 77278.26,
+    79469.65, 81695.69, 83956.99, 86249.55, 88569.60, 90928.00, 93323.30, 95745.98,
+    98200.16, 100692.90, 103209.70, 105752.48, 108321.07, 110918.12, 113545.30, 116200.86,
+    118881.15, 121593.85, 124321.92, 127071.27, 129854.34, 132656.65, 135473.84, 138312.25,
+    141183.70, 144069.69, 146978.54, 149906.06, 152851.21, 155801.66, 158764.99, 161757.54,
+    164768.18, 167793.17, 170832.90, 173870.69, 176927.40, 179999.77, 183073.45, 186164.36,
+    189266.52, 192381.56, 195506.40, 198644.10, 201786.85, 204935.81, 208099.65, 211257.31,
+    214437.03, 217602.43, 220787.43, 223977.56, 227174.81, 230380.52, 233583.85, 236800.85,
+    240004.60, 243217.46, 246437.27, 249650.86, 252890.58, 256113.91, 259352.72, 262591.03,
+    265843.31, 269080.85, 272332.01, 275572.80, 278836.81, 282081.26, 285344.11, 288609.72,
+    291886.32, 295148.31, 298394.72, 301670.01, 304938.75, 308219.52, 311474.21, 314747.10,
+    318014.99, 321285.56, 324550.28, 327804.90
+};
+
+const double BIAS_B16[] = {
+    45588.880, 43942.633, 42334.655, 40765.381, 39233.111, 37737.973, 36281.422, 34861.507,
+    33481.948, 32138.176, 30831.923, 29563.809, 28334.323, 27136.905, 25976.733, 24850.264,
+    23764.651, 22713.691, 21697.988, 20713.547, 19757.598, 18839.003, 17957.297, 17102.977,
+    16280.164, 15496.896, 14736.702, 14002.480, 13294.074, 12614.120, 11965.303, 11343.861,
+    10747.150, 10182.854, 9633.919, 9107.273, 8613.340, 8138.651, 7678.844, 7240.251,
+    6835.696, 6444.693, 6076.545, 5727.064, 5395.214, 5069.662, 4755.993, 4471.543,
+    4205.184, 3953.172, 3716.900, 3477.691, 3257.402, 3052.765, 2849.452, 2664.364,
+    2489.520, 2327.556, 2175.397, 2036.104, 1902.850, 1774.808, 1661.646, 1542.306,
+    1445.028, 1334.427, 1242.426, 1155.559, 1075.813, 1004.520, 931.846, 871.847,
+    798.600, 734.455, 677.274, 614.863, 577.582, 523.911, 485.722, 447.028,
+    423.311, 383.847, 358.015, 321.804, 308.813, 277.263, 263.113, 251.717,
+    251.320, 236.315, 206.719, 205.014, 196.747, 200.519, 178.206, 175.100,
+    165.987, 159.562, 147.284, 124.905
+};
+
+const double RAW_B17[] = {
+    97730.53, 100992.94, 104332.78, 107748.46, 111239.62, 114810.08, 118455.57, 122175.27,
+    125974.04, 129843.24, 133791.32, 137808.04, 141900.34, 146079.39, 150312.07, 154626.20,
+    159001.38, 163446.76, 167973.23, 172554.24, 177211.58, 181927.13, 186710.23, 191563.17,
+    196468.78, 201444.98, 206485.84, 211586.29, 216736.10, 221952.64, 227211.78, 232506.40,
+    237860.50, 243272.86, 248728.03, 254231.29, 259795.06, 265382.25, 271036.17, 276708.62,
+    282442.82, 288225.05, 294027.97, 299847.90, 305732.03, 311658.06, 317594.22, 323578.31,
+    329597.75, 335640.56, 341706.14, 347789.14, 353902.78, 360034.95, 366179.80, 372391.19,
+    378607.05, 384818.95, 391058.22, 397303.77, 403565.94, 409879.75, 416207.74, 422525.51,
+    428848.31, 435200.93, 441586.73, 447919.67, 454319.55, 460696.08, 467136.27, 473551.44,
+    479977.11, 486423.80, 492855.01, 499316.69, 505792.40, 512248.48, 518763.43, 525234.20,
+    531721.91, 538220.63, 544697.67, 551202.72, 557716.38, 564236.77, 570742.38, 577250.46,
+    583717.19, 590227.45, 596722.71, 603289.01, 609794.76, 616288.59, 622796.92, 629334.44,
+    635864.58, 642406.23, 648896.29, 655469.68
+};
+
+const double BIAS_B17[] = {
+    91177.529, 87885.938, 84672.779, 81534.463, 78471.623, 75489.081, 72580.574, 69747.271,
+    66992.045, 64307.236, 61702.318, 59165.041, 56704.336, 54329.393, 52008.072, 49769.201,
+    47590.384, 45482.763, 43455.232, 41482.241, 39586.584, 37748.127, 35978.230, 34277.168,
+    32628.779, 31051.977, 29538.840, 28086.289, 26682.105, 25344.636, 24050.781, 22791.398,
+    21592.502, 20450.858, 19352.028, 18302.288, 17312.055, 16346.254, 15446.168, 14564.619,
+    13745.822, 12974.053, 12223.969, 11489.899, 10820.034, 10193.064, 9575.218, 9006.315,
+    8471.754, 7960.562, 7473.138, 7002.144, 6562.783, 6140.952, 5731.804, 5390.193,
+    5052.045, 4710.947, 4396.219, 4087.765, 3796.944, 3556.747, 3331.743, 3095.514,
+    2864.310, 2663.933, 2495.732, 2275.674, 2121.552, 1944.079, 1831.265, 1692.439,
+    1565.112, 1457.800, 1335.011, 1243.687, 1165.403, 1068.480, 1029.433, 946.200,
+    880.913, 825.630, 749.668, 700.719, 660.380, 627.772, 579.375, 534.456,
+    447.195, 403.453, 345.714, 358.010, 310.755, 250.594, 204.918, 189.445,
+    165.580, 154.226, 90.286, 109.681
+};
+
+const double RAW_B18[] = {
+    195463.78, 201989.72, 208666.21, 215494.39, 222476.90, 229609.15, 236899.68, 244345.34,
+    251928.00, 259662.53, 267546.59, 275562.24, 283729.58, 292064.80, 300548.28, 309173.65,
+    317932.01, 326833.56, 335868.97, 345062.25, 354364.49, 363807.65, 373371.72, 383068.20,
+    392875.72, 402825.15, 412862.13, 423042.67, 433336.54, 443743.75, 454291.20, 464952.23,
+    475686.95, 486544.35, 497489.73, 508474.94, 519602.67, 530800.82, 542127.66, 553520.60,
+    565006.07, 576572.29, 588173.97, 599887.08, 611663.79, 623507.27, 635386.65, 647333.91,
+    659351.47, 671461.99, 683600.24, 695833.45, 708111.11, 720383.51, 732681.13, 745069.61,
+    757482.00, 769940.12, 782431.24, 794958.26, 807559.09, 820092.84, 832647.79, 845332.87,
+    858084.19, 870826.28, 883549.15, 896257.54, 909093.00, 921974.30, 934786.84, 947641.79,
+    960458.85, 973292.75, 986200.50, 999180.44, 1012123.85, 1025000.72, 1037944.10, 1050858.78,
+    1063856.07, 1076820.17, 1089821.12, 1102843.42, 1115839.95, 1128867.13, 1141840.43, 1154847.60,
+    1167894.41, 1180971.36, 1194057.58, 1207068.80, 1220202.97, 1233235.60, 1246228.58, 1259298.59,
+    1272451.52, 1285584.57, 1298697.38, 1311780.93
+};
+
+const double BIAS_B18[] = {
+    182356.784, 175775.719, 169345.212, 163066.392, 156940.898, 150966.154, 145149.677, 139488.339,
+    133964.004, 128590.528, 123367.591, 118276.236, 113336.579, 108564.798, 103940.279, 99458.649,
+    95110.008, 90904.559, 86832.968, 82918.252, 79113.487, 75449.648, 71906.721, 68496.197,
+    65195.723, 62038.151, 58968.126, 56041.672, 53228.545, 50527.751, 47968.201, 45522.234,
+    43149.952, 40900.351, 38737.732, 36615.938, 34636.674, 32727.818, 30947.661, 29232.596,
+    27611.068, 26070.285, 24564.971, 23171.084, 21839.791, 20576.269, 19348.650, 18188.912,
+    17099.466, 16101.993, 15133.244, 14259.452, 13430.113, 12595.509, 11785.126, 11066.608,
+    10372.004, 9723.118, 9107.239, 8526.258, 8020.091, 7446.837, 6894.795, 6472.874,
+    6116.192, 5751.280, 5367.150, 4968.544, 4696.999, 4470.296, 4175.839, 3923.791,
+    3633.847, 3360.747, 3160.497, 3033.439, 2869.850, 2639.716, 2476.098, 2282.777,
+    2173.072, 2030.173, 1924.124, 1839.420, 1727.952, 1648.132, 1514.425, 1414.596,
+    1354.407, 1323.364, 1302.583, 1206.799, 1233.967, 1159.605, 1044.581, 1007.588,
+    1053.516, 1079.571, 1085.383, 1060.928
+};
+
+const BiasTable TABLES[] = {
+    {RAW_B4, BIAS_B4, sizeof(RAW_B4) / sizeof(double)},
+    {RAW_B5, BIAS_B5, sizeof(RAW_B5) / sizeof(double)},
+    {RAW_B6, BIAS_B6, sizeof(RAW_B6) / sizeof(double)},
+    {RAW_B7, BIAS_B7, sizeof(RAW_B7) / sizeof(double)},
+    {RAW_B8, BIAS_B8, sizeof(RAW_B8) / sizeof(double)},
+    {RAW_B9, BIAS_B9, sizeof(RAW_B9) / sizeof(double)},
+    {RAW_B10, BIAS_B10, sizeof(RAW_B10) / sizeof(double)},
+    {RAW_B11, BIAS_B11, sizeof(RAW_B11) / sizeof(double)},
+    {RAW_B12, BIAS_B12, sizeof(RAW_B12) / sizeof(double)},
+    {RAW_B13, BIAS_B13, sizeof(RAW_B13) / sizeof(double)},
+    {RAW_B14, BIAS_B14, sizeof(RAW_B14) / sizeof(double)},
+    {RAW_B15, BIAS_B15, sizeof(RAW_B15) / sizeof(double)},
+    {RAW_B16, BIAS_B16, sizeof(RAW_B16) / sizeof(double)},
+    {RAW_B17, BIAS_B17, sizeof(RAW_B17) / sizeof(double)},
+    {RAW_B18, BIAS_B18, sizeof(RAW_B18) / sizeof(double)},
+};
+
+} // namespace
+
+const BiasTable& biasTable(uint8_t B) {
+    return TABLES[B - BIAS_TABLE_MIN_B];
+}
@@ -0,0 +1,23 @@
+#ifndef BIASTABLES_H
+#define BIASTABLES_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Эмпирические таблицы смещения сырой оценки HyperLogLog (HLL++).
+// Для каждого B точки упорядочены по возрастанию мощности: средняя сырая
+// оценка alpha_m * m^2 / sum 2^(-M[j]) и среднее смещение (оценка минус
+// мощность). Данные в BiasTables.cpp генерируются программой gen_bias_tables
+struct BiasTable {
+    const double* raw_estimates;
+    const double* biases;
+    size_t size;
+};
+
+constexpr uint8_t BIAS_TABLE_MIN_B = 4;
+constexpr uint8_t BIAS_TABLE_MAX_B = 18;
+
+// Таблица для BIAS_TABLE_MIN_B <= B <= BIAS_TABLE_MAX_B
+const BiasTable& biasTable(uint8_t B);
+
+#endif // BIASTABLES_H
@@ -0,0 +1,164 @@
+#include "ConcurrentHyperLogLog.h"
+#include "SketchIO.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+constexpr size_t BATCH_CHUNK = 1024;
+constexpr uint64_t REGISTER_MASK = 0x3F;
+
+inline uint8_t rankOf(uint32_t hash, uint8_t B) {
+    uint32_t w = hash & ((1U << (32 - B)) - 1);
+    return static_cast<uint8_t>(w ? __builtin_clz(w) - B + 1 : 32 - B + 1);
+}
+
+inline uint8_t rankOf(uint64_t hash, uint8_t B) {
+    uint64_t w = hash & ((1ULL << (64 - B)) - 1);
+    return static_cast<uint8_t>(w ? __builtin_clzll(w) - B + 1 : 64 - B + 1);
+}
+
+} // namespace
+
+ConcurrentHyperLogLog::ConcurrentHyperLogLog(uint8_t b, uint32_t seed, HashKind kind)
+    : B(b),
+      m(1ULL << b),
+      hasher(seed),
+      kind(kind),
+      words((m + PER_WORD - 1) / PER_WORD) {
+    if (B < MIN_PRECISION || B > maxPrecision(kind)) {
+        throw std::invalid_argument("B must be between 4 and 16 (18 with a 64-bit hash)");
+    }
+    clear();
+}
+
+void ConcurrentHyperLogLog::updateRegister(size_t j, uint8_t rank) {
+    std::atomic<uint64_t>& word = words[j / PER_WORD];
+    const unsigned shift = static_cast<unsigned>(j % PER_WORD) * 6;
+    const uint64_t mask = REGISTER_MASK << shift;
+
+    // Чтение без записи: регистр уже не меньше rank
+    uint64_t current = word.load(std::memory_order_relaxed);
+    if (((current >> shift) & REGISTER_MASK) >= rank) {
+        return;
+    }
+
+    // Другие потоки могли изменить соседние регистры или этот же регистр;
+    // при неудаче compare_exchange current обновляется и проверка повторяется
+    uint64_t desired;
+    do {
+        if (((current >> shift) & REGISTER_MASK) >= rank) {
+            return;
+        }
+        desired = (current & ~mask) | (static_cast<uint64_t>(rank) << shift);
+    } while (!word.compare_exchange_weak(current, desired, std::memory_order_relaxed));
+}
+
+void ConcurrentHyperLogLog::insertHash(uint32_t hash) {
+    updateRegister(hash >> (32 - B), rankOf(hash, B));
+}
+
+void ConcurrentHyperLogLog::insertHash(uint64_t hash) {
+    updateRegister(hash >> (64 - B), rankOf(hash, B));
+}
+
+void ConcurrentHyperLogLog::add(std::string_view item) {
+    if (hashBits(kind) == 64) {
+        insertHash(hasher.hash64(item, kind));
+    } else {
+        insertHash(hasher.hash(item));
+    }
+}
+
+void ConcurrentHyperLogLog::add(const void* data, size_t length) {
+    add(std::string_view(static_cast<const char*>(data), length));
+}
+
+void ConcurrentHyperLogLog::add(uint64_t key) {
+    if (hashBits(kind) == 64) {
+        insertHash(hasher.hash64(key, kind));
+    } else {
+        insertHash(hasher.hash(key));
+    }
+}
+
+template <typename Key>
+void ConcurrentHyperLogLog::addBatchImpl(const Key* items, size_t count) {
+    if (hashBits(kind) == 64) {
+        uint64_t hashes[BATCH_CHUNK];
+        for (size_t offset = 0; offset < count; offset += BATCH_CHUNK) {
+            size_t n = std::min(BATCH_CHUNK, count - offset);
+            hasher.hashBatch64(items + offset, n, hashes, kind);
+            for (size_t i = 0; i < n; ++i) {
+                insertHash(hashes[i]);
+            }
+        }
+    } else {
+        uint32_t hashes[BATCH_CHUNK];
+        for (size_t offset = 0; offset < count; offset += BATCH_CHUNK) {
+            size_t n = std::min(BATCH_CHUNK, count - offset);
+            hasher.hashBatch(items + offset, n, hashes);
+            for (size_t i = 0; i < n; ++i) {
+                insertHash(hashes[i]);
+            }
+        }
+    }
+}
+
+void ConcurrentHyperLogLog::addBatch(const std::string* items, size_t count) {
+    addBatchImpl(items, count);
+}
+
+void ConcurrentHyperLogLog::addBatch(const std::string_view* items, size_t count) {
+    addBatchImpl(items, count);
+}
+
+void ConcurrentHyperLogLog::addBatch(const uint64_t* keys, size_t count) {
+    addBatchImpl(keys, count);
+}
+
+uint8_t ConcurrentHyperLogLog::get(size_t j) const {
+    uint64_t word = words[j / PER_WORD].load(std::memory_order_relaxed);
+    return static_cast<uint8_t>((word >> (j % PER_WORD * 6)) & REGISTER_MASK);
+}
+
+uint64_t ConcurrentHyperLogLog::estimate() const {
+    double harmonic_sum = 0.0;
+    size_t zero_count = 0;
+    for (size_t w = 0; w < words.size(); ++w) {
+        uint64_t word = words[w].load(std::memory_order_relaxed);
+        size_t registers = std::min(PER_WORD, m - w * PER_WORD);
+        for (size_t k = 0; k < registers; ++k, word >>= 6) {
+            uint8_t value = static_cast<uint8_t>(word & REGISTER_MASK);
+            harmonic_sum += INV_POW2[value];
+            zero_count += value == 0;
+        }
+    }
+    return estimateFromSums(m, harmonic_sum, zero_count, kind);
+}
+
+void ConcurrentHyperLogLog::serialize(std::vector<uint8_t>& out) const {
+    SketchHeader header{};
+    header.b = B;
+    header.hash_kind = static_cast<uint8_t>(kind);
+    header.encoding = static_cast<uint8_t>(RegisterEncoding::Byte);
+    header.seed = hasher.getSeed();
+    header.entry_count = static_cast<uint32_t>(m);
+    appendSketchRecord(out, header, ByteRegisters::bytesFor(m), [this](uint8_t* payload) {
+        for (size_t j = 0; j < m; ++j) {
+            payload[j] = get(j);
+        }
+    });
+}
+
+HyperLogLog ConcurrentHyperLogLog::snapshot() const {
+    std::vector<uint8_t> record;
+    serialize(record);
+    return HyperLogLog::deserialize(record.data(), record.size());
+}
+
+void ConcurrentHyperLogLog::clear() {
+    for (auto& word : words) {
+        word.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef CONCURRENTHYPERLOGLOG_H
+#define CONCURRENTHYPERLOGLOG_H
+
+#include <vector>
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include "HashFuncGen.h"
+#include "HyperLogLog.h"
+
+// HyperLogLog, в который одновременно пишут несколько потоков без блокировок.
+// Регистры по 6 бит уложены по 10 в 64-битные атомарные слова (старшие
+// 4 бита слова не используются). Вставка читает слово и, если регистр не
+// меньше нового ранга (почти все вставки в заполненный скетч), ничего не
+// записывает; иначе максимум записывается циклом compare_exchange по слову.
+// Регистры только растут, поэтому estimate() и serialize() можно вызывать
+// параллельно со вставкой: они видят состояние, в котором каждый регистр
+// имеет одно из своих значений за время чтения.
+// Регистры и оценка совпадают с HyperLogLog тех же B, seed и хеша
+class ConcurrentHyperLogLog {
+private:
+    static constexpr size_t PER_WORD = 10;
+
+    uint8_t B;
+    size_t m;
+    HashFuncGen hasher;
+    HashKind kind;
+    std::vector<std::atomic<uint64_t>> words;
+
+    // Атомарный максимум регистра j и rank
+    void updateRegister(size_t j, uint8_t rank);
+
+    void insertHash(uint32_t hash);
+    void insertHash(uint64_t hash);
+
+    template <typename Key>
+    void addBatchImpl(const Key* items, size_t count);
+
+public:
+    ConcurrentHyperLogLog(uint8_t b = 14, uint32_t seed = 42,
+                          HashKind kind = HashKind::Murmur3_32);
+
+    ConcurrentHyperLogLog(const ConcurrentHyperLogLog&) = delete;
+    ConcurrentHyperLogLog& operator=(const ConcurrentHyperLogLog&) = delete;
+
+    // Добавление элемента (потокобезопасно)
+    void add(std::string_view item);
+    void add(const void* data, size_t length);
+    void add(uint64_t key);
+
+    // Пакетное добавление: хеши считаются векторным ядром, затем регистры
+    // обновляются по одному (потокобезопасно)
+    void addBatch(const std::string* items, size_t count);
+    void addBatch(const std::string_view* items, size_t count);
+    void addBatch(const uint64_t* keys, size_t count);
+
+    // Оценка по текущему состоянию (потокобезопасно, O(m))
+    uint64_t estimate() const;
+
+    // Значение регистра j
+    uint8_t get(size_t j) const;
+
+    // Сериализация в формат SketchIO.h с байтовой раскладкой регистров
+    // (читается HyperLogLog::deserialize и HyperLogLogView)
+    void serialize(std::vector<uint8_t>& out) const;
+
+    // Копия текущего состояния в обычный HyperLogLog
+    HyperLogLog snapshot() const;
+
+    // Обнуление регистров (не должно выполняться параллельно со вставкой)
+    void clear();
+
+    size_t getM() const { return m; }
+    uint8_t getB() const { return B; }
+    HashKind getHashKind() const { return kind; }
+
+    size_t memoryBytes() const {
+        return sizeof(*this) + words.capacity() * sizeof(uint64_t);
+    }
+};
+
+#endif // CONCURRENTHYPERLOGLOG_H
@@ -0,0 +1,148 @@
+#include "DistinctCounter.h"
+#include <algorithm>
+#include <cstring>
+#include <emmintrin.h>
+
+namespace {
+
+// Seed отпечатков; не связан с seed скетчей
+constexpr uint32_t FINGERPRINT_SEED = 0x9747b28c;
+
+inline uint32_t matchByte(const uint8_t* group, uint8_t value) {
+    __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    __m128i eq = _mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(value)));
+    return static_cast<uint32_t>(_mm_movemask_epi8(eq));
+}
+
+} // namespace
+
+DistinctCounter::DistinctCounter(Mode mode, size_t expected)
+    : mode(mode), hasher(FINGERPRINT_SEED), count(0), group_mask(0),
+      arena_used(ARENA_BLOCK), arena_bytes(0) {
+    // Заполнение не больше 7/8
+    size_t capacity = GROUP;
+    while (capacity / 8 * 7 < expected) {
+        capacity *= 2;
+    }
+    allocate(capacity);
+}
+
+void DistinctCounter::allocate(size_t capacity) {
+    group_mask = capacity / GROUP - 1;
+    ctrl.assign(capacity, EMPTY);
+    fingerprints.assign(capacity, 0);
+    if (mode == Mode::Verified) {
+        keys.assign(capacity, nullptr);
+    }
+}
+
+size_t DistinctCounter::insertNew(uint64_t fingerprint) {
+    const uint8_t tag = static_cast<uint8_t>(fingerprint & 0x7F);
+    size_t group = (fingerprint >> 7) & group_mask;
+    for (size_t step = 1; ; ++step) {
+        uint32_t empty = matchByte(&ctrl[group * GROUP], EMPTY);
+        if (empty != 0) {
+            size_t slot = group * GROUP + __builtin_ctz(empty);
+            ctrl[slot] = tag;
+            fingerprints[slot] = fingerprint;
+            return slot;
+        }
+        // Треугольные шаги по группам обходят все группы таблицы
+        group = (group + step) & group_mask;
+    }
+}
+
+void DistinctCounter::grow() {
+    std::vector<uint8_t> old_ctrl;
+    std::vector<uint64_t> old_fingerprints;
+    std::vector<const char*> old_keys;
+    old_ctrl.swap(ctrl);
+    old_fingerprints.swap(fingerprints);
+    old_keys.swap(keys);
+
+    allocate(old_ctrl.size() * 2);
+    for (size_t i = 0; i < old_ctrl.size(); ++i) {
+        if (old_ctrl[i] != EMPTY) {
+            size_t slot = insertNew(old_fingerprints[i]);
+            if (mode == Mode::Verified) {
+                keys[slot] = old_keys[i];
+            }
+        }
+    }
+}
+
+const char* DistinctCounter::storeKey(std::string_view key) {
+    const size_t record = sizeof(uint32_t) + key.size();
+    if (arena.empty() || record > ARENA_BLOCK - arena_used) {
+        // Ключ длиннее блока получает собственный блок
+        size_t block = std::max(ARENA_BLOCK, record);
+        arena.emplace_back(new char[block]);
+        arena_bytes += block;
+        arena_used = 0;
+    }
+    char* dst = arena.back().get() + arena_used;
+    const uint32_t length = static_cast<uint32_t>(key.size());
+    std::memcpy(dst, &length, sizeof(length));
+    std::memcpy(dst + sizeof(length), key.data(), key.size());
+    arena_used += record;
+    return dst;
+}
+
+bool DistinctCounter::sameKey(const char* stored, std::string_view key) {
+    uint32_t length;
+    std::memcpy(&length, stored, sizeof(length));
+    return length == key.size() &&
+           std::memcmp(stored + sizeof(length), key.data(), key.size()) == 0;
+}
+
+bool DistinctCounter::insert(std::string_view key) {
+    if (count + 1 > ctrl.size() / 8 * 7) {
+        grow();
+    }
+
+    const uint64_t fingerprint = hasher.hash64(key);
+    const uint8_t tag = static_cast<uint8_t>(fingerprint & 0x7F);
+    size_t group = (fingerprint >> 7) & group_mask;
+
+    for (size_t step = 1; ; ++step) {
+        const uint8_t* group_ctrl = &ctrl[group * GROUP];
+
+        // Слоты группы с тем же тегом: сравнение отпечатков (и ключей)
+        for (uint32_t match = matchByte(group_ctrl, tag); match != 0; match &= match - 1) {
+            size_t slot = group * GROUP + __builtin_ctz(match);
+            if (fingerprints[slot] == fingerprint &&
+                (mode == Mode::Fingerprint || sameKey(keys[slot], key))) {
+                return false;
+            }
+        }
+
+        // Удалений нет, поэтому пустой слот означает конец цепочки
+        uint32_t empty = matchByte(group_ctrl, EMPTY);
+        if (empty != 0) {
+            size_t slot = group * GROUP + __builtin_ctz(empty);
+            ctrl[slot] = tag;
+            fingerprints[slot] = fingerprint;
+            if (mode == Mode::Verified) {
+                keys[slot] = storeKey(key);
+            }
+            ++count;
+            return true;
+        }
+
+        group = (group + step) & group_mask;
+    }
+}
+
+void DistinctCounter::clear() {
+    std::fill(ctrl.begin(), ctrl.end(), EMPTY);
+    count = 0;
+    arena.clear();
+    arena_used = ARENA_BLOCK;
+    arena_bytes = 0;
+}
+
+size_t DistinctCounter::memoryBytes() const {
+    return ctrl.capacity() + fingerprints.capacity() * sizeof(uint64_t) +
+           keys.capacity() * sizeof(keys[0]) + arena_bytes +
+           arena.capacity() * sizeof(arena[0]);
+}
@@ -0,0 +1,84 @@
+#ifndef DISTINCTCOUNTER_H
+#define DISTINCTCOUNTER_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "HashFuncGen.h"
+
+// Точный подсчет уникальных ключей: плоская хеш-таблица с открытой
+// адресацией в стиле Swiss table над 64-битными отпечатками ключей.
+// Слоты разбиты на группы по 16; для каждого слота хранится управляющий
+// байт (EMPTY или 7 младших бит отпечатка), группа проверяется одним
+// сравнением SSE2. Отдельных узлов на ключ нет, таблица - три плоских массива.
+//
+// Режимы:
+//   Fingerprint - хранится только отпечаток (9 байт на слот); разные ключи
+//                 с одинаковым отпечатком считаются одним, вероятность
+//                 этого около n^2 / 2^65 (~3e-4 для 10^8 ключей)
+//   Verified    - ключи копируются в арену и сравниваются целиком при
+//                 совпадении отпечатков, результат всегда точный
+//                 (17 байт на слот и длина ключа + 4 байта в арене)
+class DistinctCounter {
+public:
+    enum class Mode : uint8_t {
+        Fingerprint = 0,
+        Verified = 1
+    };
+
+    // expected - ожидаемое количество уникальных ключей (для резервирования)
+    explicit DistinctCounter(Mode mode = Mode::Verified, size_t expected = 0);
+
+    // Добавление ключа; true, если ключ встретился впервые
+    bool insert(std::string_view key);
+
+    // Количество уникальных ключей
+    size_t size() const { return count; }
+
+    // Удаление всех ключей (память таблицы сохраняется)
+    void clear();
+
+    // Объем памяти таблицы и арены в байтах
+    size_t memoryBytes() const;
+
+    Mode getMode() const { return mode; }
+
+private:
+    static constexpr size_t GROUP = 16;
+    static constexpr uint8_t EMPTY = 0x80;
+    static constexpr size_t ARENA_BLOCK = 1 << 20;
+
+    Mode mode;
+    HashFuncGen hasher;
+    size_t count;
+    size_t group_mask;                   // Количество групп - 1 (степень двойки)
+    std::vector<uint8_t> ctrl;           // Управляющие байты
+    std::vector<uint64_t> fingerprints;  // Отпечатки ключей
+    std::vector<const char*> keys;       // Ключи в арене (только Verified)
+
+    // Арена: блоки по ARENA_BLOCK байт, ключи не переезжают при росте.
+    // Ключ хранится как uint32_t длина и байты ключа
+    std::vector<std::unique_ptr<char[]>> arena;
+    size_t arena_used;
+    size_t arena_bytes;
+
+    // Выделение групп: capacity слотов (кратно GROUP, степень двойки)
+    void allocate(size_t capacity);
+
+    // Увеличение таблицы вдвое с переносом отпечатков
+    void grow();
+
+    // Копия ключа в арену
+    const char* storeKey(std::string_view key);
+
+    // Совпадает ли ключ в арене с key
+    static bool sameKey(const char* stored, std::string_view key);
+
+    // Запись отпечатка в первый свободный слот (ключ заведомо новый)
+    size_t insertNew(uint64_t fingerprint);
+};
+
+#endif // DISTINCTCOUNTER_H
@@ -0,0 +1,235 @@
+#include "Estimators.h"
+#include "BiasTables.h"
+#include "HyperLogLog.h"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+// Число соседей при интерполяции смещения (как в HLL++)
+constexpr size_t BIAS_NEIGHBORS = 6;
+
+// Пороги линейного счета HLL++ для B = 4..18
+constexpr double LINEAR_COUNTING_THRESHOLDS[] = {
+    10, 20, 40, 80, 220, 400, 900, 1800, 3100, 6500, 11500, 20000, 50000, 120000, 350000
+};
+
+// sigma(x) = x + sum_{k>=1} x^(2^k) * 2^(k-1)
+double sigma(double x) {
+    if (x == 1.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double y = 1.0;
+    double z = x;
+    double z_prev;
+    do {
+        x *= x;
+        z_prev = z;
+        z += x * y;
+        y += y;
+    } while (z != z_prev);
+    return z;
+}
+
+// tau(x) = (1 - x - sum_{k>=1} (1 - x^(2^-k))^2 * 2^-k) / 3
+double tau(double x) {
+    if (x == 0.0 || x == 1.0) {
+        return 0.0;
+    }
+    double y = 1.0;
+    double z = 1.0 - x;
+    double z_prev;
+    do {
+        x = std::sqrt(x);
+        z_prev = z;
+        y *= 0.5;
+        z -= (1.0 - x) * (1.0 - x) * y;
+    } while (z != z_prev);
+    return z / 3.0;
+}
+
+// Ertl, "New cardinality estimation algorithms for HyperLogLog sketches",
+// алгоритм 6
+double improvedEstimate(const RegisterHistogram& c, size_t m, int q) {
+    const double md = static_cast<double>(m);
+    double z = md * tau(1.0 - c[q + 1] / md);
+    for (int k = q; k >= 1; --k) {
+        z = 0.5 * (z + c[k]);
+    }
+    z += md * sigma(c[0] / md);
+    return md * md / (2.0 * std::log(2.0)) / z;
+}
+
+// Там же, алгоритм 8: корень производной логарифма правдоподобия
+// методом секущих с относительной точностью 0.01 / sqrt(m)
+double maxLikelihoodEstimate(const RegisterHistogram& c, size_t m, int q) {
+    if (c[q + 1] == m) {
+        return std::numeric_limits<double>::infinity();
+    }
+    int k_min = 0;
+    while (c[k_min] == 0) {
+        ++k_min;
+    }
+    int k_max = q + 1;
+    while (c[k_max] == 0) {
+        --k_max;
+    }
+    const int k_min1 = std::max(k_min, 1);
+    const int k_max1 = std::min(k_max, q);
+    if (k_min1 > k_max1) {
+        // Все регистры нулевые
+        return 0.0;
+    }
+
+    double z = 0.0;
+    for (int k = k_max1; k >= k_min1; --k) {
+        z = 0.5 * z + c[k];
+    }
+    z = std::ldexp(z, -k_min1);
+
+    double c_prime = c[q + 1];
+    if (q >= 1) {
+        c_prime += c[k_max1];
+    }
+    const double a = z + c[0];
+    const double b = z + std::ldexp(static_cast<double>(c[q + 1]), -q);
+    const double m_prime = static_cast<double>(m - c[0]);
+
+    double x = b <= 1.5 * a ? m_prime / (0.5 * b + a) : m_prime / b * std::log1p(b / a);
+    double delta_x = x;
+    double g_prev = 0.0;
+    const double epsilon = 0.01 / std::sqrt(static_cast<double>(m));
+    while (delta_x > x * epsilon) {
+        const int kappa = 2 + static_cast<int>(std::floor(std::log2(x)));
+        double x1 = std::ldexp(x, -std::max(k_max1, kappa) - 1);
+        const double x2 = x1 * x1;
+        double h = x1 - x2 / 3.0 + x2 * x2 * (1.0 / 45.0 - x2 / 472.5);
+        for (int k = kappa - 1; k >= k_max1; --k) {
+            h = (x1 + h * (1.0 - h)) / (x1 + (1.0 - h));
+            x1 *= 2.0;
+        }
+        double g = c_prime * h;
+        for (int k = k_max1 - 1; k >= k_min1; --k) {
+            h = (x1 + h * (1.0 - h)) / (x1 + (1.0 - h));
+            g += c[k] * h;
+            x1 *= 2.0;
+        }
+        g += x * a;
+
+        if (g > g_prev && m_prime >= g) {
+            delta_x *= (m_prime - g) / (g - g_prev);
+        } else {
+            delta_x = 0.0;
+        }
+        x += delta_x;
+        g_prev = g;
+    }
+    return static_cast<double>(m) * x;
+}
+
+double biasCorrectedEstimate(const RegisterHistogram& c, size_t m, int q, uint8_t B) {
+    double harmonic_sum = 0.0;
+    for (int k = 0; k <= q + 1; ++k) {
+        harmonic_sum += std::ldexp(static_cast<double>(c[k]), -k);
+    }
+    const double md = static_cast<double>(m);
+    double raw = alphaFor(m) * md * md / harmonic_sum;
+    if (raw <= 5.0 * md) {
+        raw -= estimateBias(raw, B);
+    }
+    if (c[0] != 0) {
+        double linear = md * std::log(md / c[0]);
+        if (linear <= linearCountingThreshold(B)) {
+            return linear;
+        }
+    }
+    return raw;
+}
+
+} // namespace
+
+const char* estimatorName(Estimator estimator) {
+    switch (estimator) {
+        case Estimator::Classic:        return "classic";
+        case Estimator::Improved:       return "improved";
+        case Estimator::MaxLikelihood:  return "ml";
+        case Estimator::BiasCorrected:  return "hllpp";
+    }
+    return "unknown";
+}
+
+double linearCountingThreshold(uint8_t B) {
+    if (B < BIAS_TABLE_MIN_B || B > BIAS_TABLE_MAX_B) {
+        throw std::invalid_argument("Bias correction requires B between 4 and 18");
+    }
+    return LINEAR_COUNTING_THRESHOLDS[B - BIAS_TABLE_MIN_B];
+}
+
+double estimateBias(double raw, uint8_t B) {
+    if (B < BIAS_TABLE_MIN_B || B > BIAS_TABLE_MAX_B) {
+        throw std::invalid_argument("Bias correction requires B between 4 and 18");
+    }
+    const BiasTable& table = biasTable(B);
+    if (raw > 5.0 * static_cast<double>(1ULL << B)) {
+        return 0.0;
+    }
+
+    // Точки упорядочены по сырой оценке: окно из BIAS_NEIGHBORS ближайших
+    // расширяется от позиции raw в обе стороны
+    size_t right = 0;
+    while (right < table.size && table.raw_estimates[right] < raw) {
+        ++right;
+    }
+    size_t left = right;
+    while (right - left < BIAS_NEIGHBORS && (left > 0 || right < table.size)) {
+        if (left == 0) {
+            ++right;
+        } else if (right == table.size ||
+                   raw - table.raw_estimates[left - 1] < table.raw_estimates[right] - raw) {
+            --left;
+        } else {
+            ++right;
+        }
+    }
+    double sum = 0.0;
+    for (size_t i = left; i < right; ++i) {
+        sum += table.biases[i];
+    }
+    return sum / static_cast<double>(right - left);
+}
+
+uint64_t estimateFromHistogram(const RegisterHistogram& histogram, uint8_t B,
+                               HashKind kind, Estimator estimator) {
+    const size_t m = size_t(1) << B;
+    const int q = hashBits(kind) - B;
+    double estimate = 0.0;
+
+    switch (estimator) {
+        case Estimator::Classic: {
+            double harmonic_sum = 0.0;
+            for (int k = 0; k <= q + 1; ++k) {
+                harmonic_sum += std::ldexp(static_cast<double>(histogram[k]), -k);
+            }
+            return estimateFromSums(m, harmonic_sum, histogram[0], kind);
+        }
+        case Estimator::Improved:
+            estimate = improvedEstimate(histogram, m, q);
+            break;
+        case Estimator::MaxLikelihood:
+            estimate = maxLikelihoodEstimate(histogram, m, q);
+            break;
+        case Estimator::BiasCorrected:
+            estimate = biasCorrectedEstimate(histogram, m, q, B);
+            // Поправка для больших значений 32-битного хеша, как в estimateFromSums
+            if (kind == HashKind::Murmur3_32 && estimate > 4294967296.0 / 30.0) {
+                estimate = -4294967296.0 * std::log(1.0 - estimate / 4294967296.0);
+            }
+            break;
+    }
+
+    if (!(estimate < static_cast<double>(std::numeric_limits<uint64_t>::max()))) {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    return static_cast<uint64_t>(estimate);
+}
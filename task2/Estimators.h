@@ -0,0 +1,41 @@
+#ifndef ESTIMATORS_H
+#define ESTIMATORS_H
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include "HashFuncGen.h"
+
+// Способ получения оценки по регистрам HyperLogLog
+enum class Estimator : uint8_t {
+    Classic = 0,        // Флажоле и др.: alpha_m * m^2 / sum 2^(-M[j]),
+                        // линейный счет до 2.5m (совпадает с estimate())
+    Improved = 1,       // Ertl: улучшенная оценка с поправками для нулевых
+                        // и насыщенных регистров, без переключений
+    MaxLikelihood = 2,  // Ertl: оценка максимального правдоподобия
+                        // (метод секущих по гистограмме)
+    BiasCorrected = 3   // HLL++: сырая оценка минус эмпирическое смещение
+                        // до 5m, линейный счет ниже порога для B
+};
+
+// Гистограмма регистров: histogram[k] - количество регистров со значением k.
+// Значения не превосходят 65 - B (64-битный хеш), поэтому 64 корзин достаточно;
+// насыщенный регистр имеет значение q + 1, где q = 32 - B или 64 - B
+using RegisterHistogram = std::array<uint32_t, 64>;
+
+// Название оценщика (для вывода)
+const char* estimatorName(Estimator estimator);
+
+// Оценка по гистограмме m = 2^B регистров за O(q): количество операций
+// не зависит от m. Для BiasCorrected допустимы B = 4..18
+uint64_t estimateFromHistogram(const RegisterHistogram& histogram, uint8_t B,
+                               HashKind kind, Estimator estimator);
+
+// Эмпирическое смещение сырой оценки raw (среднее по 6 ближайшим точкам
+// таблицы BiasTables.h); 0 выше 5m
+double estimateBias(double raw, uint8_t B);
+
+// Порог HLL++, ниже которого линейный счет точнее оценки с поправкой
+double linearCountingThreshold(uint8_t B);
+
+#endif // ESTIMATORS_H
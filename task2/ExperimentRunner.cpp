@@ -0,0 +1,402 @@
+#include "ExperimentRunner.h"
+#include "WorkStealingPool.h"
+#include "DistinctCounter.h"
+#include "RandomStreamGen.h"
+#include "SyntheticHashes.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+std::string trim(const std::string& text) {
+    const size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    const size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+std::vector<std::string> splitList(const std::string& value) {
+    std::vector<std::string> items;
+    size_t start = 0;
+    for (;;) {
+        const size_t comma = value.find(',', start);
+        std::string item = trim(value.substr(start, comma - start));
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+        if (comma == std::string::npos) {
+            break;
+        }
+        start = comma + 1;
+    }
+    if (items.empty()) {
+        throw std::invalid_argument("Empty list");
+    }
+    return items;
+}
+
+// Неотрицательное целое; допускается запись с порядком (1e9, 2.5e8)
+uint64_t parseNumber(const std::string& text) {
+    size_t used = 0;
+    uint64_t value = 0;
+    try {
+        if (text.find_first_of("eE.") == std::string::npos) {
+            value = std::stoull(text, &used);
+        } else {
+            const double real = std::stod(text, &used);
+            if (real < 0 || real >= 18446744073709551616.0 || real != std::floor(real)) {
+                used = 0;
+            }
+            value = used ? static_cast<uint64_t>(real) : 0;
+        }
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != text.size()) {
+        throw std::invalid_argument("Invalid number: " + text);
+    }
+    return value;
+}
+
+HashKind parseHash(const std::string& name) {
+    for (size_t k = 0; k < HASH_KIND_COUNT; ++k) {
+        if (name == hashKindName(static_cast<HashKind>(k))) {
+            return static_cast<HashKind>(k);
+        }
+    }
+    throw std::invalid_argument("Unknown hash: " + name);
+}
+
+Estimator parseEstimator(const std::string& name) {
+    for (Estimator estimator : {Estimator::Classic, Estimator::Improved,
+                                Estimator::MaxLikelihood, Estimator::BiasCorrected}) {
+        if (name == estimatorName(estimator)) {
+            return estimator;
+        }
+    }
+    throw std::invalid_argument("Unknown estimator: " + name);
+}
+
+} // namespace
+
+void ExperimentGrid::set(const std::string& key, const std::string& value) {
+    if (key == "b") {
+        precisions.clear();
+        for (const auto& item : splitList(value)) {
+            const size_t dots = item.find("..");
+            const uint64_t first = parseNumber(dots == std::string::npos ? item : item.substr(0, dots));
+            const uint64_t last = dots == std::string::npos ? first : parseNumber(item.substr(dots + 2));
+            if (last < first || last > 64) {
+                throw std::invalid_argument("Invalid precision range: " + item);
+            }
+            for (uint64_t b = first; b <= last; ++b) {
+                precisions.push_back(static_cast<uint8_t>(b));
+            }
+        }
+    } else if (key == "hash") {
+        hashes.clear();
+        for (const auto& item : splitList(value)) {
+            hashes.push_back(parseHash(item));
+        }
+    } else if (key == "estimator") {
+        estimators.clear();
+        for (const auto& item : splitList(value)) {
+            estimators.push_back(parseEstimator(item));
+        }
+    } else if (key == "size") {
+        stream_sizes.clear();
+        for (const auto& item : splitList(value)) {
+            stream_sizes.push_back(static_cast<size_t>(parseNumber(item)));
+        }
+    } else if (key == "checkpoints") {
+        percentages.clear();
+        for (const auto& item : splitList(value)) {
+            size_t used = 0;
+            double pct = std::stod(item, &used);
+            if (used != item.size() || pct <= 0 || pct > 100) {
+                throw std::invalid_argument("Checkpoint must be in (0, 100]: " + item);
+            }
+            percentages.push_back(pct);
+        }
+        std::sort(percentages.begin(), percentages.end());
+    } else if (key == "source") {
+        if (value == "strings") {
+            source = StreamSource::Strings;
+        } else if (value == "synthetic") {
+            source = StreamSource::Synthetic;
+        } else {
+            throw std::invalid_argument("Unknown source: " + value);
+        }
+    } else if (key == "trials") {
+        trials = static_cast<unsigned>(parseNumber(value));
+    } else if (key == "stream_seed") {
+        stream_seed = static_cast<uint32_t>(parseNumber(value));
+    } else if (key == "hash_seed") {
+        hash_seed = static_cast<uint32_t>(parseNumber(value));
+    } else {
+        throw std::invalid_argument("Unknown parameter: " + key);
+    }
+}
+
+void ExperimentGrid::setFromString(const std::string& assignment) {
+    const size_t eq = assignment.find('=');
+    if (eq == std::string::npos) {
+        throw std::invalid_argument("Expected key=value: " + assignment);
+    }
+    set(trim(assignment.substr(0, eq)), trim(assignment.substr(eq + 1)));
+}
+
+void ExperimentGrid::loadFile(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open config " + path);
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        line = trim(line.substr(0, line.find('#')));
+        if (!line.empty()) {
+            setFromString(line);
+        }
+    }
+}
+
+void ExperimentGrid::validate() const {
+    if (precisions.empty() || hashes.empty() || estimators.empty() ||
+        stream_sizes.empty() || percentages.empty() || trials == 0) {
+        throw std::invalid_argument("Experiment grid has an empty dimension");
+    }
+    for (uint8_t b : precisions) {
+        for (HashKind kind : hashes) {
+            if (b < MIN_PRECISION || b > maxPrecision(kind)) {
+                throw std::invalid_argument("B = " + std::to_string(b) + " is out of range for " +
+                                            hashKindName(kind));
+            }
+        }
+    }
+}
+
+double RunningStats::stddev() const {
+    return std::sqrt(variance());
+}
+
+double RunningStats::rootMeanSquare() const {
+    return std::sqrt(running_mean * running_mean + variance());
+}
+
+ExperimentRunner::ExperimentRunner(ExperimentGrid grid) : grid(std::move(grid)) {
+    this->grid.validate();
+}
+
+std::vector<TrialRecord> ExperimentRunner::runTrial(size_t index) const {
+    const size_t stream_size = grid.stream_sizes[index / grid.trials];
+    const unsigned trial = static_cast<unsigned>(index % grid.trials);
+    if (grid.source == StreamSource::Synthetic) {
+        return runSyntheticTrial(stream_size, trial);
+    }
+
+    // Те же строки, что у generateStream() для этого seed (без вывода хода
+    // генерации из рабочих потоков), в одной области памяти
+    RandomStreamGen generator(stream_size, grid.stream_seed + 100 * trial);
+    ArenaStream arena;
+    arena.offsets.reserve(stream_size + 1);
+    arena.offsets.push_back(0);
+    for (size_t i = 0; i < stream_size; ++i) {
+        const std::string item = generator.generateRandomString();
+        arena.chars.insert(arena.chars.end(), item.begin(), item.end());
+        arena.offsets.push_back(arena.chars.size());
+    }
+    const std::vector<std::string_view> items = arena.views();
+
+    const size_t checkpoints = grid.percentages.size();
+    std::vector<size_t> ends(checkpoints);
+    std::vector<uint64_t> exact(checkpoints);
+    DistinctCounter unique_elements(DistinctCounter::Mode::Verified, stream_size);
+    size_t position = 0;
+    for (size_t p = 0; p < checkpoints; ++p) {
+        ends[p] = static_cast<size_t>((grid.percentages[p] / 100.0) * stream_size);
+        for (; position < ends[p]; ++position) {
+            unique_elements.insert(items[position]);
+        }
+        exact[p] = unique_elements.size();
+    }
+
+    std::vector<TrialRecord> records(grid.recordsPerTrial());
+    size_t sketch = 0;
+    for (uint8_t b : grid.precisions) {
+        for (HashKind kind : grid.hashes) {
+            HyperLogLog hll(b, grid.hash_seed, kind);
+            size_t added = 0;
+            for (size_t p = 0; p < checkpoints; ++p) {
+                hll.addBatch(items.data() + added, ends[p] - added);
+                added = ends[p];
+                storeRecords(records, sketch, p, stream_size, trial, hll, ends[p], exact[p]);
+            }
+            ++sketch;
+        }
+    }
+    return records;
+}
+
+std::vector<TrialRecord> ExperimentRunner::runSyntheticTrial(size_t stream_size,
+                                                             unsigned trial) const {
+    constexpr size_t CHUNK = 4096;
+
+    std::vector<HyperLogLog> sketches;
+    bool any32 = false;
+    for (uint8_t b : grid.precisions) {
+        for (HashKind kind : grid.hashes) {
+            sketches.emplace_back(b, grid.hash_seed, kind);
+            any32 = any32 || hashBits(kind) == 32;
+        }
+    }
+
+    const SyntheticHashes hashes((static_cast<uint64_t>(grid.hash_seed) << 32) |
+                                 (grid.stream_seed + 100 * trial));
+    std::vector<uint64_t> hashes64(CHUNK);
+    std::vector<uint32_t> hashes32(CHUNK);
+    std::vector<TrialRecord> records(grid.recordsPerTrial());
+    size_t added = 0;
+    for (size_t p = 0; p < grid.percentages.size(); ++p) {
+        const size_t end = static_cast<size_t>((grid.percentages[p] / 100.0) * stream_size);
+        while (added < end) {
+            const size_t n = std::min(CHUNK, end - added);
+            hashes.fill(added, hashes64.data(), n);
+            if (any32) {
+                for (size_t k = 0; k < n; ++k) {
+                    hashes32[k] = static_cast<uint32_t>(hashes64[k] >> 32);
+                }
+            }
+            for (auto& hll : sketches) {
+                if (hashBits(hll.getHashKind()) == 64) {
+                    hll.addHashBatch(hashes64.data(), n);
+                } else {
+                    hll.addHashBatch(hashes32.data(), n);
+                }
+            }
+            added += n;
+        }
+        for (size_t sketch = 0; sketch < sketches.size(); ++sketch) {
+            storeRecords(records, sketch, p, stream_size, trial, sketches[sketch], end, end);
+        }
+    }
+    return records;
+}
+
+void ExperimentRunner::storeRecords(std::vector<TrialRecord>& records, size_t sketch,
+                                    size_t checkpoint, size_t stream_size, unsigned trial,
+                                    const HyperLogLog& hll, size_t prefix_size,
+                                    uint64_t exact) const {
+    const size_t estimator_count = grid.estimators.size();
+    const size_t checkpoints = grid.percentages.size();
+    for (size_t e = 0; e < estimator_count; ++e) {
+        TrialRecord& record = records[(sketch * estimator_count + e) * checkpoints + checkpoint];
+        record.stream_size = stream_size;
+        record.trial = trial;
+        record.b = hll.getB();
+        record.kind = hll.getHashKind();
+        record.estimator = grid.estimators[e];
+        record.percentage = grid.percentages[checkpoint];
+        record.prefix_size = prefix_size;
+        record.exact = exact;
+        record.estimate = hll.estimate(grid.estimators[e]);
+    }
+}
+
+std::vector<SummaryRow> ExperimentRunner::run(unsigned threads, const TrialCallback& on_trial) const {
+    const size_t total = grid.trialCount();
+    const size_t per_trial = grid.recordsPerTrial();
+
+    // Строки сводки в том же порядке, что записи испытания, по блоку на длину
+    std::vector<SummaryRow> summary;
+    summary.reserve(grid.stream_sizes.size() * per_trial);
+    for (size_t stream_size : grid.stream_sizes) {
+        for (uint8_t b : grid.precisions) {
+            for (HashKind kind : grid.hashes) {
+                for (Estimator estimator : grid.estimators) {
+                    for (double pct : grid.percentages) {
+                        SummaryRow row{};
+                        row.stream_size = stream_size;
+                        row.b = b;
+                        row.kind = kind;
+                        row.estimator = estimator;
+                        row.percentage = pct;
+                        summary.push_back(row);
+                    }
+                }
+            }
+        }
+    }
+
+    struct Slot {
+        std::vector<TrialRecord> records;
+        std::exception_ptr error;
+        bool done = false;
+    };
+    std::vector<Slot> slots(total);
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::atomic<bool> cancelled{false};
+    std::exception_ptr first_error;
+
+    {
+        WorkStealingPool pool(threads);
+        for (size_t index = 0; index < total; ++index) {
+            pool.submit([&, index] {
+                Slot result;
+                if (!cancelled.load(std::memory_order_relaxed)) {
+                    try {
+                        result.records = runTrial(index);
+                    } catch (...) {
+                        result.error = std::current_exception();
+                    }
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    slots[index] = std::move(result);
+                    slots[index].done = true;
+                }
+                ready.notify_one();
+            });
+        }
+
+        // Сбор в порядке номеров испытаний
+        for (size_t next = 0; next < total && !first_error; ++next) {
+            std::vector<TrialRecord> records;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait(lock, [&] { return slots[next].done; });
+                if (slots[next].error) {
+                    first_error = slots[next].error;
+                    cancelled = true;
+                    break;
+                }
+                records = std::move(slots[next].records);
+            }
+            SummaryRow* block = summary.data() + (next / grid.trials) * per_trial;
+            for (size_t r = 0; r < per_trial; ++r) {
+                block[r].exact.add(static_cast<double>(records[r].exact));
+                block[r].estimate.add(static_cast<double>(records[r].estimate));
+                block[r].error.add(records[r].relativeError());
+            }
+            if (on_trial) {
+                try {
+                    on_trial(records);
+                } catch (...) {
+                    first_error = std::current_exception();
+                    cancelled = true;
+                }
+            }
+        }
+    }
+    if (first_error) {
+        std::rethrow_exception(first_error);
+    }
+    return summary;
+}
@@ -0,0 +1,163 @@
+#ifndef EXPERIMENTRUNNER_H
+#define EXPERIMENTRUNNER_H
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include "HyperLogLog.h"
+#include "Estimators.h"
+
+// Источник потока испытания
+enum class StreamSource : uint8_t {
+    Strings = 0,    // Строки RandomStreamGen, точное значение - DistinctCounter
+    Synthetic = 1   // Хеши SyntheticHashes: без строк и множества, точное
+                    // значение - длина префикса; для 10^8..10^9 ключей
+};
+
+// Сетка эксперимента Монте-Карло: все сочетания B, хеша и оценщика на
+// trials потоках каждой длины, с контрольными точками на долях потока.
+// По умолчанию - параметры test_stage2 (B = 14, Murmur3_32, 10 потоков
+// по 10^6 строк с seed 1000 + 100 * trial, точки 10..100%)
+struct ExperimentGrid {
+    std::vector<uint8_t> precisions = {14};
+    std::vector<HashKind> hashes = {HashKind::Murmur3_32};
+    std::vector<Estimator> estimators = {Estimator::Classic};
+    std::vector<size_t> stream_sizes = {1000000};
+    std::vector<double> percentages = {10, 20, 30, 40, 50, 60, 70, 80, 90, 100};
+    unsigned trials = 10;
+    uint32_t stream_seed = 1000;  // Поток trial: RandomStreamGen(size, stream_seed + 100 * trial)
+    uint32_t hash_seed = 42;
+    StreamSource source = StreamSource::Strings;
+
+    // Установка параметра по имени из командной строки или файла:
+    //   b          = 10,12,14 или диапазон 8..16
+    //   hash       = murmur3_32,murmur3_128,xxh64,wyhash,crc32c
+    //   estimator  = classic,improved,ml,hllpp
+    //   size       = 100000,1000000 (или 1e9)
+    //   source     = strings или synthetic
+    //   checkpoints = 10,20,...,100 (проценты)
+    //   trials, stream_seed, hash_seed - числа
+    // Неизвестное имя или значение - std::invalid_argument
+    void set(const std::string& key, const std::string& value);
+
+    // Строка "ключ=значение" (пробелы вокруг '=' допускаются)
+    void setFromString(const std::string& assignment);
+
+    // Файл со строками "ключ = значение"; пустые строки и '#' - комментарии.
+    // Ошибка открытия - std::runtime_error
+    void loadFile(const std::string& path);
+
+    // Проверка сочетаний (B в допустимых пределах для каждого хеша,
+    // непустые списки); иначе std::invalid_argument
+    void validate() const;
+
+    // Количество независимых испытаний (потоков) и строк результата на испытание
+    size_t trialCount() const { return stream_sizes.size() * trials; }
+    size_t recordsPerTrial() const {
+        return precisions.size() * hashes.size() * estimators.size() * percentages.size();
+    }
+};
+
+// Оценка одного сочетания параметров в контрольной точке одного потока
+struct TrialRecord {
+    size_t stream_size;
+    unsigned trial;
+    uint8_t b;
+    HashKind kind;
+    Estimator estimator;
+    double percentage;
+    size_t prefix_size;
+    uint64_t exact;
+    uint64_t estimate;
+
+    // (оценка - точное) / точное, со знаком
+    double relativeError() const {
+        return exact == 0 ? 0.0 : (static_cast<double>(estimate) - exact) / exact;
+    }
+};
+
+// Среднее и дисперсия в один проход (алгоритм Уэлфорда): устойчив к
+// потере точности, в отличие от суммы квадратов
+class RunningStats {
+public:
+    void add(double x) {
+        ++n;
+        const double delta = x - running_mean;
+        running_mean += delta / n;
+        m2 += delta * (x - running_mean);
+    }
+
+    size_t count() const { return n; }
+    double mean() const { return running_mean; }
+
+    // Дисперсия генеральной совокупности (делитель n, как в test_stage2)
+    double variance() const { return n ? m2 / n : 0.0; }
+    double stddev() const;
+
+    // Корень из среднего квадрата: sqrt(mean^2 + variance)
+    double rootMeanSquare() const;
+
+private:
+    size_t n = 0;
+    double running_mean = 0.0;
+    double m2 = 0.0;
+};
+
+// Сводка по всем испытаниям одного сочетания в одной контрольной точке
+struct SummaryRow {
+    size_t stream_size;
+    uint8_t b;
+    HashKind kind;
+    Estimator estimator;
+    double percentage;
+    RunningStats exact;
+    RunningStats estimate;
+    RunningStats error;   // Относительная ошибка со знаком; RMSE - error.rootMeanSquare()
+};
+
+// Запуск сетки на пуле с перехватом задач. Задача - один поток (длина,
+// номер испытания): строки генерируются один раз, точное количество на
+// контрольных точках считается один раз, затем строятся скетчи для всех
+// B и хешей и снимаются оценки всеми оценщиками. С source = synthetic
+// строк и точного подсчета нет (см. runSyntheticTrial).
+// Результаты испытаний собираются в вызывающем потоке в порядке номеров
+// испытаний (готовые раньше ждут предыдущих): статистика Уэлфорда
+// накапливается в одном и том же порядке, поэтому сводка и вывод
+// on_trial совпадают бит в бит при любом числе потоков
+class ExperimentRunner {
+public:
+    // Вызывается для каждого испытания в порядке номеров, как только
+    // готовы оно и все предыдущие
+    using TrialCallback = std::function<void(const std::vector<TrialRecord>&)>;
+
+    explicit ExperimentRunner(ExperimentGrid grid);
+
+    // threads = 0 - все ядра. Сводка упорядочена по (длина, B, хеш,
+    // оценщик, процент) в порядке сетки. Исключение испытания
+    // пробрасывается после завершения начатых задач
+    std::vector<SummaryRow> run(unsigned threads = 0, const TrialCallback& on_trial = {}) const;
+
+    // Одно испытание (номер index в порядке (длина, trial))
+    std::vector<TrialRecord> runTrial(size_t index) const;
+
+    const ExperimentGrid& getGrid() const { return grid; }
+
+private:
+    ExperimentGrid grid;
+
+    // Испытание на синтетических хешах: хеши генерируются частями и
+    // добавляются через addHashBatch сразу во все скетчи испытания
+    // (32-битные получают старшие половины тех же значений). Хеши зависят
+    // от stream_seed, trial и hash_seed, но не от вида хеша: хеши одной
+    // ширины дают одинаковые результаты
+    std::vector<TrialRecord> runSyntheticTrial(size_t stream_size, unsigned trial) const;
+
+    // Запись результата в records по порядку (скетч, оценщик, точка)
+    void storeRecords(std::vector<TrialRecord>& records, size_t sketch, size_t checkpoint,
+                      size_t stream_size, unsigned trial, const HyperLogLog& hll,
+                      size_t prefix_size, uint64_t exact) const;
+};
+
+#endif // EXPERIMENTRUNNER_H
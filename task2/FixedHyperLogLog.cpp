@@ -0,0 +1,202 @@
+#include "FixedHyperLogLog.h"
+#include "SketchIO.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+constexpr size_t BATCH_CHUNK = 1024;
+
+inline int countLeadingZeros(uint32_t w) {
+    return __builtin_clz(w);
+}
+
+inline int countLeadingZeros(uint64_t w) {
+    return __builtin_clzll(w);
+}
+
+// Обновление регистров по готовым хешам: сдвиг индекса и стоп-бит ранга -
+// константы FixedHyperLogLog<B, Kind>
+template <uint8_t B, HashKind Kind, typename Hash = typename FixedHyperLogLog<B, Kind>::Hash>
+__attribute__((always_inline))
+inline void updateFixedImpl(uint8_t* registers, double& harmonic_sum, size_t& zero_count,
+                            const Hash* hashes, size_t count) {
+    using Sketch = FixedHyperLogLog<B, Kind>;
+    double sum = harmonic_sum;
+    size_t zeros = zero_count;
+    for (size_t i = 0; i < count; ++i) {
+        const size_t j = hashes[i] >> Sketch::INDEX_SHIFT;
+        const uint8_t rank = static_cast<uint8_t>(
+            countLeadingZeros(static_cast<Hash>((hashes[i] << B) | Sketch::RANK_STOP)) + 1);
+        const uint8_t old = registers[j];
+        if (rank > old) {
+            registers[j] = rank;
+            sum += INV_POW2[rank] - INV_POW2[old];
+            zeros -= (old == 0);
+        }
+    }
+    harmonic_sum = sum;
+    zero_count = zeros;
+}
+
+template <uint8_t B, HashKind Kind, typename Hash = typename FixedHyperLogLog<B, Kind>::Hash>
+__attribute__((target("lzcnt")))
+void updateFixedLzcnt(uint8_t* registers, double& harmonic_sum, size_t& zero_count,
+                      const Hash* hashes, size_t count) {
+    updateFixedImpl<B, Kind>(registers, harmonic_sum, zero_count, hashes, count);
+}
+
+template <uint8_t B, HashKind Kind, typename Hash = typename FixedHyperLogLog<B, Kind>::Hash>
+void updateFixedScalar(uint8_t* registers, double& harmonic_sum, size_t& zero_count,
+                       const Hash* hashes, size_t count) {
+    updateFixedImpl<B, Kind>(registers, harmonic_sum, zero_count, hashes, count);
+}
+
+template <uint8_t B, HashKind Kind, typename Hash = typename FixedHyperLogLog<B, Kind>::Hash>
+void updateFixed(uint8_t* registers, double& harmonic_sum, size_t& zero_count,
+                 const Hash* hashes, size_t count) {
+    static const bool has_lzcnt = __builtin_cpu_supports("lzcnt");
+    if (has_lzcnt) {
+        updateFixedLzcnt<B, Kind>(registers, harmonic_sum, zero_count, hashes, count);
+    } else {
+        updateFixedScalar<B, Kind>(registers, harmonic_sum, zero_count, hashes, count);
+    }
+}
+
+} // namespace
+
+template <uint8_t B, HashKind Kind>
+FixedHyperLogLog<B, Kind>::FixedHyperLogLog(uint32_t seed)
+    : registers(M, 0),
+      hasher(seed),
+      harmonic_sum(static_cast<double>(M)),
+      zero_count(M) {
+}
+
+template <uint8_t B, HashKind Kind>
+void FixedHyperLogLog<B, Kind>::insertHash(Hash hash) {
+    updateFixedImpl<B, Kind>(registers.data(), harmonic_sum, zero_count, &hash, 1);
+}
+
+template <uint8_t B, HashKind Kind>
+void FixedHyperLogLog<B, Kind>::add(std::string_view item) {
+    insertHash(HashPolicy<Kind>::hash(item.data(), item.size(), hasher.getSeed()));
+}
+
+template <uint8_t B, HashKind Kind>
+void FixedHyperLogLog<B, Kind>::add(const void* data, size_t length) {
+    add(std::string_view(static_cast<const char*>(data), length));
+}
+
+template <uint8_t B, HashKind Kind>
+void FixedHyperLogLog<B, Kind>::add(uint64_t key) {
+    insertHash(HashPolicy<Kind>::hash(key, hasher.getSeed()));
+}
+
+template <uint8_t B, HashKind Kind>
+template <typename Key>
+void FixedHyperLogLog<B, Kind>::addBatchImpl(const Key* items, size_t count) {
+    Hash hashes[BATCH_CHUNK];
+    for (size_t offset = 0; offset < count; offset += BATCH_CHUNK) {
+        const size_t n = std::min(BATCH_CHUNK, count - offset);
+        if constexpr (hashBits(Kind) == 64) {
+            hasher.hashBatch64(items + offset, n, hashes, Kind);
+        } else {
+            hasher.hashBatch(items + offset, n, hashes);
+        }
+        updateFixed<B, Kind>(registers.data(), harmonic_sum, zero_count, hashes, n);
+    }
+}
+
+template <uint8_t B, HashKind Kind>
+void FixedHyperLogLog<B, Kind>::addBatch(const std::string* items, size_t count) {
+    addBatchImpl(items, count);
+}
+
+template <uint8_t B, HashKind Kind>
+void FixedHyperLogLog<B, Kind>::addBatch(const std::string_view* items, size_t count) {
+    addBatchImpl(items, count);
+}
+
+template <uint8_t B, HashKind Kind>
+void FixedHyperLogLog<B, Kind>::addBatch(const uint64_t* keys, size_t count) {
+    addBatchImpl(keys, count);
+}
+
+template <uint8_t B, HashKind Kind>
+uint64_t FixedHyperLogLog<B, Kind>::estimate() const {
+    return estimateFromSums(M, ALPHA, harmonic_sum, zero_count, Kind);
+}
+
+template <uint8_t B, HashKind Kind>
+uint64_t FixedHyperLogLog<B, Kind>::estimate(Estimator estimator) const {
+    return estimateFromHistogram(registerHistogram(), B, Kind, estimator);
+}
+
+template <uint8_t B, HashKind Kind>
+RegisterHistogram FixedHyperLogLog<B, Kind>::registerHistogram() const {
+    RegisterHistogram histogram{};
+    for (uint8_t value : registers) {
+        ++histogram[value];
+    }
+    return histogram;
+}
+
+template <uint8_t B, HashKind Kind>
+void FixedHyperLogLog<B, Kind>::merge(const FixedHyperLogLog& other) {
+    if (getSeed() != other.getSeed()) {
+        throw std::invalid_argument("Cannot merge HyperLogLog sketches with different seeds");
+    }
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (size_t j = 0; j < M; ++j) {
+        registers[j] = std::max(registers[j], other.registers[j]);
+        sum += INV_POW2[registers[j]];
+        zeros += registers[j] == 0;
+    }
+    harmonic_sum = sum;
+    zero_count = zeros;
+}
+
+template <uint8_t B, HashKind Kind>
+void FixedHyperLogLog<B, Kind>::serialize(std::vector<uint8_t>& out) const {
+    SketchHeader header{};
+    header.b = B;
+    header.hash_kind = static_cast<uint8_t>(Kind);
+    header.encoding = static_cast<uint8_t>(RegisterEncoding::Byte);
+    header.seed = getSeed();
+    header.entry_count = static_cast<uint32_t>(M);
+    appendSketchRecord(out, header, M, [this](uint8_t* payload) {
+        std::copy(registers.begin(), registers.end(), payload);
+    });
+}
+
+template <uint8_t B, HashKind Kind>
+HyperLogLog FixedHyperLogLog<B, Kind>::toDynamic() const {
+    std::vector<uint8_t> record;
+    serialize(record);
+    return HyperLogLog::deserialize(record.data(), record.size());
+}
+
+template <uint8_t B, HashKind Kind>
+void FixedHyperLogLog<B, Kind>::clear() {
+    std::fill(registers.begin(), registers.end(), 0);
+    harmonic_sum = static_cast<double>(M);
+    zero_count = M;
+}
+
+#define HLL_INSTANTIATE_FIXED(b, KIND) template class FixedHyperLogLog<b, KIND>;
+HLL_FIXED_PRECISIONS(HLL_INSTANTIATE_FIXED, HashKind::Murmur3_32)
+HLL_FIXED_PRECISIONS(HLL_INSTANTIATE_FIXED, HashKind::Murmur3_128)
+HLL_INSTANTIATE_FIXED(17, HashKind::Murmur3_128)
+HLL_INSTANTIATE_FIXED(18, HashKind::Murmur3_128)
+HLL_FIXED_PRECISIONS(HLL_INSTANTIATE_FIXED, HashKind::XXH64)
+HLL_INSTANTIATE_FIXED(17, HashKind::XXH64)
+HLL_INSTANTIATE_FIXED(18, HashKind::XXH64)
+HLL_FIXED_PRECISIONS(HLL_INSTANTIATE_FIXED, HashKind::WyHash)
+HLL_INSTANTIATE_FIXED(17, HashKind::WyHash)
+HLL_INSTANTIATE_FIXED(18, HashKind::WyHash)
+HLL_FIXED_PRECISIONS(HLL_INSTANTIATE_FIXED, HashKind::Crc32c)
+HLL_INSTANTIATE_FIXED(17, HashKind::Crc32c)
+HLL_INSTANTIATE_FIXED(18, HashKind::Crc32c)
+#undef HLL_INSTANTIATE_FIXED
@@ -0,0 +1,101 @@
+#ifndef FIXEDHYPERLOGLOG_H
+#define FIXEDHYPERLOGLOG_H
+
+#include <vector>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "HashFuncGen.h"
+#include "HashPolicies.h"
+#include "HyperLogLog.h"
+
+// HyperLogLog с B и семейством хеша, известными при компиляции.
+// m, маски, сдвиги и alpha_m - константы, поэтому add() компилируется в
+// хеширование и несколько инструкций без ветвлений по параметрам; ранг
+// считается одним clz по хешу со сдвинутым индексом и стоп-битом.
+// Байт на регистр, только плотное представление. Регистры и оценка
+// совпадают с HyperLogLog(B, seed, Kind); для B, выбираемого во время
+// работы, остается HyperLogLog.
+// Экземпляры: B = 4..16 для Murmur3_32 и 4..18 для 64-битных хешей.
+// Хеш вызывается через HashPolicy<Kind> без ветвлений по виду хеша
+template <uint8_t B, HashKind Kind = HashKind::Murmur3_32>
+class FixedHyperLogLog {
+    static_assert(B >= MIN_PRECISION && B <= maxPrecision(Kind),
+                  "B must be between 4 and 16 (18 with a 64-bit hash)");
+
+public:
+    using Hash = typename HashPolicy<Kind>::Result;
+
+    static constexpr size_t M = size_t(1) << B;
+    static constexpr int HASH_BITS = sizeof(Hash) * 8;
+    static constexpr int INDEX_SHIFT = HASH_BITS - B;
+    // Стоп-бит после сдвига индекса: ранг не превосходит HASH_BITS - B + 1
+    static constexpr Hash RANK_STOP = Hash(1) << (B - 1);
+    static constexpr double ALPHA = M == 16 ? 0.673 : M == 32 ? 0.697 : M == 64 ? 0.709
+                                                    : 0.7213 / (1.0 + 1.079 / M);
+
+private:
+    std::vector<uint8_t> registers;
+    HashFuncGen hasher;
+    double harmonic_sum;
+    size_t zero_count;
+
+    void insertHash(Hash hash);
+
+    template <typename Key>
+    void addBatchImpl(const Key* items, size_t count);
+
+public:
+    explicit FixedHyperLogLog(uint32_t seed = 42);
+
+    void add(std::string_view item);
+    void add(const void* data, size_t length);
+    void add(uint64_t key);
+
+    void addBatch(const std::string* items, size_t count);
+    void addBatch(const std::string_view* items, size_t count);
+    void addBatch(const uint64_t* keys, size_t count);
+
+    uint64_t estimate() const;
+    uint64_t estimate(Estimator estimator) const;
+    RegisterHistogram registerHistogram() const;
+
+    // Объединение со скетчем тех же параметров (проверяется только seed)
+    void merge(const FixedHyperLogLog& other);
+
+    // Сериализация в формат SketchIO.h (байтовая раскладка): запись
+    // читается HyperLogLog::deserialize и HyperLogLogView
+    void serialize(std::vector<uint8_t>& out) const;
+
+    // Копия в HyperLogLog с параметрами, заданными во время работы
+    HyperLogLog toDynamic() const;
+
+    void clear();
+
+    const std::vector<uint8_t>& getRegisters() const { return registers; }
+    uint32_t getSeed() const { return hasher.getSeed(); }
+
+    size_t memoryBytes() const { return sizeof(*this) + registers.capacity(); }
+};
+
+#define HLL_FIXED_PRECISIONS(X, KIND) \
+    X(4, KIND) X(5, KIND) X(6, KIND) X(7, KIND) X(8, KIND) X(9, KIND) X(10, KIND) \
+    X(11, KIND) X(12, KIND) X(13, KIND) X(14, KIND) X(15, KIND) X(16, KIND)
+
+#define HLL_EXTERN_FIXED(b, KIND) extern template class FixedHyperLogLog<b, KIND>;
+HLL_FIXED_PRECISIONS(HLL_EXTERN_FIXED, HashKind::Murmur3_32)
+HLL_FIXED_PRECISIONS(HLL_EXTERN_FIXED, HashKind::Murmur3_128)
+HLL_EXTERN_FIXED(17, HashKind::Murmur3_128)
+HLL_EXTERN_FIXED(18, HashKind::Murmur3_128)
+HLL_FIXED_PRECISIONS(HLL_EXTERN_FIXED, HashKind::XXH64)
+HLL_EXTERN_FIXED(17, HashKind::XXH64)
+HLL_EXTERN_FIXED(18, HashKind::XXH64)
+HLL_FIXED_PRECISIONS(HLL_EXTERN_FIXED, HashKind::WyHash)
+HLL_EXTERN_FIXED(17, HashKind::WyHash)
+HLL_EXTERN_FIXED(18, HashKind::WyHash)
+HLL_FIXED_PRECISIONS(HLL_EXTERN_FIXED, HashKind::Crc32c)
+HLL_EXTERN_FIXED(17, HashKind::Crc32c)
+HLL_EXTERN_FIXED(18, HashKind::Crc32c)
+#undef HLL_EXTERN_FIXED
+
+#endif // FIXEDHYPERLOGLOG_H
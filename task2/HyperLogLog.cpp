@@ -1,20 +1,190 @@
 #include "HyperLogLog.h"
-#include <unordered_set>
+#include "SketchIO.h"
+#include "DistinctCounter.h"
+#include "Metrics.h"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <array>
+#include <stdexcept>
+#include <iterator>
 
-HyperLogLog::HyperLogLog(uint8_t b, uint32_t seed) 
+namespace {
+
+// Количество хешей, обрабатываемых addBatch за один проход
+constexpr size_t BATCH_CHUNK = 1024;
+
+__attribute__((always_inline))
+inline int countLeadingZeros(uint32_t w) {
+    return w ? __builtin_clz(w) : 32;
+}
+
+__attribute__((always_inline))
+inline int countLeadingZeros(uint64_t w) {
+    return w ? __builtin_clzll(w) : 64;
+}
+
+// Обновление регистров по готовым хешам вместе с суммой 2^(-M[j])
+// и числом нулевых регистров.
+// Для w = hash & mask ранг равен clz(w) - B + 1, при w = 0 получаем
+// (32 или 64) - B + 1, что совпадает с leadingZeros()/leadingZeros64()
+template <typename Registers, typename Hash>
+__attribute__((always_inline))
+inline void updateRegistersImpl(Registers& registers, double& harmonic_sum,
+                                size_t& zero_count, const Hash* hashes,
+                                size_t count, uint8_t B) {
+    constexpr int BITS = sizeof(Hash) * 8;
+    const Hash mask = (Hash(1) << (BITS - B)) - 1;
+    double sum = harmonic_sum;
+    size_t zeros = zero_count;
+    HLL_METRIC_ONLY(size_t raises = 0;)
+    
+    for (size_t i = 0; i < count; ++i) {
+        size_t j = hashes[i] >> (BITS - B);
+        uint8_t rank = static_cast<uint8_t>(countLeadingZeros(hashes[i] & mask) - B + 1);
+        uint8_t old = registers.get(j);
+        if (rank > old) {
+            uint8_t now = registers.set(j, rank);
+            sum += INV_POW2[now] - INV_POW2[old];
+            zeros -= (old == 0);
+            HLL_METRIC_ONLY(++raises;)
+        }
+    }
+    
+    harmonic_sum = sum;
+    zero_count = zeros;
+    HLL_METRIC_ADD(RegisterRaises, raises);
+}
+
+// С target("lzcnt") выражение для ранга компилируется в одну инструкцию lzcnt
+template <typename Registers, typename Hash>
+__attribute__((target("lzcnt")))
+void updateRegistersLzcnt(Registers& registers, double& harmonic_sum, size_t& zero_count,
+                          const Hash* hashes, size_t count, uint8_t B) {
+    updateRegistersImpl(registers, harmonic_sum, zero_count, hashes, count, B);
+}
+
+template <typename Registers, typename Hash>
+void updateRegistersScalar(Registers& registers, double& harmonic_sum, size_t& zero_count,
+                           const Hash* hashes, size_t count, uint8_t B) {
+    updateRegistersImpl(registers, harmonic_sum, zero_count, hashes, count, B);
+}
+
+template <typename Registers, typename Hash>
+void updateRegisters(Registers& registers, double& harmonic_sum, size_t& zero_count,
+                     const Hash* hashes, size_t count, uint8_t B) {
+    static const bool has_lzcnt = __builtin_cpu_supports("lzcnt");
+    if (has_lzcnt) {
+        updateRegistersLzcnt(registers, harmonic_sum, zero_count, hashes, count, B);
+    } else {
+        updateRegistersScalar(registers, harmonic_sum, zero_count, hashes, count, B);
+    }
+}
+
+// Запись разреженного представления для хеша: (index' << 6) | rank',
+// index' - старшие p бит, rank' - ранг оставшихся бит (не больше 64 - p + 1)
+template <typename Hash>
+inline uint32_t sparseEntry(Hash hash, uint8_t p) {
+    constexpr int BITS = sizeof(Hash) * 8;
+    const uint32_t index = static_cast<uint32_t>(hash >> (BITS - p));
+    const Hash w = hash & ((Hash(1) << (BITS - p)) - 1);
+    const uint32_t rank = static_cast<uint32_t>(countLeadingZeros(w) - p + 1);
+    return (index << 6) | rank;
+}
+
+// Перевод записи в номер плотного регистра и ранг.
+// Первые p - B бит после индекса регистра входят в index'; если среди них
+// есть единица, ранг определяется ими, иначе он продолжается в rank'
+inline void sparseToDense(uint32_t entry, uint8_t p, uint8_t B,
+                          size_t& j, uint8_t& rank) {
+    const uint32_t index = entry >> 6;
+    const int extra = p - B;
+    const uint32_t tail = index & ((1U << extra) - 1);
+    j = index >> extra;
+    rank = static_cast<uint8_t>(tail ? __builtin_clz(tail) - (32 - extra) + 1
+                                     : extra + (entry & 63));
+}
+
+inline void appendVarint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// Вызов fn(entry) для каждой записи списка varint-разностей [data, data + size).
+// Обрывающаяся последняя запись (поврежденные данные) пропускается, тогда
+// результат - false
+template <typename Fn>
+inline bool forEachSparseEntry(const uint8_t* data, size_t size, Fn fn) {
+    uint32_t current = 0;
+    size_t pos = 0;
+    while (pos < size) {
+        uint32_t delta = 0;
+        int shift = 0;
+        uint8_t byte;
+        do {
+            if (pos == size || shift > 28) {
+                return false;
+            }
+            byte = data[pos++];
+            delta |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        current += delta;
+        fn(current);
+    }
+    return true;
+}
+
+// Декодирование списка varint-разностей в абсолютные значения записей
+inline void decodeSparseList(const std::vector<uint8_t>& list, std::vector<uint32_t>& out) {
+    forEachSparseEntry(list.data(), list.size(), [&out](uint32_t entry) {
+        out.push_back(entry);
+    });
+}
+
+// Кодирование отсортированных записей без повторов индекса разностями в varint
+inline void encodeSparseList(const std::vector<uint32_t>& entries, std::vector<uint8_t>& out) {
+    uint32_t previous = 0;
+    for (uint32_t entry : entries) {
+        appendVarint(out, entry - previous);
+        previous = entry;
+    }
+}
+
+} // namespace
+
+double alphaFor(size_t m) {
+    switch (m) {
+        case 16:    return 0.673;
+        case 32:    return 0.697;
+        case 64:    return 0.709;
+        default:    return 0.7213 / (1.0 + 1.079 / m);
+    }
+}
+
+template <typename Registers>
+BasicHyperLogLog<Registers>::BasicHyperLogLog(uint8_t b, uint32_t seed, HashKind kind,
+                                              Representation representation) 
     : B(b), 
       m(1ULL << b),  // 2^B
-      registers(m, 0),
-      hasher(seed) {
-    if (B < 4 || B > 16) {
-        throw std::invalid_argument("B must be between 4 and 16");
+      registers(representation == Representation::Sparse ? 0 : m),
+      hasher(seed),
+      kind(kind),
+      harmonic_sum(static_cast<double>(m)),
+      zero_count(m),
+      sparse_mode(representation == Representation::Sparse),
+      representation(representation),
+      sparse_count(0) {
+    if (B < MIN_PRECISION || B > maxPrecision(kind)) {
+        throw std::invalid_argument("B must be between 4 and 16 (18 with a 64-bit hash)");
     }
 }
 
-uint8_t HyperLogLog::leadingZeros(uint32_t hash, uint8_t bits_to_skip) const {
+template <typename Registers>
+uint8_t BasicHyperLogLog<Registers>::leadingZeros(uint32_t hash, uint8_t bits_to_skip) const {
     // Пропускаем первые bits_to_skip бит (они используются для индекса)
     // Оставшиеся биты: 32 - bits_to_skip
     
@@ -25,81 +195,584 @@ uint8_t HyperLogLog::leadingZeros(uint32_t hash, uint8_t bits_to_skip) const {
         return 32 - bits_to_skip + 1;
     }
     
-    // Подсчет ведущих нулей + 1
-    uint8_t leading = 1;
-    uint32_t bit_mask = 1U << (31 - bits_to_skip);
+    // Подсчет ведущих нулей + 1 (старшие bits_to_skip бит w нулевые)
+    return static_cast<uint8_t>(__builtin_clz(w) - bits_to_skip + 1);
+}
+
+template <typename Registers>
+uint8_t BasicHyperLogLog<Registers>::leadingZeros64(uint64_t hash, uint8_t bits_to_skip) const {
+    // Оставшиеся биты: 64 - bits_to_skip
+    uint64_t w = hash & ((1ULL << (64 - bits_to_skip)) - 1);
     
-    while ((w & bit_mask) == 0 && bit_mask > 0) {
-        leading++;
-        bit_mask >>= 1;
+    if (w == 0) {
+        return 64 - bits_to_skip + 1;
     }
     
-    return leading;
+    return static_cast<uint8_t>(__builtin_clzll(w) - bits_to_skip + 1);
 }
 
-double HyperLogLog::alpha_m() const {
-    // Константы коррекции смещения для разных m
-    switch (m) {
-        case 16:    return 0.673;
-        case 32:    return 0.697;
-        case 64:    return 0.709;
-        default:    return 0.7213 / (1.0 + 1.079 / m);
+template <typename Registers>
+void BasicHyperLogLog<Registers>::updateRegister(size_t j, uint8_t rank) {
+    uint8_t old = registers.get(j);
+    if (rank > old) {
+        uint8_t now = registers.set(j, rank);
+        harmonic_sum += INV_POW2[now] - INV_POW2[old];
+        zero_count -= (old == 0);
+        HLL_METRIC_ADD(RegisterRaises, 1);
     }
 }
 
-void HyperLogLog::add(const std::string& item) {
-    // 1. Хешируем элемент
-    uint32_t hash = hasher.hash(item);
+template <typename Registers>
+void BasicHyperLogLog<Registers>::insertHash(uint32_t hash) {
+    if (sparse_mode) {
+        insertSparseEntry(sparseEntry(hash, SPARSE_P));
+        return;
+    }
     
-    // 2. Первые B бит - индекс регистра
+    // 1. Первые B бит - индекс регистра
     uint32_t j = hash >> (32 - B);
     
-    // 3. Оставшиеся (32 - B) бит - для подсчета ведущих нулей
+    // 2. Оставшиеся (32 - B) бит - для подсчета ведущих нулей
     uint8_t w = leadingZeros(hash, B);
     
-    // 4. Обновляем регистр максимальным значением
-    if (w > registers[j]) {
-        registers[j] = w;
+    // 3. Обновляем регистр максимальным значением
+    updateRegister(j, w);
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::insertHash(uint64_t hash) {
+    if (sparse_mode) {
+        insertSparseEntry(sparseEntry(hash, SPARSE_P));
+        return;
+    }
+    uint64_t j = hash >> (64 - B);
+    updateRegister(j, leadingZeros64(hash, B));
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::add(std::string_view item) {
+    HLL_METRIC_TIMER(Add);
+    HLL_METRIC_ADD(AddCalls, 1);
+    if (hashBits(kind) == 64) {
+        insertHash(hasher.hash64(item, kind));
+    } else {
+        insertHash(hasher.hash(item));
+    }
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::add(const void* data, size_t length) {
+    add(std::string_view(static_cast<const char*>(data), length));
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::add(uint64_t key) {
+    HLL_METRIC_TIMER(Add);
+    HLL_METRIC_ADD(AddCalls, 1);
+    if (hashBits(kind) == 64) {
+        insertHash(hasher.hash64(key, kind));
+    } else {
+        insertHash(hasher.hash(key));
+    }
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::addBatch(const std::string* items, size_t count) {
+    addBatchImpl(items, count);
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::addBatch(const std::string_view* items, size_t count) {
+    addBatchImpl(items, count);
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::addBatch(const uint64_t* keys, size_t count) {
+    addBatchImpl(keys, count);
+}
+
+template <typename Registers>
+template <typename Key>
+void BasicHyperLogLog<Registers>::addBatchImpl(const Key* items, size_t count) {
+    HLL_METRIC_TIMER(AddBatch);
+    HLL_METRIC_ADD(BatchCalls, 1);
+    HLL_METRIC_ADD(BatchItems, count);
+    if (hashBits(kind) == 64) {
+        uint64_t hashes[BATCH_CHUNK];
+        for (size_t offset = 0; offset < count; offset += BATCH_CHUNK) {
+            size_t n = std::min(BATCH_CHUNK, count - offset);
+            hasher.hashBatch64(items + offset, n, hashes, kind);
+            insertHashes(hashes, n);
+        }
+        return;
+    }
+    
+    uint32_t hashes[BATCH_CHUNK];
+    
+    for (size_t offset = 0; offset < count; offset += BATCH_CHUNK) {
+        size_t n = std::min(BATCH_CHUNK, count - offset);
+        hasher.hashBatch(items + offset, n, hashes);
+        insertHashes(hashes, n);
+    }
+}
+
+template <typename Registers>
+template <typename Hash>
+void BasicHyperLogLog<Registers>::insertHashes(const Hash* hashes, size_t count) {
+    size_t i = 0;
+    for (; i < count && sparse_mode; ++i) {
+        insertSparseEntry(sparseEntry(hashes[i], SPARSE_P));
+    }
+    updateRegisters(registers, harmonic_sum, zero_count, hashes + i, count - i, B);
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::checkHashWidth(int bits) const {
+    if (hashBits(kind) != bits) {
+        throw std::invalid_argument("Hash width does not match the sketch hash kind");
+    }
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::addHash(uint32_t hash) {
+    checkHashWidth(32);
+    HLL_METRIC_TIMER(Add);
+    HLL_METRIC_ADD(AddCalls, 1);
+    insertHash(hash);
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::addHash(uint64_t hash) {
+    checkHashWidth(64);
+    HLL_METRIC_TIMER(Add);
+    HLL_METRIC_ADD(AddCalls, 1);
+    insertHash(hash);
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::addHashBatch(const uint32_t* hashes, size_t count) {
+    checkHashWidth(32);
+    HLL_METRIC_TIMER(AddBatch);
+    HLL_METRIC_ADD(BatchCalls, 1);
+    HLL_METRIC_ADD(BatchItems, count);
+    insertHashes(hashes, count);
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::addHashBatch(const uint64_t* hashes, size_t count) {
+    checkHashWidth(64);
+    HLL_METRIC_TIMER(AddBatch);
+    HLL_METRIC_ADD(BatchCalls, 1);
+    HLL_METRIC_ADD(BatchItems, count);
+    insertHashes(hashes, count);
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::addBatch(const std::vector<std::string>& items) {
+    addBatch(items.data(), items.size());
+}
+
+template <typename Registers>
+uint64_t BasicHyperLogLog<Registers>::estimate() const {
+    HLL_METRIC_TIMER(Estimate);
+    HLL_METRIC_ADD(EstimateCalls, 1);
+    // Разреженный режим: линейный счет по 2^SPARSE_P виртуальным регистрам
+    if (sparse_mode) {
+        return estimateSparse(sparse_buffer.empty() ? sparse_count : sparseEntries().size());
+    }
+    
+    // Сумма 2^(-M[j]) и число нулевых регистров поддерживаются
+    // при каждом увеличении регистра, поэтому оценка вычисляется за O(1)
+    return estimateFromSums(m, harmonic_sum, zero_count, kind);
+}
+
+template <typename Registers>
+uint64_t BasicHyperLogLog<Registers>::estimate(Estimator estimator) const {
+    if (sparse_mode) {
+        return estimate();
+    }
+    HLL_METRIC_TIMER(Estimate);
+    HLL_METRIC_ADD(EstimateCalls, 1);
+    return estimateFromHistogram(registerHistogram(), B, kind, estimator);
+}
+
+template <typename Registers>
+RegisterHistogram BasicHyperLogLog<Registers>::registerHistogram() const {
+    if (sparse_mode) {
+        BasicHyperLogLog dense = *this;
+        dense.toDense();
+        return dense.registerHistogram();
+    }
+    RegisterHistogram histogram{};
+    for (size_t j = 0; j < m; ++j) {
+        ++histogram[registers.get(j)];
+    }
+    return histogram;
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::merge(const BasicHyperLogLog& other) {
+    if (B != other.B || kind != other.kind || hasher.getSeed() != other.hasher.getSeed()) {
+        throw std::invalid_argument("Cannot merge HyperLogLog sketches with different B, seed or hash kind");
+    }
+    HLL_METRIC_TIMER(Merge);
+    HLL_METRIC_ADD(Merges, 1);
+    
+    if (other.sparse_mode) {
+        for (uint32_t entry : other.sparseEntries()) {
+            insertSparseEntry(entry);
+        }
+        return;
+    }
+    
+    if (sparse_mode) {
+        toDense();
     }
+    registers.mergeMax(other.registers);
+    recomputeSums();
 }
 
-uint64_t HyperLogLog::estimate() const {
-    // 1. Вычисляем сумму 2^(-M[j])
+template <typename Registers>
+BasicHyperLogLog<Registers>& BasicHyperLogLog<Registers>::operator|=(const BasicHyperLogLog& other) {
+    merge(other);
+    return *this;
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::recomputeSums() {
     double sum = 0.0;
-    int zero_count = 0;
+    size_t zeros = 0;
+    for (size_t j = 0; j < m; ++j) {
+        uint8_t reg = registers.get(j);
+        sum += INV_POW2[reg];
+        zeros += (reg == 0);
+    }
+    harmonic_sum = sum;
+    zero_count = zeros;
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::clear() {
+    harmonic_sum = static_cast<double>(m);
+    zero_count = m;
+    sparse_list = std::vector<uint8_t>();
+    sparse_buffer = std::vector<uint32_t>();
+    sparse_count = 0;
+    
+    if (representation == Representation::Sparse) {
+        registers = Registers(0);
+        sparse_mode = true;
+    } else {
+        registers.clear();
+        sparse_mode = false;
+    }
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::merge(const HyperLogLogView& view) {
+    if (B != view.getB() || kind != view.getHashKind() || hasher.getSeed() != view.getSeed()) {
+        throw std::invalid_argument("Cannot merge HyperLogLog sketches with different B, seed or hash kind");
+    }
+    HLL_METRIC_TIMER(Merge);
+    HLL_METRIC_ADD(Merges, 1);
+    
+    if (view.isSparse()) {
+        forEachSparseEntry(view.data(), view.payloadBytes(), [this](uint32_t entry) {
+            insertSparseEntry(entry);
+        });
+        return;
+    }
+    
+    if (sparse_mode) {
+        toDense();
+    }
+    if (view.getEncoding() == Registers::ENCODING) {
+        registers.mergeMaxRaw(view.data());
+        recomputeSums();
+        return;
+    }
     
+    // Другая раскладка: регистры читаются по одному
     for (size_t j = 0; j < m; ++j) {
-        sum += std::pow(2.0, -static_cast<double>(registers[j]));
-        if (registers[j] == 0) {
-            zero_count++;
+        updateRegister(j, view.get(j));
+    }
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::serialize(std::vector<uint8_t>& out) const {
+    SketchHeader header{};
+    header.b = B;
+    header.hash_kind = static_cast<uint8_t>(kind);
+    header.seed = hasher.getSeed();
+    
+    if (sparse_mode) {
+        // Записи буфера вставки кодируются во временный список
+        std::vector<uint8_t> merged_list;
+        size_t count = sparse_count;
+        if (!sparse_buffer.empty()) {
+            std::vector<uint32_t> entries = sparseEntries();
+            encodeSparseList(entries, merged_list);
+            count = entries.size();
+        }
+        const std::vector<uint8_t>& list = sparse_buffer.empty() ? sparse_list : merged_list;
+        if (list.size() > Registers::bytesFor(m)) {
+            // Список с буфером вставки уже больше регистров: при следующем
+            // слиянии буфера скетч перешел бы в плотный режим
+            BasicHyperLogLog dense = *this;
+            dense.toDense();
+            dense.serialize(out);
+            return;
+        }
+        header.encoding = static_cast<uint8_t>(RegisterEncoding::Sparse);
+        header.entry_count = static_cast<uint32_t>(count);
+        appendSketchRecord(out, header, list.size(), [&list](uint8_t* payload) {
+            std::memcpy(payload, list.data(), list.size());
+        });
+        return;
+    }
+    
+    header.encoding = static_cast<uint8_t>(Registers::ENCODING);
+    header.entry_count = static_cast<uint32_t>(m);
+    appendSketchRecord(out, header, registers.bytes(), [this](uint8_t* payload) {
+        registers.store(payload);
+    });
+}
+
+template <typename Registers>
+std::vector<uint8_t> BasicHyperLogLog<Registers>::serialize() const {
+    std::vector<uint8_t> out;
+    serialize(out);
+    return out;
+}
+
+template <typename Registers>
+BasicHyperLogLog<Registers> BasicHyperLogLog<Registers>::deserialize(const uint8_t* data, size_t size) {
+    return fromView(HyperLogLogView(data, size));
+}
+
+template <typename Registers>
+BasicHyperLogLog<Registers> BasicHyperLogLog<Registers>::fromView(const HyperLogLogView& view) {
+    BasicHyperLogLog sketch(view.getB(), view.getSeed(), view.getHashKind(),
+                            view.isSparse() ? Representation::Sparse : Representation::Dense);
+    
+    if (view.isSparse()) {
+        // Список уже отсортирован и не содержит повторов индекса
+        sketch.sparse_list.assign(view.data(), view.data() + view.payloadBytes());
+        sketch.sparse_count = view.entryCount();
+    } else if (view.getEncoding() == Registers::ENCODING) {
+        sketch.registers.load(view.data());
+        sketch.recomputeSums();
+    } else {
+        sketch.merge(view);
+    }
+    return sketch;
+}
+
+template <typename Registers>
+size_t BasicHyperLogLog<Registers>::sparseBufferLimit() const {
+    // Буфер не превышает 1/16 объема плотных регистров
+    return std::max<size_t>(16, Registers::bytesFor(m) / 16 / sizeof(uint32_t));
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::insertSparseEntry(uint32_t entry) {
+    if (!sparse_mode) {
+        size_t j;
+        uint8_t rank;
+        sparseToDense(entry, SPARSE_P, B, j, rank);
+        updateRegister(j, rank);
+        return;
+    }
+    
+    HLL_METRIC_ADD(SparseInserts, 1);
+    sparse_buffer.push_back(entry);
+    if (sparse_buffer.size() >= sparseBufferLimit()) {
+        flushSparse();
+        if (sparse_list.size() > Registers::bytesFor(m)) {
+            toDense();
+        }
+    }
+}
+
+template <typename Registers>
+std::vector<uint32_t> BasicHyperLogLog<Registers>::sparseEntries() const {
+    std::vector<uint32_t> current;
+    current.reserve(sparse_count + sparse_buffer.size());
+    decodeSparseList(sparse_list, current);
+    if (sparse_buffer.empty()) {
+        return current;
+    }
+    
+    std::vector<uint32_t> buffer = sparse_buffer;
+    std::sort(buffer.begin(), buffer.end());
+    std::vector<uint32_t> merged;
+    merged.reserve(current.size() + buffer.size());
+    std::merge(current.begin(), current.end(), buffer.begin(), buffer.end(),
+               std::back_inserter(merged));
+    
+    // Записи упорядочены по (index', rank'), поэтому для каждого индекса
+    // последняя запись содержит максимальный ранг
+    size_t count = 0;
+    for (size_t i = 0; i < merged.size(); ++i) {
+        if (i + 1 < merged.size() && (merged[i + 1] >> 6) == (merged[i] >> 6)) {
+            continue;
         }
+        merged[count++] = merged[i];
+    }
+    merged.resize(count);
+    return merged;
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::flushSparse() {
+    if (sparse_buffer.empty()) {
+        return;
+    }
+    
+    std::vector<uint32_t> entries = sparseEntries();
+    sparse_list.clear();
+    encodeSparseList(entries, sparse_list);
+    sparse_count = entries.size();
+    sparse_buffer.clear();
+}
+
+template <typename Registers>
+void BasicHyperLogLog<Registers>::toDense() {
+    if (!sparse_mode) {
+        return;
+    }
+    
+    std::vector<uint32_t> entries = sparseEntries();
+    
+    registers = Registers(m);
+    harmonic_sum = static_cast<double>(m);
+    zero_count = m;
+    sparse_mode = false;
+    for (uint32_t entry : entries) {
+        insertSparseEntry(entry);
     }
     
-    // 2. Базовая оценка
-    double estimate = alpha_m() * m * m / sum;
+    sparse_list = std::vector<uint8_t>();
+    sparse_buffer = std::vector<uint32_t>();
+    sparse_count = 0;
+}
+
+template class BasicHyperLogLog<ByteRegisters>;
+template class BasicHyperLogLog<PackedRegisters6>;
+template class BasicHyperLogLog<TailCutRegisters4>;
+
+uint64_t estimateFromSums(size_t m, double harmonic_sum, size_t zero_count, HashKind kind) {
+    return estimateFromSums(m, alphaFor(m), harmonic_sum, zero_count, kind);
+}
+
+uint64_t estimateFromSums(size_t m, double alpha, double harmonic_sum, size_t zero_count,
+                          HashKind kind) {
+    // 1. Базовая оценка
+    double estimate = alpha * m * m / harmonic_sum;
     
-    // 3. Коррекция для малых значений (Small range correction)
+    // 2. Коррекция для малых значений (Small range correction)
     if (estimate <= 2.5 * m) {
         if (zero_count != 0) {
-            estimate = m * std::log(static_cast<double>(m) / zero_count);
+            HLL_METRIC_ADD(EstimateLinearCounting, 1);
+            return static_cast<uint64_t>(m * std::log(static_cast<double>(m) / zero_count));
         }
     }
     
-    // 4. Коррекция для больших значений (Large range correction)
-    // Для 32-битного хеша: 2^32 / 30 ≈ 143,165,576
+    // 3. Коррекция для больших значений (Large range correction)
+    // Для 32-битного хеша: 2^32 / 30 ≈ 143,165,576.
+    // С 64-битным хешем коллизии пренебрежимо редки, коррекция не нужна
     const double pow_32 = 4294967296.0;  // 2^32
-    if (estimate > pow_32 / 30.0) {
-        estimate = -pow_32 * std::log(1.0 - estimate / pow_32);
+    if (kind == HashKind::Murmur3_32 && estimate > pow_32 / 30.0) {
+        HLL_METRIC_ADD(EstimateLargeRange, 1);
+        return static_cast<uint64_t>(-pow_32 * std::log(1.0 - estimate / pow_32));
     }
     
+    HLL_METRIC_ADD(EstimateRaw, 1);
     return static_cast<uint64_t>(estimate);
 }
 
-void HyperLogLog::clear() {
-    std::fill(registers.begin(), registers.end(), 0);
+uint64_t estimateSparse(size_t entry_count) {
+    HLL_METRIC_ADD(EstimateSparse, 1);
+    const double m_sparse = static_cast<double>(1ULL << SPARSE_PRECISION);
+    return static_cast<uint64_t>(m_sparse * std::log(m_sparse / (m_sparse - entry_count)));
+}
+
+template <typename Registers>
+inline void mergeRawIntoBytes(const uint8_t* raw, size_t m, uint8_t* registers) {
+    for (size_t j = 0; j < m; ++j) {
+        registers[j] = std::max(registers[j], Registers::getRaw(raw, m, j));
+    }
+}
+
+void mergeViewIntoBytes(const HyperLogLogView& view, uint8_t* registers) {
+    const size_t m = view.getM();
+    switch (view.getEncoding()) {
+        case RegisterEncoding::Byte:
+            mergeMaxBytes(registers, view.data(), m);
+            break;
+        case RegisterEncoding::Packed6:
+            mergeRawIntoBytes<PackedRegisters6>(view.data(), m, registers);
+            break;
+        case RegisterEncoding::TailCut4:
+            mergeRawIntoBytes<TailCutRegisters4>(view.data(), m, registers);
+            break;
+        default: {
+            const uint8_t B = view.getB();
+            forEachSparseEntry(view.data(), view.payloadBytes(), [registers, B](uint32_t entry) {
+                size_t j;
+                uint8_t rank;
+                sparseToDense(entry, SPARSE_PRECISION, B, j, rank);
+                registers[j] = std::max(registers[j], rank);
+            });
+            break;
+        }
+    }
+}
+
+size_t checkSparseList(const uint8_t* data, size_t size, HashKind kind) {
+    const uint32_t max_rank = static_cast<uint32_t>(hashBits(kind) - SPARSE_PRECISION + 1);
+    size_t count = 0;
+    uint32_t previous = 0;
+    bool valid = forEachSparseEntry(data, size, [&](uint32_t entry) {
+        const uint32_t rank = entry & 63;
+        if ((entry >> 6) >= (1U << SPARSE_PRECISION) || rank == 0 || rank > max_rank ||
+            (count > 0 && (entry >> 6) <= (previous >> 6))) {
+            throw std::invalid_argument("Invalid sparse sketch entry");
+        }
+        previous = entry;
+        ++count;
+    });
+    if (!valid) {
+        throw std::invalid_argument("Sparse sketch list is truncated");
+    }
+    return count;
+}
+
+template <typename Registers>
+void registerSums(const uint8_t* raw, size_t m, double& harmonic_sum, size_t& zero_count) {
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (size_t j = 0; j < m; ++j) {
+        uint8_t value = Registers::getRaw(raw, m, j);
+        sum += INV_POW2[value];
+        zeros += (value == 0);
+    }
+    harmonic_sum = sum;
+    zero_count = zeros;
 }
 
+template void registerSums<ByteRegisters>(const uint8_t*, size_t, double&, size_t&);
+template void registerSums<PackedRegisters6>(const uint8_t*, size_t, double&, size_t&);
+template void registerSums<TailCutRegisters4>(const uint8_t*, size_t, double&, size_t&);
+
 uint64_t exactCount(const std::vector<std::string>& stream) {
-    std::unordered_set<std::string> unique_elements(stream.begin(), stream.end());
+    return exactCount(stream.data(), stream.size());
+}
+
+uint64_t exactCount(const std::string* items, size_t count) {
+    DistinctCounter unique_elements(DistinctCounter::Mode::Verified, count);
+    for (size_t i = 0; i < count; ++i) {
+        unique_elements.insert(items[i]);
+    }
     return unique_elements.size();
 }
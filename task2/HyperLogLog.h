@@ -2,48 +2,267 @@
 #define HYPERLOGLOG_H
 
 #include <vector>
+#include <array>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <cmath>
 #include "HashFuncGen.h"
+#include "RegisterStorage.h"
+#include "Estimators.h"
 
-class HyperLogLog {
+// Начальное представление скетча
+enum class Representation : uint8_t {
+    Dense = 0,   // Все m регистров выделяются сразу
+    Sparse = 1   // Пары (индекс, ранг) до тех пор, пока они компактнее регистров
+};
+
+// Точность разреженного представления: число бит индекса записи
+constexpr uint8_t SPARSE_PRECISION = 25;
+
+// Допустимое количество бит индекса B. С 32-битным хешем не больше 16
+// (на ранг остается не меньше 16 бит), с 64-битным - до 18
+constexpr uint8_t MIN_PRECISION = 4;
+
+constexpr uint8_t maxPrecision(HashKind kind) {
+    return hashBits(kind) == 64 ? 18 : 16;
+}
+
+class HyperLogLogView;
+
+// Таблица 2^(-k) для k = 0..65 (ранг 64-битного хеша не превосходит 65 - B)
+constexpr std::array<double, 66> makeInversePowers() {
+    std::array<double, 66> table{};
+    double value = 1.0;
+    for (size_t k = 0; k < table.size(); ++k) {
+        table[k] = value;
+        value *= 0.5;
+    }
+    return table;
+}
+
+inline constexpr std::array<double, 66> INV_POW2 = makeInversePowers();
+
+// HyperLogLog с настраиваемым хранением регистров (см. RegisterStorage.h):
+//   HyperLogLog        - байт на регистр
+//   PackedHyperLogLog  - 6 бит на регистр
+//   TailCutHyperLogLog - 4 бита на регистр со смещением (приближенная схема)
+template <typename Registers>
+class BasicHyperLogLog {
 private:
     uint8_t B;                      // Количество бит для индекса (регистров)
     size_t m;                       // Количество регистров (2^B)
-    std::vector<uint8_t> registers; // Регистры для хранения максимумов
+    Registers registers;            // Регистры для хранения максимумов
     HashFuncGen hasher;             // Хеш-функция
+    HashKind kind;                  // Разрядность хеша (32 или 64 бита)
+    
+    // Сумма 2^(-M[j]) по всем регистрам и число нулевых регистров.
+    // Обновляются при каждом увеличении регистра. С 32-битным хешем все
+    // слагаемые кратны 2^-29 и сумма не превосходит 2^16, поэтому она
+    // вычисляется в double без округлений
+    double harmonic_sum;
+    size_t zero_count;
+    
+    // Разреженное представление (HyperLogLog++).
+    // Каждый элемент кодируется 32-битной записью (index' << 6) | rank',
+    // где index' - старшие SPARSE_P бит хеша, rank' - ранг оставшихся бит.
+    // Записи хранятся в отсортированном списке без повторов индекса,
+    // закодированном разностями в varint, и в небольшом неотсортированном
+    // буфере вставки. Когда список становится больше плотных регистров,
+    // скетч переходит в плотный режим; получаемые регистры совпадают с
+    // регистрами скетча, который с самого начала был плотным
+    static constexpr uint8_t SPARSE_P = SPARSE_PRECISION;
+    bool sparse_mode;
+    Representation representation;     // Представление после clear()
+    std::vector<uint8_t> sparse_list;  // varint-разности записей
+    std::vector<uint32_t> sparse_buffer;
+    size_t sparse_count;               // Количество записей в sparse_list
     
     // Вспомогательная функция для подсчета ведущих нулей + 1
     uint8_t leadingZeros(uint32_t hash, uint8_t bits_to_skip) const;
     
-    // Константа для коррекции смещения (bias correction)
-    double alpha_m() const;
+    // То же для 64-битного хеша: результат не превосходит 64 - B + 1 <= 61,
+    // поэтому значения регистров укладываются в 6 бит
+    uint8_t leadingZeros64(uint64_t hash, uint8_t bits_to_skip) const;
+    
+    // Запись ранга в регистр j, если он больше текущего значения
+    void updateRegister(size_t j, uint8_t rank);
+    
+    // Пересчет harmonic_sum и zero_count по всем регистрам
+    void recomputeSums();
+    
+    // Добавление записи разреженного представления (в плотном режиме
+    // запись сразу переводится в индекс и ранг регистра)
+    void insertSparseEntry(uint32_t entry);
+    
+    // Отсортированные записи списка и буфера вставки без повторов индекса.
+    // Скетч не изменяется, поэтому константные методы разреженного режима
+    // работают с этой копией
+    std::vector<uint32_t> sparseEntries() const;
+    
+    // Слияние буфера вставки с отсортированным списком
+    void flushSparse();
+    
+    // Максимальный размер буфера вставки
+    size_t sparseBufferLimit() const;
+    
+    // Общая реализация addBatch для строковых и целочисленных ключей
+    template <typename Key>
+    void addBatchImpl(const Key* items, size_t count);
+    
+    // Вставка готового хеша (32- или 64-битного)
+    void insertHash(uint32_t hash);
+    void insertHash(uint64_t hash);
+    
+    // Вставка пакета готовых хешей (разреженные записи, затем регистры)
+    template <typename Hash>
+    void insertHashes(const Hash* hashes, size_t count);
+    
+    // std::invalid_argument, если hashBits(kind) != bits
+    void checkHashWidth(int bits) const;
     
 public:
-    // Конструктор
-    HyperLogLog(uint8_t b = 14, uint32_t seed = 42);
+    // Конструктор. 64-битный хеш (любой HashKind, кроме Murmur3_32):
+    // без коррекции для больших значений, точный до ~10^18 элементов,
+    // B до 18 (см. maxPrecision)
+    // Representation::Sparse хранит небольшие множества компактно и
+    // оценивает их линейным счетом по 2^25 виртуальным регистрам
+    BasicHyperLogLog(uint8_t b = 14, uint32_t seed = 42,
+                     HashKind kind = HashKind::Murmur3_32,
+                     Representation representation = Representation::Dense);
     
     // Добавление элемента в структуру
-    void add(const std::string& item);
+    void add(std::string_view item);
+    void add(const void* data, size_t length);
+    
+    // Добавление целочисленного ключа (хешируется HashFuncGen::hash(uint64_t),
+    // то есть не совпадает с добавлением его байтов)
+    void add(uint64_t key);
+    
+    // Пакетное добавление элементов: ключи хешируются векторным ядром
+    // HashFuncGen::hashBatch, ранги считаются через lzcnt.
+    // Регистры получаются такими же, как после последовательных add()
+    void addBatch(const std::string* items, size_t count);
+    void addBatch(const std::string_view* items, size_t count);
+    void addBatch(const uint64_t* keys, size_t count);
+    void addBatch(const std::vector<std::string>& items);
+    
+    // Добавление готовых значений хеша в обход хеш-функции (моделирование
+    // равномерными псевдослучайными хешами, хеши, посчитанные снаружи).
+    // Индекс регистра и ранг считаются так же, как в add(). Ширина хеша
+    // должна совпадать с hashBits(getHashKind()), иначе std::invalid_argument
+    void addHash(uint32_t hash);
+    void addHash(uint64_t hash);
+    void addHashBatch(const uint32_t* hashes, size_t count);
+    void addHashBatch(const uint64_t* hashes, size_t count);
     
     // Получение оценки количества уникальных элементов
     uint64_t estimate() const;
     
-    // Сброс всех регистров
+    // Оценка выбранным способом (см. Estimators.h) по гистограмме регистров;
+    // Estimator::Classic совпадает с estimate(). В разреженном представлении
+    // все способы дают линейный счет по 2^25 виртуальным регистрам
+    uint64_t estimate(Estimator estimator) const;
+    
+    // Гистограмма значений регистров за один проход без вычисления степеней
+    // (разреженный скетч переводится в плотный во временной копии)
+    RegisterHistogram registerHistogram() const;
+    
+    // Объединение со скетчем other (поэлементный максимум регистров).
+    // Скетчи должны иметь одинаковые B, seed и семейство хеша
+    void merge(const BasicHyperLogLog& other);
+    BasicHyperLogLog& operator|=(const BasicHyperLogLog& other);
+    
+    // Объединение с сериализованным скетчем без копирования его регистров.
+    // Раскладка view может отличаться от Registers
+    void merge(const HyperLogLogView& view);
+    
+    // Сериализация в двоичный формат (см. SketchIO.h). Разреженный скетч
+    // записывается списком, плотный - регистрами в раскладке Registers.
+    // Первый вариант дописывает запись в конец out
+    void serialize(std::vector<uint8_t>& out) const;
+    std::vector<uint8_t> serialize() const;
+    
+    // Восстановление скетча из записи [data, data + size) или из view.
+    // При некорректной записи выбрасывается std::invalid_argument
+    static BasicHyperLogLog deserialize(const uint8_t* data, size_t size);
+    static BasicHyperLogLog fromView(const HyperLogLogView& view);
+    
+    // Сброс всех регистров (скетч возвращается в начальное представление)
     void clear();
     
+    // Принудительный переход в плотное представление
+    void toDense();
+    
+    // Находится ли скетч в разреженном представлении
+    bool isSparse() const { return sparse_mode; }
+    
     // Получение количества регистров
     size_t getM() const { return m; }
     
     // Получение параметра B
     uint8_t getB() const { return B; }
     
-    // Получение состояния регистров (для анализа)
-    const std::vector<uint8_t>& getRegisters() const { return registers; }
+    // Получение семейства хеш-функции
+    HashKind getHashKind() const { return kind; }
+    
+    // Получение seed хеш-функции
+    uint32_t getSeed() const { return hasher.getSeed(); }
+    
+    // Получение состояния регистров (для анализа).
+    // В разреженном представлении регистры не выделены, см. toDense()
+    const Registers& getRegisters() const { return registers; }
+    
+    // Объем памяти, занимаемый скетчем (объект, регистры и разреженные данные)
+    size_t memoryBytes() const {
+        return sizeof(*this) + registers.bytes() + sparse_list.capacity() +
+               sparse_buffer.capacity() * sizeof(uint32_t);
+    }
 };
 
+using HyperLogLog = BasicHyperLogLog<ByteRegisters>;
+using PackedHyperLogLog = BasicHyperLogLog<PackedRegisters6>;
+using TailCutHyperLogLog = BasicHyperLogLog<TailCutRegisters4>;
+
+extern template class BasicHyperLogLog<ByteRegisters>;
+extern template class BasicHyperLogLog<PackedRegisters6>;
+extern template class BasicHyperLogLog<TailCutRegisters4>;
+
+// Константа alpha_m для коррекции смещения (bias correction) оценки
+// alpha_m * m^2 / sum 2^(-M[j])
+double alphaFor(size_t m);
+
+// Оценка по сумме 2^(-M[j]) и числу нулевых регистров (с коррекциями
+// для малых и, при 32-битном хеше, больших значений)
+uint64_t estimateFromSums(size_t m, double harmonic_sum, size_t zero_count, HashKind kind);
+
+// То же с заранее известной alpha_m (FixedHyperLogLog::ALPHA)
+uint64_t estimateFromSums(size_t m, double alpha, double harmonic_sum, size_t zero_count,
+                          HashKind kind);
+
+// Линейный счет по числу записей разреженного представления
+// (2^SPARSE_PRECISION виртуальных регистров)
+uint64_t estimateSparse(size_t entry_count);
+
+// Проверка разреженного списка записи [data, data + size) для хеша kind:
+// индексы строго возрастают и меньше 2^SPARSE_PRECISION, ранги от 1 до
+// hashBits(kind) - SPARSE_PRECISION + 1, последняя запись не оборвана.
+// Возвращает количество записей; при ошибке std::invalid_argument
+size_t checkSparseList(const uint8_t* data, size_t size, HashKind kind);
+
+// Поэлементный максимум регистров записи view (любая раскладка, включая
+// разреженную) с m = view.getM() байтовыми регистрами registers, без
+// копирования записи. Совпадение B, seed и хеша проверяет вызывающий
+void mergeViewIntoBytes(const HyperLogLogView& view, uint8_t* registers);
+
+// Сумма 2^(-M[j]) и число нулевых регистров для m регистров
+// в сериализованной раскладке Registers
+template <typename Registers>
+void registerSums(const uint8_t* raw, size_t m, double& harmonic_sum, size_t& zero_count);
+
 // Функция для точного подсчета уникальных элементов
+// (DistinctCounter в режиме Verified)
 uint64_t exactCount(const std::vector<std::string>& stream);
+uint64_t exactCount(const std::string* items, size_t count);
 
 #endif // HYPERLOGLOG_H
@@ -0,0 +1,286 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+
+namespace {
+
+// Блоки живых потоков и сумма блоков завершившихся потоков
+struct MetricsRegistry {
+    std::mutex mutex;
+    std::vector<ThreadMetrics*> live;
+    MetricsSnapshot retired;
+};
+
+MetricsRegistry& registry() {
+    static MetricsRegistry instance;
+    return instance;
+}
+
+size_t latencyBucket(uint64_t ns) {
+    size_t bucket = 0;
+    while (ns > 1 && bucket + 1 < LATENCY_BUCKETS) {
+        ns >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+// Десятичный вывод чисел с плавающей точкой независимо от флагов,
+// выставленных вызывающим кодом; флаги восстанавливаются при выходе
+class DefaultFloatFormat {
+public:
+    explicit DefaultFloatFormat(std::ostream& out)
+        : out(out), flags(out.flags()), precision(out.precision()) {
+        out << std::defaultfloat << std::noshowpos << std::setprecision(10);
+    }
+    ~DefaultFloatFormat() {
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+private:
+    std::ostream& out;
+    std::ios_base::fmtflags flags;
+    std::streamsize precision;
+};
+
+void writeHelp(std::ostream& out, const std::string& name, const char* type, const char* help) {
+    out << "# HELP " << name << " " << help << "\n";
+    out << "# TYPE " << name << " " << type << "\n";
+}
+
+const char* COUNTER_HELP[METRIC_COUNTERS] = {
+    "Elements added with add() and addHash()",
+    "Calls to addBatch() and addHashBatch()",
+    "Elements added in batch calls",
+    "Register updates that raised a register",
+    "Entries written to the sparse representation",
+    "Calls to estimate()",
+    "Classic estimates that used the raw harmonic mean",
+    "Classic estimates that used linear counting",
+    "Classic estimates that used the 32-bit large-range correction",
+    "Estimates computed from the sparse representation",
+    "Calls to merge()",
+};
+
+} // namespace
+
+ThreadMetrics::ThreadMetrics() {
+    for (auto& c : counters) c.store(0, std::memory_order_relaxed);
+    for (auto& op : latency) {
+        for (auto& c : op) c.store(0, std::memory_order_relaxed);
+    }
+    for (auto& c : latency_sum_ns) c.store(0, std::memory_order_relaxed);
+
+    MetricsRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.live.push_back(this);
+}
+
+ThreadMetrics::~ThreadMetrics() {
+    MetricsRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (size_t i = 0; i < METRIC_COUNTERS; ++i) {
+        reg.retired.counters[i] += counters[i].load(std::memory_order_relaxed);
+    }
+    for (size_t op = 0; op < METRIC_OPS; ++op) {
+        for (size_t k = 0; k < LATENCY_BUCKETS; ++k) {
+            reg.retired.latency[op][k] += latency[op][k].load(std::memory_order_relaxed);
+        }
+        reg.retired.latency_sum_ns[op] += latency_sum_ns[op].load(std::memory_order_relaxed);
+    }
+    reg.live.erase(std::find(reg.live.begin(), reg.live.end(), this));
+}
+
+void ThreadMetrics::recordLatency(MetricOp op, uint64_t ns) {
+    const size_t i = static_cast<size_t>(op);
+    bump(latency[i][latencyBucket(ns)], 1);
+    bump(latency_sum_ns[i], ns);
+}
+
+uint64_t MetricsSnapshot::latencySamples(MetricOp op) const {
+    uint64_t total = 0;
+    for (uint64_t count : latency[static_cast<size_t>(op)]) {
+        total += count;
+    }
+    return total;
+}
+
+ThreadMetrics& Metrics::createLocal() {
+    thread_local ThreadMetrics metrics;
+    return metrics;
+}
+
+MetricsSnapshot Metrics::snapshot() {
+    MetricsRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    MetricsSnapshot result = reg.retired;
+    result.enabled = enabled();
+    for (const ThreadMetrics* thread : reg.live) {
+        for (size_t i = 0; i < METRIC_COUNTERS; ++i) {
+            result.counters[i] += thread->counters[i].load(std::memory_order_relaxed);
+        }
+        for (size_t op = 0; op < METRIC_OPS; ++op) {
+            for (size_t k = 0; k < LATENCY_BUCKETS; ++k) {
+                result.latency[op][k] += thread->latency[op][k].load(std::memory_order_relaxed);
+            }
+            result.latency_sum_ns[op] += thread->latency_sum_ns[op].load(std::memory_order_relaxed);
+        }
+    }
+    return result;
+}
+
+void Metrics::reset() {
+    MetricsRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.retired = MetricsSnapshot();
+    for (ThreadMetrics* thread : reg.live) {
+        for (auto& c : thread->counters) c.store(0, std::memory_order_relaxed);
+        for (auto& op : thread->latency) {
+            for (auto& c : op) c.store(0, std::memory_order_relaxed);
+        }
+        for (auto& c : thread->latency_sum_ns) c.store(0, std::memory_order_relaxed);
+    }
+}
+
+SketchGauges Metrics::sketchGauges(std::string name, const HyperLogLog& sketch) {
+    return SketchGauges{std::move(name), sketch.getB(), sketch.getM(), sketch.isSparse(),
+                        sketch.estimate(), sketch.registerHistogram()};
+}
+
+const char* Metrics::counterName(MetricCounter counter) {
+    switch (counter) {
+        case MetricCounter::AddCalls: return "add";
+        case MetricCounter::BatchCalls: return "batch_calls";
+        case MetricCounter::BatchItems: return "batch_items";
+        case MetricCounter::RegisterRaises: return "register_raises";
+        case MetricCounter::SparseInserts: return "sparse_inserts";
+        case MetricCounter::EstimateCalls: return "estimate";
+        case MetricCounter::EstimateRaw: return "estimate_raw";
+        case MetricCounter::EstimateLinearCounting: return "estimate_linear_counting";
+        case MetricCounter::EstimateLargeRange: return "estimate_large_range";
+        case MetricCounter::EstimateSparse: return "estimate_sparse";
+        case MetricCounter::Merges: return "merge";
+        case MetricCounter::COUNT: break;
+    }
+    return "unknown";
+}
+
+const char* Metrics::opName(MetricOp op) {
+    switch (op) {
+        case MetricOp::Add: return "add";
+        case MetricOp::AddBatch: return "add_batch";
+        case MetricOp::Estimate: return "estimate";
+        case MetricOp::Merge: return "merge";
+        case MetricOp::COUNT: break;
+    }
+    return "unknown";
+}
+
+void Metrics::writePrometheus(std::ostream& out, const MetricsSnapshot& snapshot,
+                              const std::vector<SketchGauges>& sketches) {
+    DefaultFloatFormat format(out);
+    writeHelp(out, "hll_metrics_enabled", "gauge", "1 if built with -DHLL_METRICS");
+    out << "hll_metrics_enabled " << (snapshot.enabled ? 1 : 0) << "\n";
+
+    for (size_t i = 0; i < METRIC_COUNTERS; ++i) {
+        const std::string name = std::string("hll_") + counterName(static_cast<MetricCounter>(i)) + "_total";
+        writeHelp(out, name, "counter", COUNTER_HELP[i]);
+        out << name << " " << snapshot.counters[i] << "\n";
+    }
+
+    // Гистограмма Prometheus накопительная: le - верхняя граница корзины
+    // в секундах; количество и сумма - только по измеренным вызовам
+    writeHelp(out, "hll_operation_latency_seconds", "histogram",
+              "Sampled operation latency (every N-th call per thread, see LATENCY_SAMPLE_PERIOD)");
+    for (size_t op = 0; op < METRIC_OPS; ++op) {
+        const char* label = opName(static_cast<MetricOp>(op));
+        uint64_t cumulative = 0;
+        for (size_t k = 0; k + 1 < LATENCY_BUCKETS; ++k) {
+            cumulative += snapshot.latency[op][k];
+            out << "hll_operation_latency_seconds_bucket{op=\"" << label << "\",le=\""
+                << static_cast<double>(uint64_t(1) << (k + 1)) * 1e-9
+                << "\"} " << cumulative << "\n";
+        }
+        cumulative += snapshot.latency[op][LATENCY_BUCKETS - 1];
+        out << "hll_operation_latency_seconds_bucket{op=\"" << label << "\",le=\"+Inf\"} "
+            << cumulative << "\n";
+        out << "hll_operation_latency_seconds_sum{op=\"" << label << "\"} "
+            << static_cast<double>(snapshot.latency_sum_ns[op]) * 1e-9 << "\n";
+        out << "hll_operation_latency_seconds_count{op=\"" << label << "\"} " << cumulative << "\n";
+    }
+
+    if (sketches.empty()) {
+        return;
+    }
+    writeHelp(out, "hll_sketch_registers", "gauge", "Number of registers m = 2^B");
+    for (const auto& s : sketches) {
+        out << "hll_sketch_registers{sketch=\"" << s.name << "\"} " << s.m << "\n";
+    }
+    writeHelp(out, "hll_sketch_sparse", "gauge", "1 if the sketch is in the sparse representation");
+    for (const auto& s : sketches) {
+        out << "hll_sketch_sparse{sketch=\"" << s.name << "\"} " << (s.sparse ? 1 : 0) << "\n";
+    }
+    writeHelp(out, "hll_sketch_zero_fraction", "gauge", "Fraction of registers equal to zero");
+    for (const auto& s : sketches) {
+        out << "hll_sketch_zero_fraction{sketch=\"" << s.name << "\"} "
+            << s.zeroFraction() << "\n";
+    }
+    writeHelp(out, "hll_sketch_estimate", "gauge", "Current cardinality estimate");
+    for (const auto& s : sketches) {
+        out << "hll_sketch_estimate{sketch=\"" << s.name << "\"} " << s.estimate << "\n";
+    }
+    writeHelp(out, "hll_sketch_register_values", "gauge", "Number of registers holding each value");
+    for (const auto& s : sketches) {
+        for (size_t value = 0; value < s.histogram.size(); ++value) {
+            if (s.histogram[value]) {
+                out << "hll_sketch_register_values{sketch=\"" << s.name << "\",value=\"" << value
+                    << "\"} " << s.histogram[value] << "\n";
+            }
+        }
+    }
+}
+
+void Metrics::writeJson(std::ostream& out, const MetricsSnapshot& snapshot,
+                        const std::vector<SketchGauges>& sketches) {
+    DefaultFloatFormat format(out);
+    out << "{\n  \"enabled\": " << (snapshot.enabled ? "true" : "false") << ",\n  \"counters\": {";
+    for (size_t i = 0; i < METRIC_COUNTERS; ++i) {
+        out << (i ? ", " : "") << "\"" << counterName(static_cast<MetricCounter>(i)) << "\": "
+            << snapshot.counters[i];
+    }
+    out << "},\n  \"latency\": {";
+    for (size_t op = 0; op < METRIC_OPS; ++op) {
+        // Корзины до последней непустой; корзина k - [2^k, 2^(k+1)) нс
+        size_t used = LATENCY_BUCKETS;
+        while (used > 0 && snapshot.latency[op][used - 1] == 0) {
+            --used;
+        }
+        out << (op ? "," : "") << "\n    \"" << opName(static_cast<MetricOp>(op))
+            << "\": {\"sample_period\": " << LATENCY_SAMPLE_PERIOD[op]
+            << ", \"samples\": " << snapshot.latencySamples(static_cast<MetricOp>(op))
+            << ", \"sum_ns\": " << snapshot.latency_sum_ns[op] << ", \"log2_ns_buckets\": [";
+        for (size_t k = 0; k < used; ++k) {
+            out << (k ? ", " : "") << snapshot.latency[op][k];
+        }
+        out << "]}";
+    }
+    out << "\n  },\n  \"sketches\": [";
+    for (size_t i = 0; i < sketches.size(); ++i) {
+        const auto& s = sketches[i];
+        size_t used = s.histogram.size();
+        while (used > 1 && s.histogram[used - 1] == 0) {
+            --used;
+        }
+        out << (i ? "," : "") << "\n    {\"name\": \"" << s.name << "\", \"b\": " << static_cast<int>(s.b)
+            << ", \"m\": " << s.m << ", \"sparse\": " << (s.sparse ? "true" : "false")
+            << ", \"estimate\": " << s.estimate << ", \"zero_fraction\": "
+            << s.zeroFraction() << ", \"register_histogram\": [";
+        for (size_t value = 0; value < used; ++value) {
+            out << (value ? ", " : "") << s.histogram[value];
+        }
+        out << "]}";
+    }
+    out << (sketches.empty() ? "]\n}\n" : "\n  ]\n}\n");
+}
@@ -0,0 +1,197 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "HyperLogLog.h"
+#include "Estimators.h"
+
+// Инструментирование горячего пути HyperLogLog. Включается при сборке
+// флагом -DHLL_METRICS (make METRICS=1); без него макросы HLL_METRIC_*
+// раскрываются в пустые операторы и код скетча не меняется.
+// Счетчики - в блоке каждого потока (запись без атомарных RMW и общих
+// строк кэша), снимок суммирует живые блоки и блоки завершившихся потоков.
+// Время операций измеряется выборочно: каждый LATENCY_SAMPLE_PERIOD-й
+// вызов операции в потоке, гистограмма по степеням двойки наносекунд.
+// Экспорт - текстовый формат Prometheus или JSON по запросу
+
+enum class MetricCounter : uint8_t {
+    AddCalls = 0,             // Элементы, добавленные add() и addHash()
+    BatchCalls,               // Вызовы addBatch() и addHashBatch()
+    BatchItems,               // Элементы в этих вызовах
+    RegisterRaises,           // Обновления, увеличившие регистр
+    SparseInserts,            // Записи в разреженное представление
+    EstimateCalls,            // Вызовы estimate()
+    EstimateRaw,              // Классическая оценка: сырая alpha_m * m^2 / sum
+    EstimateLinearCounting,   //   линейный счет (оценка <= 2.5m и есть нули)
+    EstimateLargeRange,       //   поправка для больших значений 32-битного хеша
+    EstimateSparse,           //   линейный счет разреженного представления
+    Merges,                   // Вызовы merge()
+    COUNT
+};
+
+enum class MetricOp : uint8_t {
+    Add = 0,
+    AddBatch,
+    Estimate,
+    Merge,
+    COUNT
+};
+
+constexpr size_t METRIC_COUNTERS = static_cast<size_t>(MetricCounter::COUNT);
+constexpr size_t METRIC_OPS = static_cast<size_t>(MetricOp::COUNT);
+
+// Корзина k - время в [2^k, 2^(k+1)) нс; последняя - все большее
+constexpr size_t LATENCY_BUCKETS = 40;
+
+// Измеряется каждый N-й вызов: add() дешевле двух чтений часов, пакеты и
+// объединения - крупные операции и измеряются всегда
+constexpr std::array<uint32_t, METRIC_OPS> LATENCY_SAMPLE_PERIOD = {1024, 1, 64, 1};
+
+// Блок счетчиков одного потока. Пишет только поток-владелец (обычные
+// load + store), снимок читает из другого потока (relaxed)
+class ThreadMetrics {
+public:
+    ThreadMetrics();
+    ~ThreadMetrics();
+
+    ThreadMetrics(const ThreadMetrics&) = delete;
+    ThreadMetrics& operator=(const ThreadMetrics&) = delete;
+
+    void add(MetricCounter counter, uint64_t n = 1) {
+        bump(counters[static_cast<size_t>(counter)], n);
+    }
+
+    // Нужно ли измерять текущий вызов операции op
+    bool sample(MetricOp op) {
+        const size_t i = static_cast<size_t>(op);
+        return ticks[i]++ % LATENCY_SAMPLE_PERIOD[i] == 0;
+    }
+
+    void recordLatency(MetricOp op, uint64_t ns);
+
+private:
+    friend class Metrics;
+
+    std::array<std::atomic<uint64_t>, METRIC_COUNTERS> counters;
+    std::array<std::array<std::atomic<uint64_t>, LATENCY_BUCKETS>, METRIC_OPS> latency;
+    std::array<std::atomic<uint64_t>, METRIC_OPS> latency_sum_ns;
+    std::array<uint32_t, METRIC_OPS> ticks{};
+
+    static void bump(std::atomic<uint64_t>& value, uint64_t n) {
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+// Сумма счетчиков всех потоков
+struct MetricsSnapshot {
+    bool enabled = false;   // Собрано ли с HLL_METRICS
+    std::array<uint64_t, METRIC_COUNTERS> counters{};
+    std::array<std::array<uint64_t, LATENCY_BUCKETS>, METRIC_OPS> latency{};
+    std::array<uint64_t, METRIC_OPS> latency_sum_ns{};
+
+    uint64_t counter(MetricCounter c) const { return counters[static_cast<size_t>(c)]; }
+    uint64_t latencySamples(MetricOp op) const;
+};
+
+// Состояние одного скетча для экспорта вместе со счетчиками
+struct SketchGauges {
+    std::string name;
+    uint8_t b;
+    size_t m;
+    bool sparse;
+    uint64_t estimate;
+    RegisterHistogram histogram;   // histogram[k] - количество регистров со значением k
+
+    double zeroFraction() const { return m ? static_cast<double>(histogram[0]) / m : 0.0; }
+};
+
+class Metrics {
+public:
+    // Собрано ли с HLL_METRICS
+    static constexpr bool enabled() {
+#ifdef HLL_METRICS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Блок счетчиков текущего потока (создается при первом обращении).
+    // Указатель с тривиальной инициализацией читается без проверки
+    // guard-переменной thread_local-объекта на каждом вызове
+    static ThreadMetrics& local() {
+        thread_local ThreadMetrics* current = nullptr;
+        if (__builtin_expect(current == nullptr, 0)) {
+            current = &createLocal();
+        }
+        return *current;
+    }
+
+    // Сумма по всем потокам. Счетчики, которые потоки меняют во время
+    // снимка, могут попасть в него частично
+    static MetricsSnapshot snapshot();
+
+    // Обнуление всех счетчиков (для замеров между фазами работы)
+    static void reset();
+
+    static SketchGauges sketchGauges(std::string name, const HyperLogLog& sketch);
+
+    // Текстовый формат Prometheus (счетчики *_total, гистограмма
+    // hll_operation_latency_seconds по операциям, метрики скетчей с
+    // меткой sketch) и JSON с теми же данными
+    static void writePrometheus(std::ostream& out, const MetricsSnapshot& snapshot,
+                                const std::vector<SketchGauges>& sketches = {});
+    static void writeJson(std::ostream& out, const MetricsSnapshot& snapshot,
+                          const std::vector<SketchGauges>& sketches = {});
+
+    static const char* counterName(MetricCounter counter);
+    static const char* opName(MetricOp op);
+
+private:
+    static ThreadMetrics& createLocal();
+};
+
+// Выборочный замер времени операции в области видимости
+class MetricTimer {
+public:
+    explicit MetricTimer(MetricOp op) : op(op), sampled(Metrics::local().sample(op)) {
+        if (sampled) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~MetricTimer() {
+        if (sampled) {
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            Metrics::local().recordLatency(op, static_cast<uint64_t>(ns));
+        }
+    }
+
+    MetricTimer(const MetricTimer&) = delete;
+    MetricTimer& operator=(const MetricTimer&) = delete;
+
+private:
+    MetricOp op;
+    bool sampled;
+    std::chrono::steady_clock::time_point start;
+};
+
+#ifdef HLL_METRICS
+#define HLL_METRIC_ADD(counter, n) Metrics::local().add(MetricCounter::counter, (n))
+#define HLL_METRIC_TIMER(op) MetricTimer hll_metric_timer_(MetricOp::op)
+#define HLL_METRIC_ONLY(...) __VA_ARGS__
+#else
+#define HLL_METRIC_ADD(counter, n) ((void)0)
+#define HLL_METRIC_TIMER(op) ((void)0)
+#define HLL_METRIC_ONLY(...)
+#endif
+
+#endif // METRICS_H
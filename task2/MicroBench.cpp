@@ -0,0 +1,308 @@
+#include "MicroBench.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <stdexcept>
+#include <thread>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+const uint64_t COUNTER_CONFIGS[PerfCounters::COUNT] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+const char* COUNTER_NAMES[PerfCounters::COUNT] = {
+    "cycles", "instructions", "cache_misses", "branch_misses"
+};
+
+// Наибольшее число итераций одного замера
+constexpr size_t MAX_ITERATIONS = size_t(1) << 32;
+
+double cpuSeconds() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+struct Measurement {
+    double real_seconds;
+    double cpu_seconds;
+    uint64_t items;
+    uint64_t bytes;
+    std::array<uint64_t, PerfCounters::COUNT> counters;
+};
+
+Measurement measure(const MicroBench::Function& function, size_t iterations,
+                    PerfCounters& counters) {
+    BenchState state(iterations);
+    double cpu_start = cpuSeconds();
+    auto start = std::chrono::steady_clock::now();
+    counters.start();
+    function(state);
+    auto values = counters.stop();
+    auto end = std::chrono::steady_clock::now();
+    double cpu_end = cpuSeconds();
+    return Measurement{std::chrono::duration<double>(end - start).count(), cpu_end - cpu_start,
+                       state.itemsProcessed(), state.bytesProcessed(), values};
+}
+
+// Строка в кавычках для JSON (имена тестов - ASCII)
+std::string quoted(const std::string& text) {
+    std::string result = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+        }
+        result += c;
+    }
+    return result + "\"";
+}
+
+} // namespace
+
+PerfCounters::PerfCounters() {
+    for (size_t i = 0; i < COUNT; ++i) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = COUNTER_CONFIGS[i];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd : fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+bool PerfCounters::anyAvailable() const {
+    return std::any_of(std::begin(fds), std::end(fds), [](int fd) { return fd >= 0; });
+}
+
+void PerfCounters::start() {
+    for (int fd : fds) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+std::array<uint64_t, PerfCounters::COUNT> PerfCounters::stop() {
+    std::array<uint64_t, COUNT> values{};
+    for (size_t i = 0; i < COUNT; ++i) {
+        if (fds[i] >= 0) {
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fds[i], &values[i], sizeof(values[i])) != sizeof(values[i])) {
+                values[i] = 0;
+            }
+        }
+    }
+    return values;
+}
+
+const char* PerfCounters::name(size_t i) {
+    return COUNTER_NAMES[i];
+}
+
+void MicroBench::add(std::string name, Function function) {
+    benchmarks.emplace_back(std::move(name), std::move(function));
+}
+
+std::vector<std::string> MicroBench::names() const {
+    std::vector<std::string> result;
+    for (const auto& benchmark : benchmarks) {
+        result.push_back(benchmark.first);
+    }
+    return result;
+}
+
+std::vector<BenchResult> MicroBench::run(const BenchOptions& options, std::ostream& log) const {
+    PerfCounters counters;
+    std::vector<BenchResult> results;
+
+    for (const auto& [name, function] : benchmarks) {
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        log << name << "..." << std::flush;
+
+        // Подбор числа итераций; замеры подбора служат прогревом
+        size_t iterations = 1;
+        for (;;) {
+            Measurement m = measure(function, iterations, counters);
+            if (m.real_seconds >= options.min_time || iterations >= MAX_ITERATIONS) {
+                break;
+            }
+            double factor = m.real_seconds > 0.0 ? 1.4 * options.min_time / m.real_seconds : 100.0;
+            factor = std::clamp(factor, 2.0, 100.0);
+            iterations = std::min(MAX_ITERATIONS, static_cast<size_t>(iterations * factor));
+        }
+
+        std::vector<Measurement> runs;
+        for (unsigned r = 0; r < std::max(1u, options.repetitions); ++r) {
+            runs.push_back(measure(function, iterations, counters));
+        }
+        std::sort(runs.begin(), runs.end(), [](const Measurement& a, const Measurement& b) {
+            return a.real_seconds < b.real_seconds;
+        });
+        const Measurement& median = runs[runs.size() / 2];
+
+        BenchResult result;
+        result.name = name;
+        result.iterations = iterations;
+        result.real_ns = median.real_seconds * 1e9 / iterations;
+        result.cpu_ns = median.cpu_seconds * 1e9 / iterations;
+        result.items_per_second = median.items / median.real_seconds;
+        result.bytes_per_second = median.bytes / median.real_seconds;
+        for (size_t i = 0; i < PerfCounters::COUNT; ++i) {
+            result.has_counter[i] = counters.available(i);
+            result.counters[i] = static_cast<double>(median.counters[i]) / iterations;
+        }
+        results.push_back(result);
+        log << " " << std::fixed << std::setprecision(1) << result.real_ns << " ns" << std::endl;
+    }
+    return results;
+}
+
+void MicroBench::print(const std::vector<BenchResult>& results, BenchFormat format,
+                       std::ostream& out) {
+    if (format == BenchFormat::Csv) {
+        out << "name,iterations,real_time_ns,cpu_time_ns,items_per_second,bytes_per_second";
+        for (size_t i = 0; i < PerfCounters::COUNT; ++i) {
+            out << "," << PerfCounters::name(i) << "_per_iteration";
+        }
+        out << "\n";
+        for (const auto& r : results) {
+            out << r.name << "," << r.iterations << "," << std::setprecision(6) << r.real_ns
+                << "," << r.cpu_ns << "," << r.items_per_second << "," << r.bytes_per_second;
+            for (size_t i = 0; i < PerfCounters::COUNT; ++i) {
+                out << ",";
+                if (r.has_counter[i]) {
+                    out << r.counters[i];
+                }
+            }
+            out << "\n";
+        }
+        return;
+    }
+
+    if (format == BenchFormat::Json) {
+        std::time_t now = std::time(nullptr);
+        char date[32];
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+        bool any_counter = false;
+        for (const auto& r : results) {
+            any_counter = any_counter ||
+                std::any_of(r.has_counter.begin(), r.has_counter.end(), [](bool b) { return b; });
+        }
+        out << "{\n  \"context\": {\n"
+            << "    \"date\": " << quoted(date) << ",\n"
+            << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+            << "    \"perf_counters\": " << (any_counter ? "true" : "false") << "\n"
+            << "  },\n  \"benchmarks\": [\n";
+        for (size_t k = 0; k < results.size(); ++k) {
+            const auto& r = results[k];
+            out << "    {\n"
+                << "      \"name\": " << quoted(r.name) << ",\n"
+                << "      \"run_name\": " << quoted(r.name) << ",\n"
+                << "      \"run_type\": \"iteration\",\n"
+                << "      \"iterations\": " << r.iterations << ",\n"
+                << std::setprecision(6)
+                << "      \"real_time\": " << r.real_ns << ",\n"
+                << "      \"cpu_time\": " << r.cpu_ns << ",\n"
+                << "      \"time_unit\": \"ns\"";
+            if (r.items_per_second > 0.0) {
+                out << ",\n      \"items_per_second\": " << r.items_per_second;
+            }
+            if (r.bytes_per_second > 0.0) {
+                out << ",\n      \"bytes_per_second\": " << r.bytes_per_second;
+            }
+            for (size_t i = 0; i < PerfCounters::COUNT; ++i) {
+                if (r.has_counter[i]) {
+                    out << ",\n      \"" << PerfCounters::name(i) << "\": " << r.counters[i];
+                }
+            }
+            out << "\n    }" << (k + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+        return;
+    }
+
+    out << std::left << std::setw(28) << "Benchmark" << std::right
+        << std::setw(14) << "ns/iter" << std::setw(14) << "items/s" << std::setw(14) << "bytes/s"
+        << std::setw(12) << "cycles" << std::setw(12) << "instr" << std::setw(12) << "cache-miss"
+        << std::setw(12) << "br-miss" << "\n";
+    out << std::string(118, '-') << "\n";
+    for (const auto& r : results) {
+        out << std::left << std::setw(28) << r.name << std::right << std::fixed
+            << std::setprecision(1) << std::setw(14) << r.real_ns
+            << std::scientific << std::setprecision(3);
+        for (double rate : {r.items_per_second, r.bytes_per_second}) {
+            if (rate > 0.0) {
+                out << std::setw(14) << rate;
+            } else {
+                out << std::setw(14) << "-";
+            }
+        }
+        out << std::fixed << std::setprecision(1);
+        for (size_t i = 0; i < PerfCounters::COUNT; ++i) {
+            if (r.has_counter[i]) {
+                out << std::setw(12) << r.counters[i];
+            } else {
+                out << std::setw(12) << "-";
+            }
+        }
+        out << "\n";
+    }
+}
+
+BenchOptions MicroBench::parseOptions(int argc, char* argv[]) {
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const char* prefix) -> const char* {
+            size_t length = std::strlen(prefix);
+            return arg.compare(0, length, prefix) == 0 ? arg.c_str() + length : nullptr;
+        };
+        if (const char* v = value("--format=")) {
+            std::string format = v;
+            if (format == "table") {
+                options.format = BenchFormat::Table;
+            } else if (format == "csv") {
+                options.format = BenchFormat::Csv;
+            } else if (format == "json") {
+                options.format = BenchFormat::Json;
+            } else {
+                throw std::invalid_argument("Unknown format: " + format);
+            }
+        } else if (const char* v = value("--filter=")) {
+            options.filter = v;
+        } else if (const char* v = value("--min-time=")) {
+            options.min_time = std::stod(v);
+        } else if (const char* v = value("--repetitions=")) {
+            options.repetitions = static_cast<unsigned>(std::stoul(v));
+        } else if (arg == "--list") {
+            options.list_only = true;
+        } else {
+            throw std::invalid_argument("Unknown argument: " + arg);
+        }
+    }
+    return options;
+}
@@ -0,0 +1,128 @@
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+#include <array>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+
+// Небольшой каркас микробенчмарков в духе Google Benchmark (без внешних
+// зависимостей): тест получает число итераций, каркас подбирает его так,
+// чтобы замер длился не меньше min_time, повторяет замер repetitions раз
+// и берет повтор с медианным временем. Результаты - нс на итерацию,
+// элементы и байты в секунду и аппаратные счетчики на итерацию,
+// в виде таблицы, CSV или JSON (формат Google Benchmark, который
+// понимает его compare.py)
+
+// Аппаратные счетчики потока через perf_event_open: циклы, инструкции,
+// промахи кэша последнего уровня, ошибки предсказания ветвлений (только
+// пользовательский режим). Каждый счетчик открывается отдельно; в
+// виртуальных машинах, контейнерах и при perf_event_paranoid > 2 часть
+// или все счетчики недоступны, и их значения не выводятся
+class PerfCounters {
+public:
+    static constexpr size_t COUNT = 4;
+
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // Открыт ли счетчик i
+    bool available(size_t i) const { return fds[i] >= 0; }
+    bool anyAvailable() const;
+
+    // Обнуление и запуск открытых счетчиков
+    void start();
+
+    // Остановка; значения с момента start() (0 для недоступных)
+    std::array<uint64_t, COUNT> stop();
+
+    // Имена счетчиков для CSV и JSON: cycles, instructions, cache_misses, branch_misses
+    static const char* name(size_t i);
+
+private:
+    int fds[COUNT];
+};
+
+// Состояние одного замера
+class BenchState {
+public:
+    explicit BenchState(size_t iterations) : count(iterations) {}
+
+    size_t iterations() const { return count; }
+
+    // Количество элементов и байт, обработанных за все итерации
+    void setItemsProcessed(uint64_t items) { items_processed = items; }
+    void setBytesProcessed(uint64_t bytes) { bytes_processed = bytes; }
+
+    uint64_t itemsProcessed() const { return items_processed; }
+    uint64_t bytesProcessed() const { return bytes_processed; }
+
+private:
+    size_t count;
+    uint64_t items_processed = 0;
+    uint64_t bytes_processed = 0;
+};
+
+// Запрет компилятору выбрасывать вычисление value
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct BenchResult {
+    std::string name;
+    size_t iterations;
+    double real_ns;                 // Время на итерацию
+    double cpu_ns;                  // Процессорное время процесса на итерацию
+    double items_per_second;        // 0, если тест не сообщает элементы
+    double bytes_per_second;        // 0, если тест не сообщает байты
+    std::array<bool, PerfCounters::COUNT> has_counter;
+    std::array<double, PerfCounters::COUNT> counters;  // На итерацию
+};
+
+enum class BenchFormat : uint8_t {
+    Table = 0,
+    Csv = 1,
+    Json = 2
+};
+
+struct BenchOptions {
+    double min_time = 0.2;       // Секунд на замер
+    unsigned repetitions = 3;
+    std::string filter;          // Подстрока имени; пустая - все тесты
+    BenchFormat format = BenchFormat::Table;
+    bool list_only = false;
+};
+
+class MicroBench {
+public:
+    using Function = std::function<void(BenchState&)>;
+
+    // Регистрация теста; имена вида "группа/параметр"
+    void add(std::string name, Function function);
+
+    // Запуск тестов, подходящих под фильтр. Ход выполнения пишется в log
+    std::vector<BenchResult> run(const BenchOptions& options, std::ostream& log) const;
+
+    // Имена зарегистрированных тестов
+    std::vector<std::string> names() const;
+
+    // Вывод результатов в выбранном формате
+    static void print(const std::vector<BenchResult>& results, BenchFormat format,
+                      std::ostream& out);
+
+    // Разбор --format=table|csv|json, --filter=, --min-time=, --repetitions=,
+    // --list. Неизвестный аргумент - std::invalid_argument
+    static BenchOptions parseOptions(int argc, char* argv[]);
+
+private:
+    std::vector<std::pair<std::string, Function>> benchmarks;
+};
+
+#endif // MICROBENCH_H
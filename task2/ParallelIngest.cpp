@@ -0,0 +1,40 @@
+#include "ParallelIngest.h"
+#include <thread>
+#include <algorithm>
+
+HyperLogLog parallelIngest(const std::string* items, size_t count,
+                           unsigned threads, uint8_t b, uint32_t seed,
+                           HashKind kind) {
+    threads = std::max(1U, threads);
+    
+    // Скетчи создаются до запуска потоков, чтобы ошибки параметров
+    // выбрасывались в вызывающем потоке
+    std::vector<HyperLogLog> partial(threads, HyperLogLog(b, seed, kind));
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    
+    const size_t chunk = (count + threads - 1) / threads;
+    for (unsigned t = 0; t < threads; ++t) {
+        size_t begin = std::min(count, t * chunk);
+        size_t end = std::min(count, begin + chunk);
+        workers.emplace_back([&partial, items, t, begin, end] {
+            partial[t].addBatch(items + begin, end - begin);
+        });
+    }
+    
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    
+    for (unsigned t = 1; t < threads; ++t) {
+        partial[0] |= partial[t];
+    }
+    
+    return std::move(partial[0]);
+}
+
+HyperLogLog parallelIngest(const std::vector<std::string>& items,
+                           unsigned threads, uint8_t b, uint32_t seed,
+                           HashKind kind) {
+    return parallelIngest(items.data(), items.size(), threads, b, seed, kind);
+}
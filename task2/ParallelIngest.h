@@ -0,0 +1,22 @@
+#ifndef PARALLELINGEST_H
+#define PARALLELINGEST_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "HyperLogLog.h"
+
+// Параллельное построение HyperLogLog.
+// Диапазон [items, items + count) делится на threads непрерывных частей,
+// каждый поток заполняет собственный скетч через addBatch, после чего
+// скетчи объединяются merge(). Так как объединение - поэлементный максимум,
+// результат совпадает с последовательной вставкой всех элементов
+HyperLogLog parallelIngest(const std::string* items, size_t count,
+                           unsigned threads, uint8_t b = 14, uint32_t seed = 42,
+                           HashKind kind = HashKind::Murmur3_32);
+
+HyperLogLog parallelIngest(const std::vector<std::string>& items,
+                           unsigned threads, uint8_t b = 14, uint32_t seed = 42,
+                           HashKind kind = HashKind::Murmur3_32);
+
+#endif // PARALLELINGEST_H
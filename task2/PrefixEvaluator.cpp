@@ -0,0 +1,61 @@
+#include "PrefixEvaluator.h"
+#include "DistinctCounter.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+PrefixEvaluator::PrefixEvaluator(std::vector<double> percentages, uint8_t b,
+                                 uint32_t seed, HashKind kind)
+    : percentages(std::move(percentages)), B(b), seed(seed), kind(kind) {
+    for (double pct : this->percentages) {
+        if (pct < 0 || pct > 100) {
+            throw std::invalid_argument("Percentage must be between 0 and 100");
+        }
+    }
+    std::sort(this->percentages.begin(), this->percentages.end());
+}
+
+template <typename Key>
+std::vector<PrefixSnapshot> PrefixEvaluator::evaluateImpl(const Key* items, size_t count) const {
+    HyperLogLog hll(B, seed, kind);
+    
+    DistinctCounter unique_elements(DistinctCounter::Mode::Verified, count);
+    
+    std::vector<PrefixSnapshot> snapshots;
+    snapshots.reserve(percentages.size());
+    
+    size_t position = 0;
+    for (double pct : percentages) {
+        const size_t end_index = static_cast<size_t>((pct / 100.0) * count);
+        
+        // Дописываем элементы от предыдущей контрольной точки
+        hll.addBatch(items + position, end_index - position);
+        for (; position < end_index; ++position) {
+            unique_elements.insert(items[position]);
+        }
+        
+        PrefixSnapshot snapshot;
+        snapshot.percentage = pct;
+        snapshot.prefix_size = end_index;
+        snapshot.exact_count = unique_elements.size();
+        snapshot.hll_estimate = hll.estimate();
+        snapshot.relative_error = snapshot.exact_count == 0 ? 0.0 :
+            std::abs(static_cast<double>(snapshot.hll_estimate) - snapshot.exact_count) /
+            snapshot.exact_count;
+        snapshots.push_back(snapshot);
+    }
+    
+    return snapshots;
+}
+
+std::vector<PrefixSnapshot> PrefixEvaluator::evaluate(const std::string* items, size_t count) const {
+    return evaluateImpl(items, count);
+}
+
+std::vector<PrefixSnapshot> PrefixEvaluator::evaluate(const std::string_view* items, size_t count) const {
+    return evaluateImpl(items, count);
+}
+
+std::vector<PrefixSnapshot> PrefixEvaluator::evaluate(const std::vector<std::string>& stream) const {
+    return evaluate(stream.data(), stream.size());
+}
@@ -0,0 +1,48 @@
+#ifndef PREFIXEVALUATOR_H
+#define PREFIXEVALUATOR_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include "HyperLogLog.h"
+
+// Результат на одном префиксе потока
+struct PrefixSnapshot {
+    double percentage;       // Доля потока в процентах
+    size_t prefix_size;      // Длина префикса
+    uint64_t exact_count;    // Точное количество уникальных элементов
+    uint64_t hll_estimate;   // Оценка HyperLogLog
+    double relative_error;   // |оценка - точное| / точное
+};
+
+// Оценка HyperLogLog на вложенных префиксах потока за один проход.
+// Префикс для процента p имеет длину floor(p / 100 * size), как у
+// RandomStreamGen::getStreamPart. Элементы добавляются в скетч и в
+// множество точного подсчета один раз; на границе каждого префикса
+// снимаются точное значение и оценка. Оценки совпадают с оценками
+// скетча, построенного заново по копии префикса
+class PrefixEvaluator {
+private:
+    std::vector<double> percentages;  // По возрастанию
+    uint8_t B;
+    uint32_t seed;
+    HashKind kind;
+    
+    template <typename Key>
+    std::vector<PrefixSnapshot> evaluateImpl(const Key* items, size_t count) const;
+    
+public:
+    // Проценты должны лежать в [0, 100]; порядок не важен
+    PrefixEvaluator(std::vector<double> percentages, uint8_t b = 14,
+                    uint32_t seed = 42, HashKind kind = HashKind::Murmur3_32);
+    
+    // Результаты в порядке возрастания процентов
+    std::vector<PrefixSnapshot> evaluate(const std::string* items, size_t count) const;
+    std::vector<PrefixSnapshot> evaluate(const std::string_view* items, size_t count) const;
+    std::vector<PrefixSnapshot> evaluate(const std::vector<std::string>& stream) const;
+    
+    const std::vector<double>& getPercentages() const { return percentages; }
+};
+
+#endif // PREFIXEVALUATOR_H
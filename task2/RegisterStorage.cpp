@@ -0,0 +1,185 @@
+#include "RegisterStorage.h"
+#include <algorithm>
+#include <immintrin.h>
+
+namespace {
+
+constexpr uint64_t LOW_BYTES = 0x0101010101010101ULL;
+constexpr uint64_t HIGH_BITS = 0x8080808080808080ULL;
+constexpr uint64_t LOW_NIBBLES = 0x0F0F0F0F0F0F0F0FULL;
+
+// Побайтовый максимум 8 значений < 128, упакованных в 64-битные слова.
+// (a | 0x80) - b не заимствует из соседнего байта, а старший бит
+// результата равен 1 ровно там, где a >= b
+inline uint64_t maxBytes7(uint64_t a, uint64_t b) {
+    uint64_t ge = (((a | HIGH_BITS) - b) & HIGH_BITS) >> 7;
+    uint64_t mask = ge * 0xFF;
+    return (a & mask) | (b & ~mask);
+}
+
+inline uint64_t load64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline void store64(uint8_t* p, uint64_t v) {
+    std::memcpy(p, &v, sizeof(v));
+}
+
+// Количество нулевых тетрад в 64-битном слове
+inline int countZeroNibbles(uint64_t x) {
+    uint64_t nonzero = (x | (x >> 1) | (x >> 2) | (x >> 3)) & 0x1111111111111111ULL;
+    return 16 - __builtin_popcountll(nonzero);
+}
+
+__attribute__((target("avx2")))
+void mergeBytesAvx2(uint8_t* dst, const uint8_t* src, size_t count) {
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_max_epu8(a, b));
+    }
+    for (; i < count; ++i) {
+        dst[i] = std::max(dst[i], src[i]);
+    }
+}
+
+// 8 регистров по 6 бит занимают 6 байт: распаковка в байты через pdep,
+// максимум и обратная упаковка через pext
+__attribute__((target("bmi2")))
+void mergePacked6Bmi2(uint8_t* dst, const uint8_t* src, size_t groups) {
+    const uint64_t spread = 0x3F3F3F3F3F3F3F3FULL;
+    const uint64_t keep = 0xFFFFULL << 48;  // Байты 6-7 принадлежат следующей группе
+    for (size_t g = 0; g < groups; ++g) {
+        uint64_t a = load64(dst + g * 6);
+        uint64_t b = load64(src + g * 6);
+        uint64_t max = maxBytes7(_pdep_u64(a, spread), _pdep_u64(b, spread));
+        store64(dst + g * 6, (a & keep) | _pext_u64(max, spread));
+    }
+}
+
+} // namespace
+
+// ------------------------------------------------------------ ByteRegisters
+
+void mergeMaxBytes(uint8_t* dst, const uint8_t* src, size_t count) {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    if (has_avx2) {
+        mergeBytesAvx2(dst, src, count);
+        return;
+    }
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_max_epu8(a, b));
+    }
+    for (; i < count; ++i) {
+        dst[i] = std::max(dst[i], src[i]);
+    }
+}
+
+void ByteRegisters::mergeMaxRaw(const uint8_t* raw) {
+    mergeMaxBytes(values.data(), raw, values.size());
+}
+
+void ByteRegisters::clear() {
+    std::fill(values.begin(), values.end(), 0);
+}
+
+// --------------------------------------------------------- PackedRegisters6
+
+void PackedRegisters6::mergeMaxRaw(const uint8_t* raw) {
+    static const bool has_bmi2 = __builtin_cpu_supports("bmi2");
+    if (has_bmi2 && m % 8 == 0) {
+        mergePacked6Bmi2(bits.data(), raw, m / 8);
+        return;
+    }
+    for (size_t i = 0; i < m; ++i) {
+        uint8_t v = getRaw(raw, m, i);
+        if (v > get(i)) {
+            set(i, v);
+        }
+    }
+}
+
+void PackedRegisters6::clear() {
+    std::fill(bits.begin(), bits.end(), 0);
+}
+
+// -------------------------------------------------------- TailCutRegisters4
+
+void TailCutRegisters4::rebase() {
+    // Без регистров (разреженный режим TailCutHyperLogLog) сдвигать нечего
+    if (m == 0) {
+        return;
+    }
+    while (base_count == 0) {
+        // Все тетрады >= 1: вычитание 0x11 из каждого байта не дает заемов
+        size_t zeros = 0;
+        size_t k = 0;
+        for (; k + 8 <= nibbles.size(); k += 8) {
+            uint64_t word = load64(&nibbles[k]) - 0x1111111111111111ULL;
+            store64(&nibbles[k], word);
+            zeros += countZeroNibbles(word);
+        }
+        for (; k < nibbles.size(); ++k) {
+            nibbles[k] = static_cast<uint8_t>(nibbles[k] - 0x11);
+            zeros += ((nibbles[k] & 0x0F) == 0) + ((nibbles[k] >> 4) == 0);
+        }
+        ++base;
+        base_count = zeros;
+    }
+}
+
+void TailCutRegisters4::mergeMaxNibbles(const uint8_t* other_nibbles, uint8_t other_base) {
+    if (base == other_base && nibbles.size() % 8 == 0) {
+        // Общее смещение: максимум тетрад по словам
+        size_t zeros = 0;
+        for (size_t k = 0; k < nibbles.size(); k += 8) {
+            uint64_t a = load64(&nibbles[k]);
+            uint64_t b = load64(other_nibbles + k);
+            uint64_t lo = maxBytes7(a & LOW_NIBBLES, b & LOW_NIBBLES);
+            uint64_t hi = maxBytes7((a >> 4) & LOW_NIBBLES, (b >> 4) & LOW_NIBBLES);
+            uint64_t word = lo | (hi << 4);
+            store64(&nibbles[k], word);
+            zeros += countZeroNibbles(word);
+        }
+        base_count = zeros;
+    } else {
+        // Каждый регистр объединения не меньше обоих смещений
+        const uint8_t new_base = std::max(base, other_base);
+        size_t zeros = 0;
+        for (size_t i = 0; i < m; ++i) {
+            uint8_t other_value = other_base + ((other_nibbles[i >> 1] >> ((i & 1) * 4)) & 0x0F);
+            uint8_t v = std::max(get(i), other_value);
+            uint8_t delta = std::min<uint8_t>(v - new_base, MAX_DELTA);
+            unsigned shift = (i & 1) * 4;
+            nibbles[i >> 1] = static_cast<uint8_t>((nibbles[i >> 1] & ~(0x0F << shift)) | (delta << shift));
+            zeros += (delta == 0);
+        }
+        base = new_base;
+        base_count = zeros;
+    }
+    rebase();
+}
+
+void TailCutRegisters4::load(const uint8_t* in) {
+    std::memcpy(nibbles.data(), in, nibbles.size());
+    base = in[nibbles.size()];
+    base_count = 0;
+    for (size_t i = 0; i < m; ++i) {
+        base_count += nibble(i) == 0;
+    }
+    // Записанные другой реализацией данные могут не содержать тетрады,
+    // равной base
+    rebase();
+}
+
+void TailCutRegisters4::clear() {
+    std::fill(nibbles.begin(), nibbles.end(), 0);
+    base = 0;
+    base_count = m;
+}
@@ -0,0 +1,199 @@
+#ifndef REGISTERSTORAGE_H
+#define REGISTERSTORAGE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+// Способы хранения регистров HyperLogLog (параметр шаблона BasicHyperLogLog).
+// Общий интерфейс:
+//   Registers(m)      - m нулевых регистров
+//   size()            - количество регистров
+//   get(i), [i]       - значение регистра
+//   set(i, v)         - запись значения v > get(i); возвращает фактически
+//                       сохраненное значение (TailCut может его усечь)
+//   mergeMax(other)   - поэлементный максимум с other
+//   clear()           - обнуление всех регистров
+//   bytes()           - объем памяти под регистры в байтах
+//   bytesFor(m)       - объем памяти под m регистров (без выделения)
+//   ENCODING          - код раскладки в сериализованном формате (SketchIO.h)
+//   store(out)        - запись bytes() байт раскладки в out
+//   load(in)          - чтение bytes() байт раскладки из in
+//   getRaw(raw, m, i) - значение регистра i в сериализованной раскладке
+//   mergeMaxRaw(raw)  - поэлементный максимум с сериализованными регистрами
+
+// Код раскладки регистров в сериализованном скетче
+enum class RegisterEncoding : uint8_t {
+    Byte = 0,      // ByteRegisters
+    Packed6 = 1,   // PackedRegisters6
+    TailCut4 = 2,  // TailCutRegisters4
+    Sparse = 3     // Разреженный список (varint-разности записей)
+};
+
+// Поэлементный максимум count байтов: dst[i] = max(dst[i], src[i]).
+// AVX2 при поддержке процессором, иначе SSE2
+void mergeMaxBytes(uint8_t* dst, const uint8_t* src, size_t count);
+
+// Один байт на регистр
+class ByteRegisters {
+private:
+    std::vector<uint8_t> values;
+    
+public:
+    explicit ByteRegisters(size_t m = 0) : values(m, 0) {}
+    
+    size_t size() const { return values.size(); }
+    uint8_t get(size_t i) const { return values[i]; }
+    uint8_t operator[](size_t i) const { return values[i]; }
+    
+    uint8_t set(size_t i, uint8_t v) {
+        values[i] = v;
+        return v;
+    }
+    
+    // Максимум по 32 регистра за инструкцию (_mm256_max_epu8)
+    void mergeMax(const ByteRegisters& other) { mergeMaxRaw(other.values.data()); }
+    void mergeMaxRaw(const uint8_t* raw);
+    void clear();
+    size_t bytes() const { return values.size(); }
+    static size_t bytesFor(size_t m) { return m; }
+    
+    static constexpr RegisterEncoding ENCODING = RegisterEncoding::Byte;
+    void store(uint8_t* out) const { std::memcpy(out, values.data(), values.size()); }
+    void load(const uint8_t* in) { std::memcpy(values.data(), in, values.size()); }
+    static uint8_t getRaw(const uint8_t* raw, size_t, size_t i) { return raw[i]; }
+    
+    const uint8_t* data() const { return values.data(); }
+    std::vector<uint8_t>::const_iterator begin() const { return values.begin(); }
+    std::vector<uint8_t>::const_iterator end() const { return values.end(); }
+    
+    bool operator==(const ByteRegisters& other) const { return values == other.values; }
+    bool operator!=(const ByteRegisters& other) const { return values != other.values; }
+};
+
+// 6 бит на регистр, регистры плотно уложены в битовый поток.
+// Регистр i занимает биты [6i, 6i + 6) и всегда целиком лежит в двух
+// соседних байтах, поэтому get/set работают с одним 16-битным словом.
+// 6 бит хватает для рангов как 32-, так и 64-битного хеша (не больше 61)
+class PackedRegisters6 {
+private:
+    std::vector<uint8_t> bits;  // 6m/8 байт + 2 байта запаса для словных операций
+    size_t m;
+    
+public:
+    explicit PackedRegisters6(size_t m = 0) : bits(m * 6 / 8 + 2, 0), m(m) {}
+    
+    size_t size() const { return m; }
+    
+    uint8_t get(size_t i) const { return getRaw(bits.data(), m, i); }
+    
+    uint8_t operator[](size_t i) const { return get(i); }
+    
+    uint8_t set(size_t i, uint8_t v) {
+        const size_t bit = i * 6;
+        const unsigned shift = bit & 7;
+        uint16_t word;
+        std::memcpy(&word, &bits[bit >> 3], sizeof(word));
+        word = static_cast<uint16_t>((word & ~(0x3F << shift)) | (v << shift));
+        std::memcpy(&bits[bit >> 3], &word, sizeof(word));
+        return v;
+    }
+    
+    // Группы по 8 регистров (48 бит) распаковываются в байты через pdep,
+    // максимум берется SWAR-операциями, результат упаковывается pext
+    void mergeMax(const PackedRegisters6& other) { mergeMaxRaw(other.bits.data()); }
+    void mergeMaxRaw(const uint8_t* raw);
+    void clear();
+    size_t bytes() const { return bits.size(); }
+    static size_t bytesFor(size_t m) { return m * 6 / 8 + 2; }
+    
+    static constexpr RegisterEncoding ENCODING = RegisterEncoding::Packed6;
+    void store(uint8_t* out) const { std::memcpy(out, bits.data(), bits.size()); }
+    void load(const uint8_t* in) { std::memcpy(bits.data(), in, bits.size()); }
+    
+    static uint8_t getRaw(const uint8_t* raw, size_t, size_t i) {
+        const size_t bit = i * 6;
+        uint16_t word;
+        std::memcpy(&word, raw + (bit >> 3), sizeof(word));
+        return static_cast<uint8_t>((word >> (bit & 7)) & 0x3F);
+    }
+    
+    bool operator==(const PackedRegisters6& other) const { return bits == other.bits; }
+    bool operator!=(const PackedRegisters6& other) const { return bits != other.bits; }
+};
+
+// 4 бита на регистр со смещением в стиле HLL-TailCut.
+// Хранится разность M[j] - base, усеченная до 15. Когда ни один регистр
+// не равен base, смещение увеличивается, а все разности уменьшаются на 1
+// (одним вычитанием на 64-битное слово). Усечение делает схему
+// приближенной: значения выше base + 15 теряются, что на практике
+// случается с вероятностью порядка 2^-15 на регистр
+class TailCutRegisters4 {
+private:
+    std::vector<uint8_t> nibbles;  // m/2 байт, регистр 2k - младшая тетрада
+    size_t m;
+    uint8_t base;                  // Общее смещение всех регистров
+    size_t base_count;             // Количество регистров, равных base
+    
+    // Увеличение base, пока ни один регистр не равен base
+    void rebase();
+    
+    // Поэлементный максимум с регистрами other_base + other_nibbles
+    void mergeMaxNibbles(const uint8_t* other_nibbles, uint8_t other_base);
+    
+    uint8_t nibble(size_t i) const {
+        return (nibbles[i >> 1] >> ((i & 1) * 4)) & 0x0F;
+    }
+    
+public:
+    static constexpr uint8_t MAX_DELTA = 15;
+    
+    explicit TailCutRegisters4(size_t m = 0)
+        : nibbles((m + 1) / 2, 0), m(m), base(0), base_count(m) {}
+    
+    size_t size() const { return m; }
+    uint8_t get(size_t i) const { return base + nibble(i); }
+    uint8_t operator[](size_t i) const { return get(i); }
+    
+    uint8_t set(size_t i, uint8_t v) {
+        const uint8_t old = nibble(i);
+        const uint8_t delta = v - base > MAX_DELTA ? MAX_DELTA : v - base;
+        const unsigned shift = (i & 1) * 4;
+        nibbles[i >> 1] = static_cast<uint8_t>((nibbles[i >> 1] & ~(0x0F << shift)) | (delta << shift));
+        
+        const uint8_t stored = base + delta;
+        if (old == 0 && delta != 0 && --base_count == 0) {
+            rebase();
+        }
+        return stored;
+    }
+    
+    void mergeMax(const TailCutRegisters4& other) {
+        mergeMaxNibbles(other.nibbles.data(), other.base);
+    }
+    void mergeMaxRaw(const uint8_t* raw) { mergeMaxNibbles(raw, raw[nibbles.size()]); }
+    void clear();
+    size_t bytes() const { return nibbles.size() + sizeof(base); }
+    static size_t bytesFor(size_t m) { return (m + 1) / 2 + sizeof(uint8_t); }
+    uint8_t getBase() const { return base; }
+    
+    // Сериализованная раскладка: тетрады, затем байт смещения
+    static constexpr RegisterEncoding ENCODING = RegisterEncoding::TailCut4;
+    void store(uint8_t* out) const {
+        std::memcpy(out, nibbles.data(), nibbles.size());
+        out[nibbles.size()] = base;
+    }
+    void load(const uint8_t* in);
+    
+    static uint8_t getRaw(const uint8_t* raw, size_t m, size_t i) {
+        return raw[(m + 1) / 2] + ((raw[i >> 1] >> ((i & 1) * 4)) & 0x0F);
+    }
+    
+    bool operator==(const TailCutRegisters4& other) const {
+        return base == other.base && nibbles == other.nibbles;
+    }
+    bool operator!=(const TailCutRegisters4& other) const { return !(*this == other); }
+};
+
+#endif // REGISTERSTORAGE_H
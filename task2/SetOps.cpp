@@ -0,0 +1,476 @@
+#include "SetOps.h"
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <immintrin.h>
+
+namespace {
+
+// Часть регистров, сравниваемая за один проход по блоку пар
+constexpr size_t CHUNK = 4096;
+
+// Границы ln интенсивности: ниже 10^-3 часть объединения считается пустой
+const double THETA_MIN = std::log(1e-3);
+const double THETA_MAX = std::log(1e20);
+
+struct Gradient {
+    double value;
+    double d[3];  // Производные по ln a, ln b, ln x
+};
+
+// Логарифм P(K = k) для регистра с интенсивностью s и его производная по s.
+// P(K <= k) = exp(-s / (m 2^k)) при k <= q и 1 при k = q + 1
+inline void logRegisterProbability(double s, int k, int q, double m,
+                                   double& value, double& derivative) {
+    if (k == 0) {
+        value = -s / m;
+        derivative = -1.0 / m;
+        return;
+    }
+    const double c = std::ldexp(1.0 / m, -std::min(k, q));
+    const double x = s * c;
+    // P = exp(-x) (1 - exp(-x)) при k <= q и 1 - exp(-x) при k = q + 1
+    value = std::log(std::max(-std::expm1(-x), DBL_MIN));
+    derivative = c / std::expm1(x);
+    if (k <= q) {
+        value -= x;
+        derivative -= c;
+    }
+}
+
+// Логарифм P(K1 = K2 = k) и его производные по a, b, x
+inline void logEqualProbability(double a, double b, double x, int k, int q, double m,
+                                double& value, double grad[3]) {
+    if (k == 0) {
+        value = -(a + b + x) / m;
+        grad[0] = grad[1] = grad[2] = -1.0 / m;
+        return;
+    }
+    const double c = std::ldexp(1.0 / m, -std::min(k, q));
+    const double alpha = a * c;
+    const double beta = b * c;
+    const double xi = x * c;
+    // P = exp(-(alpha + beta + xi)) * bracket при k <= q и bracket при k = q + 1:
+    // bracket = (1 - e^-(alpha+xi)) (1 - e^-(beta+xi)) + e^-(alpha+beta+xi) (1 - e^-xi)
+    const double e_ax = std::exp(-(alpha + xi));
+    const double e_bx = std::exp(-(beta + xi));
+    const double e_abx = std::exp(-(alpha + beta + xi));
+    const double bracket = std::max(std::expm1(-(alpha + xi)) * std::expm1(-(beta + xi)) -
+                                    e_abx * std::expm1(-xi), DBL_MIN);
+    const double d_alpha = -e_ax * std::expm1(-beta);
+    const double d_beta = -e_bx * std::expm1(-alpha);
+    const double d_xi = e_ax + e_bx - e_abx;
+    const double shift = k <= q ? 1.0 : 0.0;
+
+    value = std::log(bracket) - shift * (alpha + beta + xi);
+    grad[0] = c * (d_alpha / bracket - shift);
+    grad[1] = c * (d_beta / bracket - shift);
+    grad[2] = c * (d_xi / bracket - shift);
+}
+
+// Логарифм правдоподобия и градиент по theta = (ln a, ln b, ln x)
+Gradient logLikelihood(const JointStatistics& s, int q, double m, const double theta[3]) {
+    const double a = std::exp(theta[0]);
+    const double b = std::exp(theta[1]);
+    const double x = std::exp(theta[2]);
+    double value = 0.0;
+    double da = 0.0, db = 0.0, dx = 0.0;
+    double term, derivative;
+    double grad[3];
+
+    for (int k = 0; k <= q + 1; ++k) {
+        if (s.a_less[k] != 0) {       // max(Ka, Kx) = k
+            logRegisterProbability(a + x, k, q, m, term, derivative);
+            value += s.a_less[k] * term;
+            da += s.a_less[k] * derivative;
+            dx += s.a_less[k] * derivative;
+        }
+        if (s.b_greater[k] != 0) {    // Kb = k
+            logRegisterProbability(b, k, q, m, term, derivative);
+            value += s.b_greater[k] * term;
+            db += s.b_greater[k] * derivative;
+        }
+        if (s.b_less[k] != 0) {       // max(Kb, Kx) = k
+            logRegisterProbability(b + x, k, q, m, term, derivative);
+            value += s.b_less[k] * term;
+            db += s.b_less[k] * derivative;
+            dx += s.b_less[k] * derivative;
+        }
+        if (s.a_greater[k] != 0) {    // Ka = k
+            logRegisterProbability(a, k, q, m, term, derivative);
+            value += s.a_greater[k] * term;
+            da += s.a_greater[k] * derivative;
+        }
+        if (s.equal[k] != 0) {
+            logEqualProbability(a, b, x, k, q, m, term, grad);
+            value += s.equal[k] * term;
+            da += s.equal[k] * grad[0];
+            db += s.equal[k] * grad[1];
+            dx += s.equal[k] * grad[2];
+        }
+    }
+    return Gradient{value, {a * da, b * db, x * dx}};
+}
+
+// Решение 3x3 системы A d = r методом Гаусса; false для вырожденной A
+bool solve3(double A[3][3], double r[3], double d[3]) {
+    for (int col = 0; col < 3; ++col) {
+        int pivot = col;
+        for (int row = col + 1; row < 3; ++row) {
+            if (std::abs(A[row][col]) > std::abs(A[pivot][col])) {
+                pivot = row;
+            }
+        }
+        if (std::abs(A[pivot][col]) < 1e-300) {
+            return false;
+        }
+        std::swap(A[col], A[pivot]);
+        std::swap(r[col], r[pivot]);
+        for (int row = col + 1; row < 3; ++row) {
+            double f = A[row][col] / A[col][col];
+            for (int k = col; k < 3; ++k) {
+                A[row][k] -= f * A[col][k];
+            }
+            r[row] -= f * r[col];
+        }
+    }
+    for (int row = 2; row >= 0; --row) {
+        double sum = r[row];
+        for (int k = row + 1; k < 3; ++k) {
+            sum -= A[row][k] * d[k];
+        }
+        d[row] = sum / A[row][row];
+    }
+    return true;
+}
+
+// Маргинальные гистограммы A, B и A ∪ B
+void marginalHistograms(const JointStatistics& s, RegisterHistogram& a,
+                        RegisterHistogram& b, RegisterHistogram& u) {
+    for (size_t k = 0; k < a.size(); ++k) {
+        a[k] = s.a_less[k] + s.a_greater[k] + s.equal[k];
+        b[k] = s.b_less[k] + s.b_greater[k] + s.equal[k];
+        u[k] = s.a_greater[k] + s.b_greater[k] + s.equal[k];
+    }
+}
+
+// Числа регистров с a[i] > b[i] и a[i] < b[i]
+inline void compareCountsScalar(const uint8_t* a, const uint8_t* b, size_t n,
+                                uint64_t& greater, uint64_t& less) {
+    for (size_t i = 0; i < n; ++i) {
+        greater += a[i] > b[i];
+        less += a[i] < b[i];
+    }
+}
+
+// Маски сравнения (0 или -1 в байте) вычитаются из байтовых счетчиков;
+// n / 32 <= 255 итераций на часть, затем счетчики суммируются через sad
+__attribute__((target("avx2")))
+void compareCountsAvx2(const uint8_t* a, const uint8_t* b, size_t n,
+                       uint64_t& greater, uint64_t& less) {
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    while (i + 32 <= n) {
+        __m256i gt_count = zero;
+        __m256i lt_count = zero;
+        const size_t end = std::min(n - n % 32, i + 255 * 32);
+        for (; i < end; i += 32) {
+            __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            // Значения регистров не больше 61, знаковое сравнение корректно
+            gt_count = _mm256_sub_epi8(gt_count, _mm256_cmpgt_epi8(va, vb));
+            lt_count = _mm256_sub_epi8(lt_count, _mm256_cmpgt_epi8(vb, va));
+        }
+        __m256i gt_sum = _mm256_sad_epu8(gt_count, zero);
+        __m256i lt_sum = _mm256_sad_epu8(lt_count, zero);
+        alignas(32) uint64_t lanes[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), gt_sum);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes + 4), lt_sum);
+        greater += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        less += lanes[4] + lanes[5] + lanes[6] + lanes[7];
+    }
+    compareCountsScalar(a + i, b + i, n - i, greater, less);
+}
+
+void compareCounts(const uint8_t* a, const uint8_t* b, size_t n,
+                   uint64_t& greater, uint64_t& less) {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    if (has_avx2) {
+        compareCountsAvx2(a, b, n, greater, less);
+    } else {
+        compareCountsScalar(a, b, n, greater, less);
+    }
+}
+
+// Явная оценка по D+ и D- (PairwiseMethod::Fast)
+JointEstimate fastEstimate(uint64_t greater, uint64_t less, size_t m, double n_a, double n_b) {
+    const double u = 2.0 - std::exp2(1.0 - static_cast<double>(greater) / m);  // |A \ B| / |A ∪ B|
+    const double v = 2.0 - std::exp2(1.0 - static_cast<double>(less) / m);     // |B \ A| / |A ∪ B|
+    const double jaccard = std::clamp(1.0 - u - v, 0.0, 1.0);
+    const double union_size = (n_a + n_b) / (1.0 + jaccard);
+    const double intersection = std::min({jaccard * union_size, n_a, n_b});
+    return JointEstimate{n_a - intersection, n_b - intersection, intersection};
+}
+
+template <typename Registers>
+void checkCompatible(const BasicHyperLogLog<Registers>& a, const BasicHyperLogLog<Registers>& b) {
+    if (a.getB() != b.getB() || a.getSeed() != b.getSeed() || a.getHashKind() != b.getHashKind()) {
+        throw std::invalid_argument("Set operations require sketches with equal B, seed and hash kind");
+    }
+}
+
+} // namespace
+
+JointStatistics jointStatistics(const uint8_t* a, const uint8_t* b, size_t m) {
+    JointStatistics s{};
+    for (size_t j = 0; j < m; ++j) {
+        const uint8_t k1 = a[j];
+        const uint8_t k2 = b[j];
+        if (k1 < k2) {
+            ++s.a_less[k1];
+            ++s.b_greater[k2];
+        } else if (k1 > k2) {
+            ++s.a_greater[k1];
+            ++s.b_less[k2];
+        } else {
+            ++s.equal[k1];
+        }
+    }
+    return s;
+}
+
+template <typename Registers>
+JointStatistics jointStatistics(const BasicHyperLogLog<Registers>& a,
+                                const BasicHyperLogLog<Registers>& b) {
+    checkCompatible(a, b);
+    if (a.isSparse() || b.isSparse()) {
+        BasicHyperLogLog<Registers> dense_a = a;
+        BasicHyperLogLog<Registers> dense_b = b;
+        dense_a.toDense();
+        dense_b.toDense();
+        return jointStatistics(dense_a, dense_b);
+    }
+    if constexpr (std::is_same_v<Registers, ByteRegisters>) {
+        return jointStatistics(a.getRegisters().data(), b.getRegisters().data(), a.getM());
+    } else {
+        std::vector<uint8_t> values_a(a.getM());
+        std::vector<uint8_t> values_b(b.getM());
+        for (size_t j = 0; j < a.getM(); ++j) {
+            values_a[j] = a.getRegisters().get(j);
+            values_b[j] = b.getRegisters().get(j);
+        }
+        return jointStatistics(values_a.data(), values_b.data(), a.getM());
+    }
+}
+
+JointEstimate estimateJoint(const JointStatistics& statistics, uint8_t B, HashKind kind) {
+    const double m = static_cast<double>(size_t(1) << B);
+    const int q = hashBits(kind) - B;
+
+    // Начальная точка - включения-исключения по улучшенным оценкам
+    RegisterHistogram hist_a, hist_b, hist_union;
+    marginalHistograms(statistics, hist_a, hist_b, hist_union);
+    const double n_a = static_cast<double>(estimateFromHistogram(hist_a, B, kind, Estimator::Improved));
+    const double n_b = static_cast<double>(estimateFromHistogram(hist_b, B, kind, Estimator::Improved));
+    const double n_union = static_cast<double>(
+        estimateFromHistogram(hist_union, B, kind, Estimator::Improved));
+    if (n_union == 0.0) {
+        return JointEstimate{0.0, 0.0, 0.0};
+    }
+    const double x0 = std::max(std::min(n_a + n_b - n_union, std::min(n_a, n_b)), 1.0);
+    double theta[3] = {
+        std::log(std::max(n_a - x0, 1.0)),
+        std::log(std::max(n_b - x0, 1.0)),
+        std::log(x0)
+    };
+
+    // Метод Ньютона по theta; гессиан - разности аналитических градиентов,
+    // шаг демпфируется (Левенберг - Марквардт), пока правдоподобие не вырастет
+    Gradient current = logLikelihood(statistics, q, m, theta);
+    const double h = 1e-6;
+    for (int iteration = 0; iteration < 100; ++iteration) {
+        double H[3][3];
+        for (int i = 0; i < 3; ++i) {
+            double shifted[3] = {theta[0], theta[1], theta[2]};
+            shifted[i] += h;
+            Gradient g = logLikelihood(statistics, q, m, shifted);
+            for (int r = 0; r < 3; ++r) {
+                H[r][i] = (g.d[r] - current.d[r]) / h;
+            }
+        }
+        double scale = 0.0;
+        for (int i = 0; i < 3; ++i) {
+            scale = std::max(scale, std::abs(H[i][i]));
+        }
+
+        double mu = 0.0;
+        bool improved = false;
+        double step_size = 0.0;
+        for (int attempt = 0; attempt < 40 && !improved; ++attempt) {
+            double A[3][3];
+            double r[3];
+            double delta[3];
+            for (int i = 0; i < 3; ++i) {
+                for (int k = 0; k < 3; ++k) {
+                    A[i][k] = -0.5 * (H[i][k] + H[k][i]) + (i == k ? mu : 0.0);
+                }
+                r[i] = current.d[i];
+            }
+            if (solve3(A, r, delta)) {
+                double next[3];
+                step_size = 0.0;
+                for (int i = 0; i < 3; ++i) {
+                    next[i] = std::clamp(theta[i] + delta[i], THETA_MIN, THETA_MAX);
+                    step_size = std::max(step_size, std::abs(next[i] - theta[i]));
+                }
+                Gradient candidate = logLikelihood(statistics, q, m, next);
+                if (candidate.value >= current.value - 1e-12 * std::abs(current.value)) {
+                    std::copy(next, next + 3, theta);
+                    current = candidate;
+                    improved = true;
+                }
+            }
+            mu = mu == 0.0 ? std::max(scale, 1.0) * 1e-6 : mu * 4.0;
+        }
+        if (!improved || step_size < 1e-9) {
+            break;
+        }
+    }
+
+    auto part = [](double t) { return t <= THETA_MIN + 1e-9 ? 0.0 : std::exp(t); };
+    return JointEstimate{part(theta[0]), part(theta[1]), part(theta[2])};
+}
+
+template <typename Registers>
+JointEstimate estimateJoint(const BasicHyperLogLog<Registers>& a,
+                            const BasicHyperLogLog<Registers>& b) {
+    return estimateJoint(jointStatistics(a, b), a.getB(), a.getHashKind());
+}
+
+template <typename Registers>
+JointEstimate inclusionExclusion(const BasicHyperLogLog<Registers>& a,
+                                 const BasicHyperLogLog<Registers>& b) {
+    checkCompatible(a, b);
+    BasicHyperLogLog<Registers> united = a;
+    united.merge(b);
+    const double n_a = static_cast<double>(a.estimate());
+    const double n_b = static_cast<double>(b.estimate());
+    const double n_union = static_cast<double>(united.estimate());
+    const double intersection = std::clamp(n_a + n_b - n_union, 0.0, std::min(n_a, n_b));
+    return JointEstimate{n_a - intersection, n_b - intersection, intersection};
+}
+
+void pairwiseSimilarity(const std::vector<const uint8_t*>& registers, uint8_t B,
+                        HashKind kind, const PairCallback& callback,
+                        const PairwiseOptions& options) {
+    const size_t count = registers.size();
+    const size_t m = size_t(1) << B;
+    const size_t tile = std::max<size_t>(options.tile, 1);
+
+    // Оценки мощностей и наличие нулевых регистров - один раз на скетч
+    std::vector<double> cardinality(count);
+    std::vector<bool> has_zeros(count);
+    for (size_t i = 0; i < count; ++i) {
+        RegisterHistogram histogram{};
+        for (size_t j = 0; j < m; ++j) {
+            ++histogram[registers[i][j]];
+        }
+        cardinality[i] = static_cast<double>(
+            estimateFromHistogram(histogram, B, kind, Estimator::Improved));
+        has_zeros[i] = histogram[0] != 0;
+    }
+
+    // Пары блоков (I, J), I <= J, раздаются потокам через общий счетчик
+    const size_t blocks = (count + tile - 1) / tile;
+    const size_t block_pairs = blocks * (blocks + 1) / 2;
+    std::atomic<size_t> next_pair(0);
+
+    auto worker = [&]() {
+        std::vector<uint64_t> greater(tile * tile);
+        std::vector<uint64_t> less(tile * tile);
+        for (size_t p = next_pair++; p < block_pairs; p = next_pair++) {
+            // Номер p -> (I, J) в порядке строк верхнего треугольника
+            size_t I = 0;
+            size_t rest = p;
+            while (rest >= blocks - I) {
+                rest -= blocks - I;
+                ++I;
+            }
+            const size_t J = I + rest;
+            const size_t i_begin = I * tile, i_end = std::min(count, i_begin + tile);
+            const size_t j_begin = J * tile, j_end = std::min(count, j_begin + tile);
+
+            std::fill(greater.begin(), greater.end(), 0);
+            std::fill(less.begin(), less.end(), 0);
+            for (size_t offset = 0; offset < m; offset += CHUNK) {
+                const size_t n = std::min(CHUNK, m - offset);
+                for (size_t i = i_begin; i < i_end; ++i) {
+                    for (size_t j = std::max(j_begin, i + 1); j < j_end; ++j) {
+                        const size_t cell = (i - i_begin) * tile + (j - j_begin);
+                        compareCounts(registers[i] + offset, registers[j] + offset, n,
+                                      greater[cell], less[cell]);
+                    }
+                }
+            }
+
+            for (size_t i = i_begin; i < i_end; ++i) {
+                for (size_t j = std::max(j_begin, i + 1); j < j_end; ++j) {
+                    const size_t cell = (i - i_begin) * tile + (j - j_begin);
+                    const bool fast = options.method == PairwiseMethod::Fast ||
+                        (options.method == PairwiseMethod::Auto && !has_zeros[i] && !has_zeros[j]);
+                    JointEstimate estimate = fast
+                        ? fastEstimate(greater[cell], less[cell], m, cardinality[i], cardinality[j])
+                        : estimateJoint(jointStatistics(registers[i], registers[j], m), B, kind);
+                    callback(i, j, estimate);
+                }
+            }
+        }
+    };
+
+    const unsigned threads = std::max(1u, options.threads);
+    if (threads == 1) {
+        worker();
+        return;
+    }
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+}
+
+void pairwiseSimilarity(const std::vector<HyperLogLog>& sketches, const PairCallback& callback,
+                        const PairwiseOptions& options) {
+    if (sketches.empty()) {
+        return;
+    }
+    std::vector<const uint8_t*> registers;
+    registers.reserve(sketches.size());
+    for (const auto& sketch : sketches) {
+        if (sketch.getB() != sketches[0].getB() || sketch.getSeed() != sketches[0].getSeed() ||
+            sketch.getHashKind() != sketches[0].getHashKind()) {
+            throw std::invalid_argument("Set operations require sketches with equal B, seed and hash kind");
+        }
+        if (sketch.isSparse()) {
+            throw std::invalid_argument("pairwiseSimilarity requires dense sketches (see toDense)");
+        }
+        registers.push_back(sketch.getRegisters().data());
+    }
+    pairwiseSimilarity(registers, sketches[0].getB(), sketches[0].getHashKind(), callback, options);
+}
+
+template JointStatistics jointStatistics(const HyperLogLog&, const HyperLogLog&);
+template JointStatistics jointStatistics(const PackedHyperLogLog&, const PackedHyperLogLog&);
+template JointStatistics jointStatistics(const TailCutHyperLogLog&, const TailCutHyperLogLog&);
+template JointEstimate estimateJoint(const HyperLogLog&, const HyperLogLog&);
+template JointEstimate estimateJoint(const PackedHyperLogLog&, const PackedHyperLogLog&);
+template JointEstimate estimateJoint(const TailCutHyperLogLog&, const TailCutHyperLogLog&);
+template JointEstimate inclusionExclusion(const HyperLogLog&, const HyperLogLog&);
+template JointEstimate inclusionExclusion(const PackedHyperLogLog&, const PackedHyperLogLog&);
+template JointEstimate inclusionExclusion(const TailCutHyperLogLog&, const TailCutHyperLogLog&);
@@ -0,0 +1,98 @@
+#ifndef SETOPS_H
+#define SETOPS_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include "HyperLogLog.h"
+#include "Estimators.h"
+
+// Пересечение и мера Жаккара по регистрам двух скетчей с одинаковыми B,
+// seed и хешем.
+//
+// Совместная оценка максимального правдоподобия (Ertl, "New cardinality
+// estimation algorithms for HyperLogLog sketches", раздел о пересечениях):
+// A \ B, B \ A и A ∩ B считаются независимыми пуассоновскими потоками с
+// интенсивностями a, b, x; регистры скетчей - K1 = max(Ka, Kx) и
+// K2 = max(Kb, Kx). Правдоподобие зависит только от пяти гистограмм
+// пар (K1, K2) и максимизируется методом Ньютона по ln a, ln b, ln x.
+// В отличие от |A| + |B| - |A ∪ B|, ошибка не складывается из ошибок трех
+// независимых оценок, и малые пересечения не уходят в отрицательные значения
+
+// Гистограммы пар регистров (K1, K2) двух скетчей
+struct JointStatistics {
+    RegisterHistogram a_less;     // K1 = k < K2
+    RegisterHistogram a_greater;  // K1 = k > K2
+    RegisterHistogram b_less;     // K2 = k < K1
+    RegisterHistogram b_greater;  // K2 = k > K1
+    RegisterHistogram equal;      // K1 = K2 = k
+};
+
+// Оценки частей объединения двух множеств
+struct JointEstimate {
+    double only_a;        // |A \ B|
+    double only_b;        // |B \ A|
+    double intersection;  // |A ∩ B|
+
+    double unionSize() const { return only_a + only_b + intersection; }
+    double jaccard() const {
+        double total = unionSize();
+        return total > 0.0 ? intersection / total : 0.0;
+    }
+};
+
+// Сбор гистограмм по m байтовым регистрам
+JointStatistics jointStatistics(const uint8_t* a, const uint8_t* b, size_t m);
+
+// То же для скетчей (разреженные переводятся в плотные во временной копии).
+// Разные B, seed или семейство хеша - std::invalid_argument
+template <typename Registers>
+JointStatistics jointStatistics(const BasicHyperLogLog<Registers>& a,
+                                const BasicHyperLogLog<Registers>& b);
+
+// Совместная оценка максимального правдоподобия
+JointEstimate estimateJoint(const JointStatistics& statistics, uint8_t B, HashKind kind);
+
+template <typename Registers>
+JointEstimate estimateJoint(const BasicHyperLogLog<Registers>& a,
+                            const BasicHyperLogLog<Registers>& b);
+
+// Формула включений-исключений |A| + |B| - |A ∪ B| по estimate()
+// (для сравнения; пересечение ограничивается снизу нулем)
+template <typename Registers>
+JointEstimate inclusionExclusion(const BasicHyperLogLog<Registers>& a,
+                                 const BasicHyperLogLog<Registers>& b);
+
+// Способ оценки в pairwiseSimilarity
+enum class PairwiseMethod : uint8_t {
+    // Только числа регистров с K1 > K2 и K1 < K2 (D+, D-): при отсутствии
+    // нулевых регистров P(K1 > K2) = 1 - log2(2 - |A \ B| / |A ∪ B|),
+    // откуда доли частей объединения находятся явно, а |A ∪ B| - из
+    // оценок |A| и |B|. Верна при мощностях от ~5m
+    Fast = 0,
+    // Гистограммы и estimateJoint для каждой пары (в десятки раз медленнее)
+    JointML = 1,
+    // Fast, если в обоих скетчах нет нулевых регистров, иначе JointML
+    Auto = 2
+};
+
+struct PairwiseOptions {
+    PairwiseMethod method = PairwiseMethod::Auto;
+    size_t tile = 16;        // Скетчей в блоке: 2 * tile блоков регистров в кэше
+    unsigned threads = 1;    // При threads > 1 callback вызывается параллельно
+};
+
+using PairCallback = std::function<void(size_t i, size_t j, const JointEstimate& estimate)>;
+
+// Оценки для всех пар i < j скетчей с байтовыми регистрами registers[i]
+// (m = 2^B регистров каждый). Пары обрабатываются блоками tile x tile,
+// регистры - частями по 4 КБ, так что сравниваемые части остаются в кэше
+void pairwiseSimilarity(const std::vector<const uint8_t*>& registers, uint8_t B,
+                        HashKind kind, const PairCallback& callback,
+                        const PairwiseOptions& options = PairwiseOptions());
+
+void pairwiseSimilarity(const std::vector<HyperLogLog>& sketches, const PairCallback& callback,
+                        const PairwiseOptions& options = PairwiseOptions());
+
+#endif // SETOPS_H
@@ -0,0 +1,664 @@
+#include "SketchAggregator.h"
+#include "HyperLogLog.h"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <unistd.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+namespace {
+
+constexpr uint64_t LISTENER = UINT64_MAX;     // Данные epoll слушающего сокета
+constexpr int MAX_EVENTS = 256;
+constexpr size_t INITIAL_BUFFER = 1 << 16;    // Начальный буфер чтения соединения
+constexpr size_t OUTPUT_LIMIT = 1 << 20;      // Выше - соединение не читается, пока
+                                              // клиент не заберет ответы
+constexpr uint8_t ESTIMATOR_COUNT = 4;
+const std::string UNIX_PREFIX = "unix:";
+
+std::runtime_error socketError(const std::string& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+sockaddr_un unixAddress(const std::string& path) {
+    sockaddr_un address{};
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Invalid Unix socket path: " + path);
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.data(), path.size());
+    return address;
+}
+
+// Адреса TCP для "хост:порт"; пустой хост - все интерфейсы (для bind)
+addrinfo* tcpAddresses(const std::string& endpoint, bool passive) {
+    const size_t colon = endpoint.rfind(':');
+    if (colon == std::string::npos || colon + 1 == endpoint.size()) {
+        throw std::invalid_argument("Endpoint must be unix:/path or host:port: " + endpoint);
+    }
+    const std::string host = endpoint.substr(0, colon);
+    const std::string port = endpoint.substr(colon + 1);
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+    addrinfo* result = nullptr;
+    int status = getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &result);
+    if (status != 0) {
+        throw std::runtime_error("Cannot resolve " + endpoint + ": " + gai_strerror(status));
+    }
+    return result;
+}
+
+void setNoDelay(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+void sendAll(int fd, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw socketError("Send error");
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+void recvAll(int fd, uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::recv(fd, data, size, 0);
+        if (n == 0) {
+            throw std::runtime_error("Connection closed by aggregator");
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw socketError("Receive error");
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+bool isUnix(const std::string& endpoint) {
+    return endpoint.compare(0, UNIX_PREFIX.size(), UNIX_PREFIX) == 0;
+}
+
+} // namespace
+
+void storeFrameHeader(const FrameHeader& header, uint8_t* out) {
+    storeLittleEndian(out, header.frame_bytes, 4);
+    out[4] = header.type;
+    out[5] = header.name_bytes;
+    out[6] = header.estimator;
+    out[7] = header.reserved;
+    storeLittleEndian(out + 8, header.time_from, 8);
+    storeLittleEndian(out + 16, header.time_to, 8);
+}
+
+FrameHeader loadFrameHeader(const uint8_t* in) {
+    FrameHeader header;
+    header.frame_bytes = static_cast<uint32_t>(loadLittleEndian(in, 4));
+    header.type = in[4];
+    header.name_bytes = in[5];
+    header.estimator = in[6];
+    header.reserved = in[7];
+    header.time_from = loadLittleEndian(in + 8, 8);
+    header.time_to = loadLittleEndian(in + 16, 8);
+    return header;
+}
+
+void storeReplyFrame(const ReplyFrame& reply, uint8_t* out) {
+    storeLittleEndian(out, reply.frame_bytes, 4);
+    out[4] = reply.type;
+    std::memcpy(out + 5, reply.reserved, sizeof(reply.reserved));
+    storeLittleEndian(out + 8, reply.value, 8);
+    storeLittleEndian(out + 16, reply.value2, 8);
+}
+
+ReplyFrame loadReplyFrame(const uint8_t* in) {
+    ReplyFrame reply;
+    reply.frame_bytes = static_cast<uint32_t>(loadLittleEndian(in, 4));
+    reply.type = in[4];
+    std::memcpy(reply.reserved, in + 5, sizeof(reply.reserved));
+    reply.value = loadLittleEndian(in + 8, 8);
+    reply.value2 = loadLittleEndian(in + 16, 8);
+    return reply;
+}
+
+int listenSocket(const std::string& endpoint) {
+    if (isUnix(endpoint)) {
+        const std::string path = endpoint.substr(UNIX_PREFIX.size());
+        sockaddr_un address = unixAddress(path);
+        int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            throw socketError("Cannot create socket");
+        }
+        ::unlink(path.c_str());
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+            ::listen(fd, SOMAXCONN) < 0) {
+            ::close(fd);
+            throw socketError("Cannot listen on " + endpoint);
+        }
+        return fd;
+    }
+
+    addrinfo* addresses = tcpAddresses(endpoint, true);
+    for (addrinfo* a = addresses; a; a = a->ai_next) {
+        int fd = ::socket(a->ai_family, a->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, a->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (::bind(fd, a->ai_addr, a->ai_addrlen) == 0 && ::listen(fd, SOMAXCONN) == 0) {
+            freeaddrinfo(addresses);
+            return fd;
+        }
+        ::close(fd);
+    }
+    freeaddrinfo(addresses);
+    throw socketError("Cannot listen on " + endpoint);
+}
+
+int connectSocket(const std::string& endpoint) {
+    if (isUnix(endpoint)) {
+        sockaddr_un address = unixAddress(endpoint.substr(UNIX_PREFIX.size()));
+        int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            throw socketError("Cannot create socket");
+        }
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            ::close(fd);
+            throw socketError("Cannot connect to " + endpoint);
+        }
+        return fd;
+    }
+
+    addrinfo* addresses = tcpAddresses(endpoint, false);
+    for (addrinfo* a = addresses; a; a = a->ai_next) {
+        int fd = ::socket(a->ai_family, a->ai_socktype | SOCK_CLOEXEC, a->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (::connect(fd, a->ai_addr, a->ai_addrlen) == 0) {
+            freeaddrinfo(addresses);
+            setNoDelay(fd);
+            return fd;
+        }
+        ::close(fd);
+    }
+    freeaddrinfo(addresses);
+    throw socketError("Cannot connect to " + endpoint);
+}
+
+SketchAggregator::SketchAggregator(const std::string& endpoint, uint8_t b, uint32_t seed,
+                                   HashKind kind, uint64_t bucket_seconds,
+                                   uint64_t retention_buckets)
+    : endpoint(endpoint), listen_fd(-1), epoll_fd(-1), bucket_seconds(bucket_seconds),
+      retention_buckets(retention_buckets), store(b, seed, kind), scratch(store.getM()) {
+    if (bucket_seconds == 0) {
+        throw std::invalid_argument("Bucket length must be positive");
+    }
+    listen_fd = listenSocket(endpoint);
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        ::close(listen_fd);
+        throw socketError("Cannot create epoll");
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = LISTENER;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event);
+}
+
+SketchAggregator::~SketchAggregator() {
+    for (auto& connection : connections) {
+        if (connection->fd >= 0) {
+            ::close(connection->fd);
+        }
+    }
+    ::close(epoll_fd);
+    ::close(listen_fd);
+    if (isUnix(endpoint)) {
+        ::unlink(endpoint.substr(UNIX_PREFIX.size()).c_str());
+    }
+}
+
+void SketchAggregator::run(const std::atomic<bool>& stop, int timeout_ms) {
+    while (!stop.load(std::memory_order_relaxed)) {
+        poll(timeout_ms);
+    }
+}
+
+void SketchAggregator::poll(int timeout_ms) {
+    epoll_event events[MAX_EVENTS];
+    int n = epoll_wait(epoll_fd, events, MAX_EVENTS, timeout_ms);
+    if (n < 0) {
+        if (errno == EINTR) {
+            return;
+        }
+        throw socketError("epoll_wait failed");
+    }
+    now_seconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    evictExpired();
+
+    // 1. Чтение и разбор: объединения и запросы только собираются
+    for (int i = 0; i < n; ++i) {
+        if (events[i].data.u64 == LISTENER) {
+            accept();
+            continue;
+        }
+        Connection& connection = *connections[events[i].data.u64];
+        if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+            readFrom(connection);
+            parseFrames(connection);
+        }
+        touched.push_back(&connection);
+    }
+
+    // 2. Пакет объединений, затем запросы (видят все записи итерации)
+    applyMerges();
+    answerQueries();
+
+    // 3. Сдвиг буферов, отправка ответов, закрытие
+    for (Connection* connection : touched) {
+        finishConnection(*connection);
+    }
+    touched.clear();
+}
+
+void SketchAggregator::evictExpired() {
+    const uint64_t now_bucket = now_seconds / bucket_seconds;
+    if (retention_buckets == 0 || now_bucket < retention_buckets ||
+        now_bucket - retention_buckets + 1 <= first_bucket) {
+        return;
+    }
+    first_bucket = now_bucket - retention_buckets + 1;
+
+    // Интервалы каждого имени отсортированы: удаляется их префикс
+    for (auto it = buckets.begin(); it != buckets.end();) {
+        auto& list = it->second;
+        auto end = std::lower_bound(list.begin(), list.end(), first_bucket);
+        for (auto b = list.begin(); b != end; ++b) {
+            store.erase(bucketKey(it->first, *b));
+        }
+        stats.evicted += static_cast<uint64_t>(end - list.begin());
+        list.erase(list.begin(), end);
+        it = list.empty() ? buckets.erase(it) : std::next(it);
+    }
+}
+
+void SketchAggregator::accept() {
+    for (;;) {
+        int fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // EAGAIN - очередь пуста; остальные ошибки касаются одного соединения
+            return;
+        }
+        if (!isUnix(endpoint)) {
+            setNoDelay(fd);
+        }
+
+        size_t slot;
+        if (!free_slots.empty()) {
+            slot = free_slots.back();
+            free_slots.pop_back();
+        } else {
+            slot = connections.size();
+            connections.push_back(std::make_unique<Connection>());
+        }
+        Connection& connection = *connections[slot];
+        connection.fd = fd;
+        connection.slot = slot;
+        if (connection.in.size() < INITIAL_BUFFER) {
+            connection.in.resize(INITIAL_BUFFER);
+        }
+
+        epoll_event event{};
+        event.events = connection.events = EPOLLIN;
+        event.data.u64 = slot;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+        ++stats.connections;
+    }
+}
+
+void SketchAggregator::readFrom(Connection& connection) {
+    // Буфер растет только до размера самого большого начатого кадра
+    if (connection.in_used >= sizeof(uint32_t)) {
+        const uint64_t frame_bytes = loadLittleEndian(connection.in.data(), sizeof(uint32_t));
+        if (frame_bytes > connection.in.size() && frame_bytes <= MAX_FRAME_BYTES) {
+            connection.in.resize(frame_bytes);
+        }
+    }
+    if (connection.in_used == connection.in.size()) {
+        return;
+    }
+
+    ssize_t n;
+    do {
+        n = ::recv(connection.fd, connection.in.data() + connection.in_used,
+                   connection.in.size() - connection.in_used, 0);
+    } while (n < 0 && errno == EINTR);
+
+    if (n > 0) {
+        connection.in_used += static_cast<size_t>(n);
+    } else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+        connection.closing = true;
+    }
+}
+
+void SketchAggregator::parseFrames(Connection& connection) {
+    const uint8_t* data = connection.in.data();
+    size_t pos = 0;
+
+    while (connection.in_used - pos >= sizeof(FrameHeader)) {
+        const FrameHeader header = loadFrameHeader(data + pos);
+        const auto type = static_cast<FrameType>(header.type);
+        const bool named = type == FrameType::Merge || type == FrameType::Query;
+        if (header.frame_bytes < sizeof(FrameHeader) + header.name_bytes ||
+            header.frame_bytes > MAX_FRAME_BYTES ||
+            !(named || type == FrameType::Stats) || (named && header.name_bytes == 0) ||
+            header.estimator >= ESTIMATOR_COUNT) {
+            ++stats.protocol_errors;
+            connection.closing = true;
+            break;
+        }
+        if (connection.in_used - pos < header.frame_bytes) {
+            break;
+        }
+
+        const uint8_t* frame = data + pos;
+        std::string_view name(reinterpret_cast<const char*>(frame + sizeof(FrameHeader)),
+                              header.name_bytes);
+        pos += header.frame_bytes;
+        ++stats.frames;
+
+        if (type != FrameType::Merge) {
+            queries.push_back({&connection, header, name});
+            continue;
+        }
+
+        // Запись проверяется (контрольная сумма, параметры и содержимое:
+        // индексы разреженных записей меньше 2^25, ранги и регистры не больше
+        // hashBits - B + 1, см. HyperLogLogView) при разборе, чтобы пакет
+        // состоял только из применимых объединений: mergeViewIntoBytes и
+        // гистограмма в estimate() полагаются на эти границы
+        const uint8_t* record = frame + sizeof(FrameHeader) + header.name_bytes;
+        const size_t record_bytes = header.frame_bytes - sizeof(FrameHeader) - header.name_bytes;
+        try {
+            HyperLogLogView view(record, record_bytes);
+            if (view.recordBytes() != record_bytes || view.getB() != store.getB() ||
+                view.getSeed() != store.getSeed() || view.getHashKind() != store.getHashKind()) {
+                ++stats.rejected;
+                continue;
+            }
+            const uint64_t time = header.time_from ? header.time_from : now_seconds;
+            if (time / bucket_seconds < first_bucket) {
+                ++stats.rejected;
+                continue;
+            }
+            pending.push_back({bucketSketch(name, time / bucket_seconds), view});
+        } catch (const std::invalid_argument&) {
+            ++stats.rejected;
+        }
+    }
+    connection.parsed = pos;
+}
+
+void SketchAggregator::applyMerges() {
+    if (pending.empty()) {
+        return;
+    }
+    // Записи одного скетча идут подряд: его регистры остаются в кэше
+    std::sort(pending.begin(), pending.end(), [](const PendingMerge& a, const PendingMerge& b) {
+        return a.id < b.id;
+    });
+    for (const PendingMerge& merge : pending) {
+        store.mergeInto(merge.id, merge.view);
+    }
+    stats.merged += pending.size();
+    ++stats.merge_batches;
+    pending.clear();
+}
+
+void SketchAggregator::answerQueries() {
+    for (const PendingQuery& query : queries) {
+        ReplyFrame reply{};
+        reply.frame_bytes = sizeof(ReplyFrame);
+        if (static_cast<FrameType>(query.header.type) == FrameType::Stats) {
+            reply.type = static_cast<uint8_t>(FrameType::ReplyStats);
+            reply.value = stats.merged;
+            reply.value2 = stats.rejected;
+        } else {
+            reply.type = static_cast<uint8_t>(FrameType::ReplyEstimate);
+            reply.value = estimate(query.name, query.header.time_from, query.header.time_to,
+                                   static_cast<Estimator>(query.header.estimator), &reply.value2);
+            ++stats.queries;
+        }
+        auto& out = query.connection->out;
+        out.resize(out.size() + sizeof(ReplyFrame));
+        storeReplyFrame(reply, out.data() + out.size() - sizeof(ReplyFrame));
+    }
+    queries.clear();
+}
+
+void SketchAggregator::finishConnection(Connection& connection) {
+    if (connection.fd < 0) {
+        return;
+    }
+    if (connection.parsed > 0) {
+        std::memmove(connection.in.data(), connection.in.data() + connection.parsed,
+                     connection.in_used - connection.parsed);
+        connection.in_used -= connection.parsed;
+        connection.parsed = 0;
+    }
+    flushOutput(connection);
+    if (connection.closing) {
+        close(connection);
+    } else {
+        updateInterest(connection);
+    }
+}
+
+void SketchAggregator::flushOutput(Connection& connection) {
+    while (connection.out_sent < connection.out.size()) {
+        ssize_t n = ::send(connection.fd, connection.out.data() + connection.out_sent,
+                           connection.out.size() - connection.out_sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                connection.closing = true;
+            }
+            break;
+        }
+        connection.out_sent += static_cast<size_t>(n);
+    }
+    if (connection.out_sent == connection.out.size()) {
+        connection.out.clear();
+        connection.out_sent = 0;
+    }
+}
+
+void SketchAggregator::updateInterest(Connection& connection) {
+    const size_t backlog = connection.out.size() - connection.out_sent;
+    uint32_t events = (backlog < OUTPUT_LIMIT ? uint32_t(EPOLLIN) : 0) |
+                      (backlog ? uint32_t(EPOLLOUT) : 0);
+    if (events != connection.events) {
+        epoll_event event{};
+        event.events = connection.events = events;
+        event.data.u64 = connection.slot;
+        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, connection.fd, &event);
+    }
+}
+
+void SketchAggregator::close(Connection& connection) {
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, connection.fd, nullptr);
+    ::close(connection.fd);
+    // Буферы сохраняют емкость для следующего соединения в этом слоте
+    connection.fd = -1;
+    connection.in_used = 0;
+    connection.parsed = 0;
+    connection.out.clear();
+    connection.out_sent = 0;
+    connection.closing = false;
+    free_slots.push_back(connection.slot);
+}
+
+const std::string& SketchAggregator::bucketKey(std::string_view name, uint64_t bucket) {
+    // Номер интервала фиксированной длины в конце ключа: разные пары
+    // (имя, интервал) дают разные ключи без разделителя
+    key.assign(name.data(), name.size());
+    key.append(reinterpret_cast<const char*>(&bucket), sizeof(bucket));
+    return key;
+}
+
+SketchStore::Id SketchAggregator::bucketSketch(std::string_view name, uint64_t bucket) {
+    SketchStore::Id id = store.find(bucketKey(name, bucket));
+    if (id != SketchStore::NOT_FOUND) {
+        return id;
+    }
+    id = store.findOrCreate(key);
+
+    auto it = buckets.find(name);
+    if (it == buckets.end()) {
+        it = buckets.emplace(std::string(name), std::vector<uint64_t>()).first;
+    }
+    auto& list = it->second;
+    list.insert(std::upper_bound(list.begin(), list.end(), bucket), bucket);
+    return id;
+}
+
+uint64_t SketchAggregator::estimate(std::string_view name, uint64_t from, uint64_t to,
+                                    Estimator estimator, uint64_t* bucket_count) {
+    if (bucket_count) {
+        *bucket_count = 0;
+    }
+    auto it = buckets.find(name);
+    if (it == buckets.end()) {
+        return 0;
+    }
+    const auto& list = it->second;
+    const uint64_t first = from / bucket_seconds;
+    const uint64_t last = to ? to / bucket_seconds : UINT64_MAX;
+    auto begin = std::lower_bound(list.begin(), list.end(), first);
+    auto end = std::upper_bound(begin, list.end(), last);
+    const size_t count = static_cast<size_t>(end - begin);
+    if (bucket_count) {
+        *bucket_count = count;
+    }
+    if (count == 0) {
+        return 0;
+    }
+    if (count == 1) {
+        return store.estimate(store.find(bucketKey(name, *begin)), estimator);
+    }
+
+    const size_t m = store.getM();
+    uint8_t* merged = scratch.data();
+    std::memset(merged, 0, m);
+    for (auto b = begin; b != end; ++b) {
+        mergeMaxBytes(merged, store.registers(store.find(bucketKey(name, *b))), m);
+    }
+    RegisterHistogram histogram{};
+    for (size_t j = 0; j < m; ++j) {
+        ++histogram[merged[j]];
+    }
+    return estimateFromHistogram(histogram, store.getB(), store.getHashKind(), estimator);
+}
+
+AggregatorClient::AggregatorClient(const std::string& endpoint, size_t buffer_bytes)
+    : fd(connectSocket(endpoint)), buffer_bytes(buffer_bytes) {
+    out.reserve(buffer_bytes);
+}
+
+AggregatorClient::~AggregatorClient() {
+    try {
+        flush();
+    } catch (const std::exception&) {
+        // Деструктор не пробрасывает ошибку отправки
+    }
+    ::close(fd);
+}
+
+void AggregatorClient::appendHeader(FrameType type, std::string_view name, size_t body_bytes,
+                                    uint8_t estimator, uint64_t time_from, uint64_t time_to) {
+    if (name.size() > 255 || (type != FrameType::Stats && name.empty())) {
+        throw std::invalid_argument("Sketch name must be 1..255 bytes");
+    }
+    const size_t frame_bytes = sizeof(FrameHeader) + name.size() + body_bytes;
+    if (frame_bytes > MAX_FRAME_BYTES) {
+        throw std::invalid_argument("Frame exceeds MAX_FRAME_BYTES");
+    }
+    if (out.size() + frame_bytes > buffer_bytes) {
+        flush();
+    }
+
+    FrameHeader header{};
+    header.frame_bytes = static_cast<uint32_t>(frame_bytes);
+    header.type = static_cast<uint8_t>(type);
+    header.name_bytes = static_cast<uint8_t>(name.size());
+    header.estimator = estimator;
+    header.time_from = time_from;
+    header.time_to = time_to;
+    out.resize(out.size() + sizeof(FrameHeader));
+    storeFrameHeader(header, out.data() + out.size() - sizeof(FrameHeader));
+    out.insert(out.end(), name.begin(), name.end());
+}
+
+void AggregatorClient::merge(std::string_view name, const uint8_t* record, size_t record_bytes,
+                             uint64_t timestamp) {
+    appendHeader(FrameType::Merge, name, record_bytes, 0, timestamp, 0);
+    out.insert(out.end(), record, record + record_bytes);
+}
+
+void AggregatorClient::flush() {
+    if (!out.empty()) {
+        sendAll(fd, out.data(), out.size());
+        out.clear();
+    }
+}
+
+ReplyFrame AggregatorClient::request(FrameType expected) {
+    flush();
+    uint8_t bytes[sizeof(ReplyFrame)];
+    recvAll(fd, bytes, sizeof(bytes));
+    const ReplyFrame reply = loadReplyFrame(bytes);
+    if (reply.frame_bytes != sizeof(ReplyFrame) || reply.type != static_cast<uint8_t>(expected)) {
+        throw std::runtime_error("Unexpected reply from aggregator");
+    }
+    return reply;
+}
+
+uint64_t AggregatorClient::query(std::string_view name, uint64_t from, uint64_t to,
+                                 Estimator estimator) {
+    appendHeader(FrameType::Query, name, 0, static_cast<uint8_t>(estimator), from, to);
+    return request(FrameType::ReplyEstimate).value;
+}
+
+ReplyFrame AggregatorClient::stats() {
+    appendHeader(FrameType::Stats, std::string_view(), 0, 0, 0, 0);
+    return request(FrameType::ReplyStats);
+}
@@ -0,0 +1,235 @@
+#ifndef SKETCHAGGREGATOR_H
+#define SKETCHAGGREGATOR_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <map>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include "HashFuncGen.h"
+#include "Estimators.h"
+#include "SketchIO.h"
+#include "SketchStore.h"
+
+// Протокол агрегатора скетчей. Кадры идут подряд в потоке сокета (Unix
+// или TCP), все поля little-endian:
+//   0   uint32  frame_bytes  размер кадра целиком, включая заголовок
+//   4   uint8   type         FrameType
+//   5   uint8   name_bytes   длина имени скетча (1..255; 0 у Stats)
+//   6   uint8   estimator    Estimator для Query
+//   7   uint8   reserved     ноль
+//   8   uint64  time_from    Merge: время данных в секундах (0 - время
+//                            сервера); Query: начало интервала
+//   16  uint64  time_to      Query: конец интервала включительно
+//                            (0 - без ограничения)
+//   24  имя, у Merge за ним - запись скетча SketchIO.h (заголовок и данные)
+// Merge не подтверждается. На Query и Stats сервер отвечает кадром
+// ReplyFrame в порядке запросов; ответ на Stats приходит после обработки
+// всех ранее отправленных тем же соединением кадров и служит точкой
+// синхронизации. Нарушение формата кадра закрывает соединение; запись
+// с другими B, seed или хешем, неверной контрольной суммой,
+// недопустимыми значениями регистров и записей или временем вне окна
+// хранения отбрасывается (счетчик rejected)
+enum class FrameType : uint8_t {
+    Merge = 1,
+    Query = 2,
+    Stats = 3,
+    ReplyEstimate = 0x82,   // value - оценка, value2 - число объединенных интервалов
+    ReplyStats = 0x83       // value - объединенных записей, value2 - отброшенных
+};
+
+struct FrameHeader {
+    uint32_t frame_bytes;
+    uint8_t type;
+    uint8_t name_bytes;
+    uint8_t estimator;
+    uint8_t reserved;
+    uint64_t time_from;
+    uint64_t time_to;
+};
+
+struct ReplyFrame {
+    uint32_t frame_bytes;
+    uint8_t type;
+    uint8_t reserved[3];
+    uint64_t value;
+    uint64_t value2;
+};
+
+static_assert(sizeof(FrameHeader) == 24, "FrameHeader must be 24 bytes");
+static_assert(sizeof(ReplyFrame) == 24, "ReplyFrame must be 24 bytes");
+
+// Запись и разбор 24 байт заголовка кадра и ответа по полям в little-endian
+// (storeLittleEndian / loadLittleEndian, SketchIO.h)
+void storeFrameHeader(const FrameHeader& header, uint8_t* out);
+FrameHeader loadFrameHeader(const uint8_t* in);
+void storeReplyFrame(const ReplyFrame& reply, uint8_t* out);
+ReplyFrame loadReplyFrame(const uint8_t* in);
+
+// Наибольший допустимый кадр: запись плотного скетча с B = 18 и имя
+constexpr size_t MAX_FRAME_BYTES = (size_t(1) << 18) + 1024;
+
+// Адрес "unix:/путь" или "хост:порт" (TCP). Ошибки - std::runtime_error,
+// неверный формат адреса - std::invalid_argument
+int listenSocket(const std::string& endpoint);
+int connectSocket(const std::string& endpoint);
+
+// Счетчики сервера
+struct AggregatorStats {
+    uint64_t connections = 0;       // Принятые соединения
+    uint64_t frames = 0;            // Разобранные кадры всех типов
+    uint64_t merged = 0;            // Объединенные записи
+    uint64_t rejected = 0;          // Записи с другими параметрами, поврежденные, недопустимые
+                                    // или вне окна хранения
+    uint64_t evicted = 0;           // Интервалы, удаленные по окну хранения
+    uint64_t queries = 0;
+    uint64_t merge_batches = 0;     // Пакеты объединений (итерации с записями)
+    uint64_t protocol_errors = 0;   // Соединения, закрытые из-за формата кадра
+};
+
+// Сервер-агрегатор: однопоточный цикл epoll. Скетчи хранятся в SketchStore
+// по ключу (имя, интервал), где интервал - time / bucket_seconds; запросы
+// объединяют интервалы [from, to] одного имени.
+// Итерация poll(): чтение из всех готовых соединений в их буферы, разбор
+// всех полных кадров; записи не копируются - объединения собираются в
+// пакет (ключ скетча и HyperLogLogView поверх буфера соединения), пакет
+// сортируется по скетчу и применяется разом, затем выполняются запросы
+// и сдвигаются остатки буферов. Буферы соединений и пакета переиспользуются,
+// поэтому в установившемся режиме кадр не выделяет памяти; память
+// выделяется только при новом имени или интервале.
+// Окно хранения (retention_buckets > 0) - последние retention_buckets
+// интервалов по времени сервера: в начале итерации, в которой начался
+// новый интервал, более старые интервалы удаляются, их номера в
+// SketchStore достаются новым интервалам; записи со временем до начала
+// окна отбрасываются
+class SketchAggregator {
+public:
+    // Параметры скетчей (у всех входящих записей должны совпадать),
+    // длина интервала в секундах и окно хранения в интервалах (0 - без
+    // ограничения)
+    SketchAggregator(const std::string& endpoint, uint8_t b = 14, uint32_t seed = 42,
+                     HashKind kind = HashKind::Murmur3_32, uint64_t bucket_seconds = 60,
+                     uint64_t retention_buckets = 0);
+    ~SketchAggregator();
+
+    SketchAggregator(const SketchAggregator&) = delete;
+    SketchAggregator& operator=(const SketchAggregator&) = delete;
+
+    // Одна итерация: ожидание событий не дольше timeout_ms и их обработка
+    void poll(int timeout_ms);
+
+    // Итерации до установки stop
+    void run(const std::atomic<bool>& stop, int timeout_ms = 100);
+
+    // Оценка объединения интервалов [from, to] (в секундах, to = 0 - без
+    // ограничения) скетча name и число этих интервалов; 0, если их нет
+    uint64_t estimate(std::string_view name, uint64_t from = 0, uint64_t to = 0,
+                      Estimator estimator = Estimator::Classic, uint64_t* bucket_count = nullptr);
+
+    const AggregatorStats& getStats() const { return stats; }
+    size_t sketchCount() const { return store.size(); }
+    size_t memoryBytes() const { return store.memoryBytes(); }
+
+private:
+    struct Connection {
+        int fd = -1;
+        size_t slot = 0;             // Номер в connections
+        std::vector<uint8_t> in;     // Принятые байты: [0, in_used)
+        size_t in_used = 0;
+        size_t parsed = 0;           // Разобранный префикс in
+        std::vector<uint8_t> out;    // Неотправленные ответы: [out_sent, out.size())
+        size_t out_sent = 0;
+        uint32_t events = 0;         // Текущая подписка epoll
+        bool closing = false;
+    };
+
+    struct PendingMerge {
+        SketchStore::Id id;
+        HyperLogLogView view;
+    };
+
+    struct PendingQuery {
+        Connection* connection;
+        FrameHeader header;
+        std::string_view name;       // Имя в буфере соединения
+    };
+
+    std::string endpoint;
+    int listen_fd;
+    int epoll_fd;
+    uint64_t bucket_seconds;
+    uint64_t retention_buckets;
+    uint64_t first_bucket = 0;              // Начало окна хранения
+    SketchStore store;
+
+    // Интервалы каждого имени по возрастанию (ключи в store - имя и
+    // 8 байт номера интервала)
+    std::map<std::string, std::vector<uint64_t>, std::less<>> buckets;
+
+    std::vector<std::unique_ptr<Connection>> connections;   // Номер - данные epoll
+    std::vector<size_t> free_slots;
+    std::vector<PendingMerge> pending;
+    std::vector<PendingQuery> queries;
+    std::vector<Connection*> touched;       // Соединения, прочитанные в итерации
+    std::string key;                        // Буфер ключа
+    uint64_t now_seconds = 0;               // Время сервера в начале итерации
+    std::vector<uint8_t> scratch;           // Регистры объединения для запроса
+    AggregatorStats stats;
+
+    void evictExpired();
+    void accept();
+    void readFrom(Connection& connection);
+    void parseFrames(Connection& connection);
+    void applyMerges();
+    void answerQueries();
+    void finishConnection(Connection& connection);
+    void flushOutput(Connection& connection);
+    void updateInterest(Connection& connection);
+    void close(Connection& connection);
+
+    // Номер скетча (name, bucket), создается вместе с записью интервала
+    SketchStore::Id bucketSketch(std::string_view name, uint64_t bucket);
+    const std::string& bucketKey(std::string_view name, uint64_t bucket);
+};
+
+// Клиент с блокирующим сокетом. Кадры Merge накапливаются в буфере и
+// отправляются при его заполнении, в flush() и перед запросом
+class AggregatorClient {
+public:
+    explicit AggregatorClient(const std::string& endpoint, size_t buffer_bytes = 1 << 16);
+    ~AggregatorClient();
+
+    AggregatorClient(const AggregatorClient&) = delete;
+    AggregatorClient& operator=(const AggregatorClient&) = delete;
+
+    // Запись record (SketchIO.h, recordBytes() байт) для скетча name;
+    // timestamp в секундах, 0 - время сервера
+    void merge(std::string_view name, const uint8_t* record, size_t record_bytes,
+               uint64_t timestamp = 0);
+    void merge(std::string_view name, const std::vector<uint8_t>& record, uint64_t timestamp = 0) {
+        merge(name, record.data(), record.size(), timestamp);
+    }
+
+    void flush();
+
+    // Оценка объединения интервалов [from, to]
+    uint64_t query(std::string_view name, uint64_t from = 0, uint64_t to = 0,
+                   Estimator estimator = Estimator::Classic);
+
+    // Счетчики (объединено, отброшено) после обработки всех отправленных кадров
+    ReplyFrame stats();
+
+private:
+    int fd;
+    size_t buffer_bytes;
+    std::vector<uint8_t> out;
+
+    void appendHeader(FrameType type, std::string_view name, size_t body_bytes,
+                      uint8_t estimator, uint64_t time_from, uint64_t time_to);
+    ReplyFrame request(FrameType expected);
+};
+
+#endif // SKETCHAGGREGATOR_H
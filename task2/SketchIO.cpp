@@ -0,0 +1,264 @@
+#include "SketchIO.h"
+#include "HyperLogLog.h"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <nmmintrin.h>
+
+namespace {
+
+constexpr uint32_t CRC32C_POLY = 0x82F63B78;  // Отраженный полином 0x1EDC6F41
+
+constexpr std::array<uint32_t, 256> makeCrcTable() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int k = 0; k < 8; ++k) {
+            crc = (crc >> 1) ^ (crc & 1 ? CRC32C_POLY : 0);
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr std::array<uint32_t, 256> CRC_TABLE = makeCrcTable();
+
+uint32_t crc32cScalar(const uint8_t* data, size_t size, uint32_t crc) {
+    for (size_t i = 0; i < size; ++i) {
+        crc = (crc >> 8) ^ CRC_TABLE[(crc ^ data[i]) & 0xFF];
+    }
+    return crc;
+}
+
+// 8 байт за инструкцию crc32
+__attribute__((target("sse4.2")))
+uint32_t crc32cSse42(const uint8_t* data, size_t size, uint32_t crc) {
+    uint64_t crc64 = crc;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+    crc = static_cast<uint32_t>(crc64);
+    for (; i < size; ++i) {
+        crc = _mm_crc32_u8(crc, data[i]);
+    }
+    return crc;
+}
+
+// Размер данных плотной раскладки для m регистров
+size_t denseBytes(RegisterEncoding encoding, size_t m) {
+    switch (encoding) {
+        case RegisterEncoding::Byte:     return ByteRegisters::bytesFor(m);
+        case RegisterEncoding::Packed6:  return PackedRegisters6::bytesFor(m);
+        case RegisterEncoding::TailCut4: return TailCutRegisters4::bytesFor(m);
+        default:                         return 0;
+    }
+}
+
+// Наибольшее значение регистра плотной раскладки (у TailCut4 - без
+// переполнения суммы базы и смещения)
+unsigned maxDenseRegister(RegisterEncoding encoding, const uint8_t* raw, size_t m) {
+    unsigned top = 0;
+    switch (encoding) {
+        case RegisterEncoding::Byte: {
+            uint8_t value = 0;
+            for (size_t i = 0; i < m; ++i) {
+                value = std::max(value, raw[i]);
+            }
+            top = value;
+            break;
+        }
+        case RegisterEncoding::Packed6:
+            for (size_t i = 0; i < m; ++i) {
+                top = std::max<unsigned>(top, PackedRegisters6::getRaw(raw, m, i));
+            }
+            break;
+        case RegisterEncoding::TailCut4: {
+            uint8_t nibble = 0;
+            for (size_t i = 0; i < (m + 1) / 2; ++i) {
+                nibble = std::max<uint8_t>(nibble, std::max<uint8_t>(raw[i] & 0x0F, raw[i] >> 4));
+            }
+            top = raw[(m + 1) / 2] + nibble;
+            break;
+        }
+        default:
+            break;
+    }
+    return top;
+}
+
+} // namespace
+
+void storeSketchHeader(const SketchHeader& header, uint8_t* out) {
+    storeLittleEndian(out, header.magic, 4);
+    storeLittleEndian(out + 4, header.version, 2);
+    out[6] = header.b;
+    out[7] = header.hash_kind;
+    out[8] = header.encoding;
+    std::memcpy(out + 9, header.reserved, sizeof(header.reserved));
+    storeLittleEndian(out + 12, header.seed, 4);
+    storeLittleEndian(out + 16, header.payload_bytes, 4);
+    storeLittleEndian(out + 20, header.entry_count, 4);
+    storeLittleEndian(out + SKETCH_CHECKSUM_OFFSET, header.checksum, 4);
+    storeLittleEndian(out + 28, header.reserved2, 4);
+}
+
+SketchHeader loadSketchHeader(const uint8_t* in) {
+    SketchHeader header;
+    header.magic = static_cast<uint32_t>(loadLittleEndian(in, 4));
+    header.version = static_cast<uint16_t>(loadLittleEndian(in + 4, 2));
+    header.b = in[6];
+    header.hash_kind = in[7];
+    header.encoding = in[8];
+    std::memcpy(header.reserved, in + 9, sizeof(header.reserved));
+    header.seed = static_cast<uint32_t>(loadLittleEndian(in + 12, 4));
+    header.payload_bytes = static_cast<uint32_t>(loadLittleEndian(in + 16, 4));
+    header.entry_count = static_cast<uint32_t>(loadLittleEndian(in + 20, 4));
+    header.checksum = static_cast<uint32_t>(loadLittleEndian(in + SKETCH_CHECKSUM_OFFSET, 4));
+    header.reserved2 = static_cast<uint32_t>(loadLittleEndian(in + 28, 4));
+    return header;
+}
+
+uint32_t crc32c(const uint8_t* data, size_t size, uint32_t crc) {
+    static const bool has_sse42 = __builtin_cpu_supports("sse4.2");
+    crc = ~crc;
+    crc = has_sse42 ? crc32cSse42(data, size, crc) : crc32cScalar(data, size, crc);
+    return ~crc;
+}
+
+// ---------------------------------------------------------- HyperLogLogView
+
+HyperLogLogView::HyperLogLogView(const uint8_t* data, size_t size, bool verify)
+    : payload(nullptr), m(0) {
+    if (size < sizeof(SketchHeader)) {
+        throw std::invalid_argument("Sketch record is shorter than its header");
+    }
+    header = loadSketchHeader(data);
+
+    if (header.magic != SKETCH_MAGIC) {
+        throw std::invalid_argument("Not a HyperLogLog sketch record");
+    }
+    if (header.version != SKETCH_FORMAT_VERSION) {
+        throw std::invalid_argument("Unsupported sketch format version " +
+                                    std::to_string(header.version));
+    }
+    if (header.hash_kind > static_cast<uint8_t>(HashKind::Crc32c) ||
+        header.b < MIN_PRECISION || header.b > maxPrecision(static_cast<HashKind>(header.hash_kind)) ||
+        header.encoding > static_cast<uint8_t>(RegisterEncoding::Sparse)) {
+        throw std::invalid_argument("Invalid sketch parameters");
+    }
+    if (size - sizeof(SketchHeader) < header.payload_bytes) {
+        throw std::invalid_argument("Sketch record is truncated");
+    }
+
+    m = size_t(1) << header.b;
+    if (!isSparse() && header.payload_bytes != denseBytes(getEncoding(), m)) {
+        throw std::invalid_argument("Sketch payload size does not match B");
+    }
+    // Разреженный скетч переходит в плотный, когда список становится больше
+    // регистров, а линейный счет по 2^25 виртуальным регистрам конечен только
+    // при entry_count < 2^25
+    if (isSparse() && (header.payload_bytes > denseBytes(RegisterEncoding::Byte, m) ||
+                       header.entry_count >= (uint32_t(1) << SPARSE_PRECISION))) {
+        throw std::invalid_argument("Sparse sketch is larger than its dense form");
+    }
+
+    payload = data + sizeof(SketchHeader);
+    if (verify) {
+        uint32_t crc = crc32c(data, SKETCH_CHECKSUM_OFFSET);
+        crc = crc32c(payload, header.payload_bytes, crc);
+        if (crc != header.checksum) {
+            throw std::invalid_argument("Sketch checksum mismatch");
+        }
+    }
+
+    // Значения регистров и записей проверяются и без verify: от них
+    // зависят индексы таблиц и регистров при оценке и объединении
+    const HashKind kind = getHashKind();
+    if (isSparse()) {
+        if (checkSparseList(payload, header.payload_bytes, kind) != header.entry_count) {
+            throw std::invalid_argument("Sparse sketch entry count mismatch");
+        }
+    } else if (maxDenseRegister(getEncoding(), payload, m) >
+               static_cast<unsigned>(hashBits(kind) - header.b + 1)) {
+        throw std::invalid_argument("Sketch register value out of range");
+    }
+}
+
+uint8_t HyperLogLogView::get(size_t j) const {
+    switch (getEncoding()) {
+        case RegisterEncoding::Byte:     return ByteRegisters::getRaw(payload, m, j);
+        case RegisterEncoding::Packed6:  return PackedRegisters6::getRaw(payload, m, j);
+        case RegisterEncoding::TailCut4: return TailCutRegisters4::getRaw(payload, m, j);
+        default:
+            throw std::invalid_argument("Sparse sketch has no dense registers");
+    }
+}
+
+uint64_t HyperLogLogView::estimate() const {
+    double harmonic_sum = 0.0;
+    size_t zero_count = 0;
+    switch (getEncoding()) {
+        case RegisterEncoding::Byte:
+            registerSums<ByteRegisters>(payload, m, harmonic_sum, zero_count);
+            break;
+        case RegisterEncoding::Packed6:
+            registerSums<PackedRegisters6>(payload, m, harmonic_sum, zero_count);
+            break;
+        case RegisterEncoding::TailCut4:
+            registerSums<TailCutRegisters4>(payload, m, harmonic_sum, zero_count);
+            break;
+        case RegisterEncoding::Sparse:
+            return estimateSparse(header.entry_count);
+    }
+    return estimateFromSums(m, harmonic_sum, zero_count, getHashKind());
+}
+
+std::vector<HyperLogLogView> readSketchViews(const uint8_t* data, size_t size, bool verify) {
+    std::vector<HyperLogLogView> views;
+    size_t offset = 0;
+    while (offset < size) {
+        views.emplace_back(data + offset, size - offset, verify);
+        offset += views.back().recordBytes();
+    }
+    return views;
+}
+
+// --------------------------------------------------------------- MappedFile
+
+MappedFile::MappedFile(const std::string& path) : mapped(nullptr), length(0) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat " + path);
+    }
+    length = static_cast<size_t>(st.st_size);
+
+    // Пустой файл отобразить нельзя, он соответствует пустому буферу
+    if (length > 0) {
+        void* addr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot mmap " + path);
+        }
+        mapped = static_cast<const uint8_t*>(addr);
+    }
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (mapped != nullptr) {
+        ::munmap(const_cast<uint8_t*>(mapped), length);
+    }
+}
@@ -0,0 +1,160 @@
+#ifndef SKETCHIO_H
+#define SKETCHIO_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "HashFuncGen.h"
+#include "RegisterStorage.h"
+
+// Двоичный формат скетча, версия 1. Запись состоит из 32-байтового
+// заголовка и данных; все поля little-endian:
+//   0   uint32  magic          "HLLS"
+//   4   uint16  version        SKETCH_FORMAT_VERSION
+//   6   uint8   b              количество бит индекса
+//   7   uint8   hash_kind      HashKind
+//   8   uint8   encoding       RegisterEncoding
+//   9   uint8   reserved[3]    нули
+//   12  uint32  seed           seed хеш-функции
+//   16  uint32  payload_bytes  размер данных
+//   20  uint32  entry_count    число записей разреженного списка (иначе m)
+//   24  uint32  checksum       CRC32C байт 0..23 заголовка и данных
+//   28  uint32  reserved       нули
+// Данные плотного скетча - регистры в сериализованной раскладке
+// (RegisterStorage.h), разреженного - список varint-разностей записей.
+// Записи можно записывать в файл подряд: размер записи равен
+// 32 + payload_bytes
+struct SketchHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t b;
+    uint8_t hash_kind;
+    uint8_t encoding;
+    uint8_t reserved[3];
+    uint32_t seed;
+    uint32_t payload_bytes;
+    uint32_t entry_count;
+    uint32_t checksum;
+    uint32_t reserved2;
+};
+
+static_assert(sizeof(SketchHeader) == 32, "SketchHeader must be 32 bytes");
+
+constexpr uint32_t SKETCH_MAGIC = 0x534C4C48;  // "HLLS"
+constexpr uint16_t SKETCH_FORMAT_VERSION = 1;
+constexpr size_t SKETCH_CHECKSUM_OFFSET = 24;
+
+// Чтение и запись беззнакового поля из bytes байт в little-endian
+// независимо от порядка байтов процессора
+inline void storeLittleEndian(uint8_t* out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+inline uint64_t loadLittleEndian(const uint8_t* in, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+// Запись и разбор 32 байт заголовка по полям (раскладка выше)
+void storeSketchHeader(const SketchHeader& header, uint8_t* out);
+SketchHeader loadSketchHeader(const uint8_t* in);
+
+// CRC32C (полином Кастаньоли); при наличии SSE4.2 - инструкция crc32.
+// Значение crc предыдущего блока позволяет продолжить подсчет
+uint32_t crc32c(const uint8_t* data, size_t size, uint32_t crc = 0);
+
+// Дописывание записи в конец out: заголовок header (поля magic, version,
+// payload_bytes и checksum заполняются здесь) и payload_bytes байт данных,
+// которые записывает fill(uint8_t* payload)
+template <typename Fill>
+void appendSketchRecord(std::vector<uint8_t>& out, SketchHeader header,
+                        size_t payload_bytes, Fill fill) {
+    header.magic = SKETCH_MAGIC;
+    header.version = SKETCH_FORMAT_VERSION;
+    header.payload_bytes = static_cast<uint32_t>(payload_bytes);
+    header.checksum = 0;
+
+    const size_t offset = out.size();
+    out.resize(offset + sizeof(SketchHeader) + payload_bytes);
+    uint8_t* record = out.data() + offset;
+    storeSketchHeader(header, record);
+    fill(record + sizeof(SketchHeader));
+
+    uint32_t crc = crc32c(record, SKETCH_CHECKSUM_OFFSET);
+    crc = crc32c(record + sizeof(SketchHeader), payload_bytes, crc);
+    storeLittleEndian(record + SKETCH_CHECKSUM_OFFSET, crc, sizeof(crc));
+}
+
+// Скетч только для чтения поверх сериализованной записи (например, в
+// отображенном в память файле). Регистры не копируются: оценка и
+// объединение (BasicHyperLogLog::merge) работают прямо с данными записи.
+// Память должна оставаться доступной, пока существует view
+class HyperLogLogView {
+private:
+    const uint8_t* payload;
+    SketchHeader header;
+    size_t m;
+
+public:
+    // Разбор и проверка записи [data, data + size): магическое число,
+    // версия, параметры, размер данных, (если verify) контрольная сумма и
+    // содержимое: плотные регистры не больше hashBits - B + 1, разреженный
+    // список не длиннее m байт (плотных регистров) и проверяется
+    // checkSparseList (HyperLogLog.h) с entry_count < 2^25 записями.
+    // При ошибке выбрасывается std::invalid_argument
+    HyperLogLogView(const uint8_t* data, size_t size, bool verify = true);
+
+    // Оценка количества уникальных элементов (та же, что у скетча)
+    uint64_t estimate() const;
+
+    // Значение регистра j (только для плотных раскладок)
+    uint8_t get(size_t j) const;
+
+    uint8_t getB() const { return header.b; }
+    size_t getM() const { return m; }
+    uint32_t getSeed() const { return header.seed; }
+    HashKind getHashKind() const { return static_cast<HashKind>(header.hash_kind); }
+    RegisterEncoding getEncoding() const { return static_cast<RegisterEncoding>(header.encoding); }
+    bool isSparse() const { return getEncoding() == RegisterEncoding::Sparse; }
+
+    // Данные записи и их размер
+    const uint8_t* data() const { return payload; }
+    size_t payloadBytes() const { return header.payload_bytes; }
+
+    // Количество записей разреженного списка
+    size_t entryCount() const { return header.entry_count; }
+
+    // Полный размер записи (заголовок и данные)
+    size_t recordBytes() const { return sizeof(SketchHeader) + header.payload_bytes; }
+};
+
+// Разбор буфера из записей, записанных подряд
+std::vector<HyperLogLogView> readSketchViews(const uint8_t* data, size_t size,
+                                             bool verify = true);
+
+// Файл, отображенный в память только для чтения (mmap)
+class MappedFile {
+private:
+    const uint8_t* mapped;
+    size_t length;
+
+public:
+    // При ошибке открытия или отображения выбрасывается std::runtime_error
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return mapped; }
+    size_t size() const { return length; }
+};
+
+#endif // SKETCHIO_H
@@ -0,0 +1,421 @@
+#include "SketchStore.h"
+#include "SketchIO.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <cstdlib>
+#include <new>
+#include <emmintrin.h>
+#include <sys/mman.h>
+
+namespace {
+
+// Seed отпечатков имен; не связан с seed скетчей
+constexpr uint32_t KEY_SEED = 0x5bd1e995;
+
+// Расстояние предвыборки (в парах) при поиске имен и обновлении регистров
+constexpr size_t PREFETCH_DISTANCE = 8;
+
+inline uint32_t matchByte(const uint8_t* group, uint8_t value) {
+    __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    __m128i eq = _mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(value)));
+    return static_cast<uint32_t>(_mm_movemask_epi8(eq));
+}
+
+} // namespace
+
+SketchStore::SketchStore(uint8_t b, uint32_t seed, HashKind kind, size_t expected)
+    : B(b), m(size_t(1) << b), hasher(seed), key_hasher(KEY_SEED), kind(kind),
+      slab_shift(0), group_mask(0), deleted_slots(0), arena_used(ARENA_BLOCK), arena_bytes(0) {
+    if (b < MIN_PRECISION || b > maxPrecision(kind)) {
+        throw std::invalid_argument("B must be between 4 and 16 (18 with a 64-bit hash)");
+    }
+    slab_shift = 22 - B;  // SLAB_BYTES = 2^22
+
+    size_t capacity = GROUP;
+    while (capacity / 8 * 7 < expected) {
+        capacity *= 2;
+    }
+    allocateIndex(capacity);
+    names.reserve(expected);
+}
+
+void SketchStore::allocateIndex(size_t capacity) {
+    group_mask = capacity / GROUP - 1;
+    ctrl.assign(capacity, EMPTY);
+    slots.assign(capacity, Slot{0, nullptr});
+    deleted_slots = 0;
+}
+
+void SketchStore::insertSlot(const Slot& entry) {
+    size_t group = (entry.fingerprint >> 7) & group_mask;
+    for (size_t step = 1; ; ++step) {
+        // Свободны слоты EMPTY и DELETED - управляющие байты со старшим битом
+        __m128i group_ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&ctrl[group * GROUP]));
+        uint32_t free = static_cast<uint32_t>(_mm_movemask_epi8(group_ctrl));
+        if (free != 0) {
+            size_t index = group * GROUP + __builtin_ctz(free);
+            deleted_slots -= ctrl[index] == DELETED;
+            ctrl[index] = static_cast<uint8_t>(entry.fingerprint & 0x7F);
+            slots[index] = entry;
+            return;
+        }
+        group = (group + step) & group_mask;
+    }
+}
+
+void SketchStore::growIndex() {
+    std::vector<uint8_t> old_ctrl;
+    std::vector<Slot> old_slots;
+    old_ctrl.swap(ctrl);
+    old_slots.swap(slots);
+
+    // Метки DELETED отбрасываются; индекс удваивается, только если живые
+    // имена занимают больше половины допустимой загрузки
+    const size_t capacity = size() + 1 > old_ctrl.size() / 16 * 7 ? old_ctrl.size() * 2
+                                                                  : old_ctrl.size();
+    allocateIndex(capacity);
+    for (size_t i = 0; i < old_ctrl.size(); ++i) {
+        if (!(old_ctrl[i] & EMPTY)) {
+            insertSlot(old_slots[i]);
+        }
+    }
+}
+
+char* SketchStore::storeKey(std::string_view key, Id id) {
+    const size_t record = sizeof(Id) + sizeof(uint32_t) + key.size();
+    if (arena.empty() || record > ARENA_BLOCK - arena_used) {
+        size_t block = std::max(ARENA_BLOCK, record);
+        arena.emplace_back(new char[block]);
+        arena_bytes += block;
+        arena_used = 0;
+    }
+    char* dst = arena.back().get() + arena_used;
+    const uint32_t length = static_cast<uint32_t>(key.size());
+    std::memcpy(dst, &id, sizeof(id));
+    std::memcpy(dst + sizeof(id), &length, sizeof(length));
+    std::memcpy(dst + sizeof(id) + sizeof(length), key.data(), key.size());
+    arena_used += record;
+    return dst;
+}
+
+SketchStore::Id SketchStore::matchName(const char* record, std::string_view key) {
+    uint32_t length;
+    std::memcpy(&length, record + sizeof(Id), sizeof(length));
+    if (length != key.size() ||
+        std::memcmp(record + sizeof(Id) + sizeof(length), key.data(), key.size()) != 0) {
+        return NOT_FOUND;
+    }
+    Id id;
+    std::memcpy(&id, record, sizeof(id));
+    return id;
+}
+
+std::string_view SketchStore::keyOf(Id id) const {
+    uint32_t length;
+    std::memcpy(&length, names[id] + sizeof(Id), sizeof(length));
+    return std::string_view(names[id] + sizeof(Id) + sizeof(length), length);
+}
+
+SketchStore::Id SketchStore::find(std::string_view key, uint64_t fingerprint) const {
+    const uint8_t tag = static_cast<uint8_t>(fingerprint & 0x7F);
+    size_t group = (fingerprint >> 7) & group_mask;
+    for (size_t step = 1; ; ++step) {
+        const uint8_t* group_ctrl = &ctrl[group * GROUP];
+        for (uint32_t match = matchByte(group_ctrl, tag); match != 0; match &= match - 1) {
+            const Slot& entry = slots[group * GROUP + __builtin_ctz(match)];
+            if (entry.fingerprint == fingerprint) {
+                Id id = matchName(entry.name, key);
+                if (id != NOT_FOUND) {
+                    return id;
+                }
+            }
+        }
+        // Удаление оставляет DELETED, поэтому пустой слот означает конец цепочки
+        if (matchByte(group_ctrl, EMPTY) != 0) {
+            return NOT_FOUND;
+        }
+        group = (group + step) & group_mask;
+    }
+}
+
+size_t SketchStore::findSlot(std::string_view key, uint64_t fingerprint) const {
+    const uint8_t tag = static_cast<uint8_t>(fingerprint & 0x7F);
+    size_t group = (fingerprint >> 7) & group_mask;
+    for (size_t step = 1; ; ++step) {
+        const uint8_t* group_ctrl = &ctrl[group * GROUP];
+        for (uint32_t match = matchByte(group_ctrl, tag); match != 0; match &= match - 1) {
+            const size_t index = group * GROUP + __builtin_ctz(match);
+            if (slots[index].fingerprint == fingerprint &&
+                matchName(slots[index].name, key) != NOT_FOUND) {
+                return index;
+            }
+        }
+        if (matchByte(group_ctrl, EMPTY) != 0) {
+            return SIZE_MAX;
+        }
+        group = (group + step) & group_mask;
+    }
+}
+
+bool SketchStore::erase(std::string_view key) {
+    const size_t index = findSlot(key, key_hasher.hash64(key));
+    if (index == SIZE_MAX) {
+        return false;
+    }
+    const Id id = matchName(slots[index].name, key);
+    ctrl[index] = DELETED;
+    slots[index] = Slot{0, nullptr};
+    ++deleted_slots;
+    // Следующий владелец номера получает пустые регистры
+    std::memset(registersOf(id), 0, m);
+    free_ids.push_back(id);
+    return true;
+}
+
+SketchStore::Id SketchStore::findOrCreate(std::string_view key, uint64_t fingerprint) {
+    Id id = find(key, fingerprint);
+    if (id != NOT_FOUND) {
+        return id;
+    }
+    if (size() + deleted_slots + 1 > ctrl.size() / 8 * 7) {
+        growIndex();
+    }
+
+    if (!free_ids.empty()) {
+        // Номер удаленного скетча: регистры уже обнулены, запись имени
+        // переписывается на месте, если новое имя не длиннее
+        id = free_ids.back();
+        free_ids.pop_back();
+        char* record = names[id];
+        uint32_t length;
+        std::memcpy(&length, record + sizeof(Id), sizeof(length));
+        if (key.size() <= length) {
+            length = static_cast<uint32_t>(key.size());
+            std::memcpy(record + sizeof(Id), &length, sizeof(length));
+            std::memcpy(record + sizeof(Id) + sizeof(length), key.data(), key.size());
+        } else {
+            names[id] = storeKey(key, id);
+        }
+        insertSlot(Slot{fingerprint, names[id]});
+        return id;
+    }
+    if (names.size() >= NOT_FOUND) {
+        throw std::length_error("SketchStore is full");
+    }
+
+    id = static_cast<Id>(names.size());
+    if ((id >> slab_shift) == slabs.size()) {
+        // Слаб выровнен по 4 МБ и отдается под большие страницы: при
+        // случайных обращениях к гигабайтам регистров промахи TLB иначе
+        // обходятся дороже промахов кэша. Новый слаб заполнен нулями
+        void* memory = std::aligned_alloc(SLAB_BYTES, SLAB_BYTES);
+        if (memory == nullptr) {
+            throw std::bad_alloc();
+        }
+        madvise(memory, SLAB_BYTES, MADV_HUGEPAGE);
+        std::memset(memory, 0, SLAB_BYTES);
+        slabs.emplace_back(static_cast<uint8_t*>(memory));
+    }
+    names.push_back(storeKey(key, id));
+    insertSlot(Slot{fingerprint, names.back()});
+    return id;
+}
+
+SketchStore::Id SketchStore::find(std::string_view key) const {
+    return find(key, key_hasher.hash64(key));
+}
+
+SketchStore::Id SketchStore::findOrCreate(std::string_view key) {
+    return findOrCreate(key, key_hasher.hash64(key));
+}
+
+// Ранг совпадает с leadingZeros()/leadingZeros64() HyperLogLog: стоп-бит
+// на месте B-го бита сдвинутого хеша ограничивает его значением BITS - B + 1
+void SketchStore::applyHash(uint8_t* registers, uint32_t hash) const {
+    size_t j = hash >> (32 - B);
+    uint8_t rank = static_cast<uint8_t>(__builtin_clz((hash << B) | (1u << (B - 1))) + 1);
+    registers[j] = std::max(registers[j], rank);
+}
+
+void SketchStore::applyHash(uint8_t* registers, uint64_t hash) const {
+    size_t j = hash >> (64 - B);
+    uint8_t rank = static_cast<uint8_t>(__builtin_clzll((hash << B) | (1ULL << (B - 1))) + 1);
+    registers[j] = std::max(registers[j], rank);
+}
+
+void SketchStore::add(Id id, std::string_view item) {
+    if (hashBits(kind) == 64) {
+        applyHash(registersOf(id), hasher.hash64(item, kind));
+    } else {
+        applyHash(registersOf(id), hasher.hash(item));
+    }
+}
+
+void SketchStore::add(Id id, uint64_t item) {
+    if (hashBits(kind) == 64) {
+        applyHash(registersOf(id), hasher.hash64(item, kind));
+    } else {
+        applyHash(registersOf(id), hasher.hash(item));
+    }
+}
+
+void SketchStore::add(std::string_view key, std::string_view item) {
+    add(findOrCreate(key), item);
+}
+
+void SketchStore::add(std::string_view key, uint64_t item) {
+    add(findOrCreate(key), item);
+}
+
+template <typename Item>
+void SketchStore::addBatchImpl(const std::string_view* keys, const Item* items, size_t count) {
+    uint64_t key_hashes[BATCH];
+    uint8_t* targets[BATCH];
+    uint64_t hashes64[BATCH];
+    uint32_t hashes32[BATCH];
+
+    for (size_t offset = 0; offset < count; offset += BATCH) {
+        const size_t n = std::min(BATCH, count - offset);
+
+        // Проход 1: имена -> регистры скетчей. За 2 * PREFETCH_DISTANCE
+        // пар читаются управляющие байты и слоты группы индекса, за
+        // PREFETCH_DISTANCE - запись имени первого слота с тем же отпечатком
+        key_hasher.hashBatch64(keys + offset, n, key_hashes);
+        auto prefetchGroup = [&](size_t i) {
+            size_t group = (key_hashes[i] >> 7) & group_mask;
+            __builtin_prefetch(&ctrl[group * GROUP]);
+            __builtin_prefetch(&slots[group * GROUP]);
+        };
+        auto prefetchName = [&](size_t i) {
+            const uint64_t fingerprint = key_hashes[i];
+            size_t group = (fingerprint >> 7) & group_mask;
+            uint32_t match = matchByte(&ctrl[group * GROUP], static_cast<uint8_t>(fingerprint & 0x7F));
+            for (; match != 0; match &= match - 1) {
+                const Slot& entry = slots[group * GROUP + __builtin_ctz(match)];
+                if (entry.fingerprint == fingerprint) {
+                    __builtin_prefetch(entry.name);
+                    return;
+                }
+            }
+        };
+        for (size_t i = 0; i < std::min(n, 2 * PREFETCH_DISTANCE); ++i) {
+            prefetchGroup(i);
+        }
+        for (size_t i = 0; i < std::min(n, PREFETCH_DISTANCE); ++i) {
+            prefetchName(i);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (i + 2 * PREFETCH_DISTANCE < n) {
+                prefetchGroup(i + 2 * PREFETCH_DISTANCE);
+            }
+            if (i + PREFETCH_DISTANCE < n) {
+                prefetchName(i + PREFETCH_DISTANCE);
+            }
+            targets[i] = registersOf(findOrCreate(keys[offset + i], key_hashes[i]));
+        }
+
+        // Проходы 2 и 3: хеши элементов, затем регистры с предвыборкой
+        auto update = [&](const auto* hashes) {
+            constexpr int BITS = sizeof(*hashes) * 8;
+            for (size_t i = 0; i < std::min(n, PREFETCH_DISTANCE); ++i) {
+                __builtin_prefetch(targets[i] + (hashes[i] >> (BITS - B)), 1);
+            }
+            for (size_t i = 0; i < n; ++i) {
+                if (i + PREFETCH_DISTANCE < n) {
+                    const size_t ahead = i + PREFETCH_DISTANCE;
+                    __builtin_prefetch(targets[ahead] + (hashes[ahead] >> (BITS - B)), 1);
+                }
+                applyHash(targets[i], hashes[i]);
+            }
+        };
+        if (hashBits(kind) == 64) {
+            hasher.hashBatch64(items + offset, n, hashes64, kind);
+            update(hashes64);
+        } else {
+            hasher.hashBatch(items + offset, n, hashes32);
+            update(hashes32);
+        }
+    }
+}
+
+void SketchStore::addBatch(const std::string_view* keys, const std::string_view* items, size_t count) {
+    addBatchImpl(keys, items, count);
+}
+
+void SketchStore::addBatch(const std::string_view* keys, const uint64_t* items, size_t count) {
+    addBatchImpl(keys, items, count);
+}
+
+uint64_t SketchStore::estimate(Id id, Estimator estimator) const {
+    const uint8_t* registers = registersOf(id);
+    RegisterHistogram histogram{};
+    for (size_t j = 0; j < m; ++j) {
+        ++histogram[registers[j]];
+    }
+    return estimateFromHistogram(histogram, B, kind, estimator);
+}
+
+uint64_t SketchStore::estimate(std::string_view key, Estimator estimator) const {
+    Id id = find(key);
+    return id == NOT_FOUND ? 0 : estimate(id, estimator);
+}
+
+void SketchStore::mergeInto(std::string_view destination, std::string_view source) {
+    Id from = find(source);
+    if (from == NOT_FOUND) {
+        throw std::invalid_argument("Unknown sketch key in mergeInto");
+    }
+    // Индекс может вырасти, но слабы не переезжают
+    uint8_t* to = registersOf(findOrCreate(destination));
+    mergeMaxBytes(to, registersOf(from), m);
+}
+
+void SketchStore::mergeInto(std::string_view destination, const HyperLogLog& sketch) {
+    if (sketch.getB() != B || sketch.getSeed() != getSeed() || sketch.getHashKind() != kind) {
+        throw std::invalid_argument("Cannot merge HyperLogLog sketches with different B, seed or hash kind");
+    }
+    if (sketch.isSparse()) {
+        HyperLogLog dense = sketch;
+        dense.toDense();
+        mergeInto(destination, dense);
+        return;
+    }
+    mergeMaxBytes(registersOf(findOrCreate(destination)), sketch.getRegisters().data(), m);
+}
+
+void SketchStore::mergeInto(std::string_view destination, const HyperLogLogView& view) {
+    mergeInto(findOrCreate(destination), view);
+}
+
+void SketchStore::mergeInto(Id id, const HyperLogLogView& view) {
+    if (view.getB() != B || view.getSeed() != getSeed() || view.getHashKind() != kind) {
+        throw std::invalid_argument("Cannot merge HyperLogLog sketches with different B, seed or hash kind");
+    }
+    mergeViewIntoBytes(view, registersOf(id));
+}
+
+HyperLogLog SketchStore::toSketch(std::string_view key) const {
+    Id id = find(key);
+    if (id == NOT_FOUND) {
+        throw std::invalid_argument("Unknown sketch key in toSketch");
+    }
+    SketchHeader header{};
+    header.b = B;
+    header.hash_kind = static_cast<uint8_t>(kind);
+    header.encoding = static_cast<uint8_t>(RegisterEncoding::Byte);
+    header.seed = getSeed();
+    header.entry_count = static_cast<uint32_t>(m);
+    std::vector<uint8_t> record;
+    appendSketchRecord(record, header, ByteRegisters::bytesFor(m), [&](uint8_t* payload) {
+        std::memcpy(payload, registersOf(id), m);
+    });
+    return HyperLogLog::deserialize(record.data(), record.size());
+}
+
+size_t SketchStore::memoryBytes() const {
+    return slabs.size() * SLAB_BYTES + slabs.capacity() * sizeof(slabs[0]) +
+           ctrl.capacity() + slots.capacity() * sizeof(Slot) +
+           names.capacity() * sizeof(const char*) +
+           arena_bytes + arena.capacity() * sizeof(arena[0]);
+}
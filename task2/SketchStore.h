@@ -0,0 +1,167 @@
+#ifndef SKETCHSTORE_H
+#define SKETCHSTORE_H
+
+#include <vector>
+#include <string_view>
+#include <memory>
+#include <cstdlib>
+#include <cstdint>
+#include <cstddef>
+#include "HashFuncGen.h"
+#include "HyperLogLog.h"
+
+// Набор именованных скетчей (по скетчу на пользователя, URL, кампанию)
+// с общими B, seed и хешем. Отдельный HyperLogLog - это объект, вектор
+// регистров в куче и собственный HashFuncGen; миллионы таких объектов
+// дают миллионы выделений памяти и переходы по указателям. Здесь:
+//   - регистры (байт на регистр) лежат подряд в слабах по 4 МБ, скетч с
+//     номером id - m байт по фиксированному смещению в слабе;
+//   - имя скетча ищется в плоской хеш-таблице с группами по 16 слотов и
+//     управляющими байтами (как в DistinctCounter), слот хранит 64-битный
+//     отпечаток имени и указатель на запись в арене с номером скетча и
+//     именем; имена сравниваются целиком;
+//   - хеш-функция одна на весь набор.
+// Накладные расходы на скетч - около 60 байт сверх m байт регистров и
+// длины имени. Регистры совпадают с HyperLogLog тех же B, seed и хеша
+// в плотном представлении.
+// Удаленный скетч оставляет в индексе метку DELETED (цепочки поиска не
+// обрываются), его номер, регистры и запись имени в арене достаются
+// следующему новому скетчу (запись - если новое имя не длиннее)
+class SketchStore {
+public:
+    using Id = uint32_t;
+    static constexpr Id NOT_FOUND = UINT32_MAX;
+
+    // expected - ожидаемое количество скетчей (для резервирования индекса)
+    SketchStore(uint8_t b = 10, uint32_t seed = 42, HashKind kind = HashKind::Murmur3_32,
+                size_t expected = 0);
+
+    // Номер скетча с именем key (новый пустой скетч, если его нет)
+    Id findOrCreate(std::string_view key);
+
+    // Номер скетча или NOT_FOUND
+    Id find(std::string_view key) const;
+
+    // Удаление скетча key; false, если его нет. Номер удаленного скетча
+    // может быть выдан следующему findOrCreate
+    bool erase(std::string_view key);
+
+    // Добавление элемента item в скетч key (создается при необходимости)
+    void add(std::string_view key, std::string_view item);
+    void add(std::string_view key, uint64_t item);
+    void add(Id id, std::string_view item);
+    void add(Id id, uint64_t item);
+
+    // Пакетное добавление пар (keys[i], items[i]). Части по 256 пар
+    // обрабатываются в несколько проходов: векторное хеширование имен,
+    // поиск с конвейерной предвыборкой (группа индекса за 16 пар, запись
+    // имени в арене за 8), векторное хеширование элементов, обновление
+    // регистров с предвыборкой. Промахи кэша разных пар перекрываются,
+    // вместо того чтобы идти друг за другом
+    void addBatch(const std::string_view* keys, const std::string_view* items, size_t count);
+    void addBatch(const std::string_view* keys, const uint64_t* items, size_t count);
+
+    // Оценка количества уникальных элементов скетча (0 для неизвестного имени)
+    uint64_t estimate(std::string_view key, Estimator estimator = Estimator::Classic) const;
+    uint64_t estimate(Id id, Estimator estimator = Estimator::Classic) const;
+
+    // Объединение скетча source (или sketch) в скетч destination, который
+    // создается при необходимости. Неизвестный source, разные B, seed или
+    // хеш - std::invalid_argument
+    void mergeInto(std::string_view destination, std::string_view source);
+    void mergeInto(std::string_view destination, const HyperLogLog& sketch);
+
+    // Объединение сериализованной записи (SketchIO.h) в скетч destination
+    // (или с номером id) прямо из памяти записи, без промежуточного
+    // HyperLogLog; плотная запись любой раскладки или разреженная
+    void mergeInto(std::string_view destination, const HyperLogLogView& view);
+    void mergeInto(Id id, const HyperLogLogView& view);
+
+    // Копия скетча в виде HyperLogLog (неизвестное имя - std::invalid_argument)
+    HyperLogLog toSketch(std::string_view key) const;
+
+    // Регистры и имя существующего скетча с номером id
+    const uint8_t* registers(Id id) const { return registersOf(id); }
+    std::string_view keyOf(Id id) const;
+
+    // Количество скетчей
+    size_t size() const { return names.size() - free_ids.size(); }
+
+    // Объем памяти слабов, индекса и арены имен в байтах
+    size_t memoryBytes() const;
+
+    size_t getM() const { return m; }
+    uint8_t getB() const { return B; }
+    uint32_t getSeed() const { return hasher.getSeed(); }
+    HashKind getHashKind() const { return kind; }
+
+private:
+    static constexpr size_t SLAB_BYTES = 1 << 22;
+    static constexpr size_t GROUP = 16;
+    static constexpr uint8_t EMPTY = 0x80;
+    static constexpr uint8_t DELETED = 0xFE;  // Как и EMPTY, со старшим битом
+    static constexpr size_t ARENA_BLOCK = 1 << 20;
+    static constexpr size_t BATCH = 256;
+
+    uint8_t B;
+    size_t m;
+    HashFuncGen hasher;        // Хеш элементов
+    HashFuncGen key_hasher;    // Отпечатки имен
+    HashKind kind;
+
+    // Слабы регистров: 2^slab_shift скетчей в каждом (aligned_alloc)
+    struct SlabDeleter {
+        void operator()(uint8_t* slab) const { std::free(slab); }
+    };
+    std::vector<std::unique_ptr<uint8_t, SlabDeleter>> slabs;
+    size_t slab_shift;
+
+    // Слот индекса: отпечаток имени и запись имени в арене
+    struct Slot {
+        uint64_t fingerprint;
+        const char* name;
+    };
+
+    // Индекс имен
+    size_t group_mask;             // Количество групп - 1
+    std::vector<uint8_t> ctrl;     // Управляющие байты (EMPTY, DELETED или 7 бит отпечатка)
+    std::vector<Slot> slots;
+    size_t deleted_slots;          // Слоты DELETED
+
+    // Имена в арене: запись - номер скетча (Id), uint32_t длина и байты
+    // имени; names[id] - начало записи. Номер в записи избавляет поиск
+    // от перехода через names. free_ids - номера удаленных скетчей
+    std::vector<char*> names;
+    std::vector<Id> free_ids;
+    std::vector<std::unique_ptr<char[]>> arena;
+    size_t arena_used;
+    size_t arena_bytes;
+
+    uint8_t* registersOf(Id id) const {
+        return slabs[id >> slab_shift].get() + ((id & ((Id(1) << slab_shift) - 1)) << B);
+    }
+
+    void allocateIndex(size_t capacity);
+    void growIndex();
+    void insertSlot(const Slot& entry);
+    char* storeKey(std::string_view key, Id id);
+
+    // Номер скетча в записи арены, если имя записи равно key, иначе NOT_FOUND
+    static Id matchName(const char* record, std::string_view key);
+
+    // Позиция слота индекса с именем key или SIZE_MAX
+    size_t findSlot(std::string_view key, uint64_t fingerprint) const;
+
+    // Поиск и создание по готовому отпечатку имени
+    Id find(std::string_view key, uint64_t fingerprint) const;
+    Id findOrCreate(std::string_view key, uint64_t fingerprint);
+
+    // Индекс регистра и ранг для хеша элемента
+    void applyHash(uint8_t* registers, uint32_t hash) const;
+    void applyHash(uint8_t* registers, uint64_t hash) const;
+
+    template <typename Item>
+    void addBatchImpl(const std::string_view* keys, const Item* items, size_t count);
+};
+
+#endif // SKETCHSTORE_H
@@ -0,0 +1,158 @@
+#include "SlidingHyperLogLog.h"
+#include "HyperLogLog.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+constexpr int RANK_BITS = 6;
+constexpr uint64_t RANK_MASK = (1ULL << RANK_BITS) - 1;
+constexpr uint64_t MAX_TIMESTAMP = 1ULL << (64 - RANK_BITS);
+
+inline uint64_t entryTime(uint64_t entry) {
+    return entry >> RANK_BITS;
+}
+
+inline uint8_t entryRank(uint64_t entry) {
+    return static_cast<uint8_t>(entry & RANK_MASK);
+}
+
+} // namespace
+
+SlidingHyperLogLog::SlidingHyperLogLog(uint8_t b, uint64_t window_max, uint32_t seed, HashKind kind)
+    : B(b),
+      m(1ULL << b),
+      window_max(window_max),
+      hasher(seed),
+      kind(kind),
+      capacity(hashBits(kind) - b + 1),
+      latest(0),
+      empty(true) {
+    if (B < MIN_PRECISION || B > maxPrecision(kind)) {
+        throw std::invalid_argument("B must be between 4 and 16 (18 with a 64-bit hash)");
+    }
+    if (window_max == 0 || window_max >= MAX_TIMESTAMP) {
+        throw std::invalid_argument("Window must be between 1 and 2^58 - 1");
+    }
+    entries.assign(m * capacity, 0);
+    lengths.assign(m, 0);
+}
+
+void SlidingHyperLogLog::insert(size_t j, uint8_t rank, uint64_t timestamp) {
+    if (timestamp >= MAX_TIMESTAMP) {
+        throw std::invalid_argument("Timestamp must be below 2^58");
+    }
+    if (!empty && timestamp < latest) {
+        throw std::invalid_argument("Timestamps must be non-decreasing");
+    }
+    latest = timestamp;
+    empty = false;
+
+    uint64_t* list = &entries[j * capacity];
+    size_t length = lengths[j];
+
+    // Пары, вышедшие из наибольшего окна, - в начале списка
+    size_t first = 0;
+    while (first < length && entryTime(list[first]) + window_max <= timestamp) {
+        ++first;
+    }
+
+    // Пара того же момента с не меньшим рангом поглощает новую
+    if (first < length && entryTime(list[length - 1]) == timestamp &&
+        entryRank(list[length - 1]) >= rank) {
+        if (first != 0) {
+            std::memmove(list, list + first, (length - first) * sizeof(uint64_t));
+            lengths[j] = static_cast<uint8_t>(length - first);
+        }
+        return;
+    }
+
+    // Более ранние пары с рангом не больше нового уже не станут максимумом
+    while (length > first && entryRank(list[length - 1]) <= rank) {
+        --length;
+    }
+    if (first != 0) {
+        std::memmove(list, list + first, (length - first) * sizeof(uint64_t));
+        length -= first;
+    }
+    list[length++] = (timestamp << RANK_BITS) | rank;
+    lengths[j] = static_cast<uint8_t>(length);
+}
+
+void SlidingHyperLogLog::insertHash(uint32_t hash, uint64_t timestamp) {
+    uint32_t w = hash & ((1U << (32 - B)) - 1);
+    uint8_t rank = static_cast<uint8_t>(w ? __builtin_clz(w) - B + 1 : 32 - B + 1);
+    insert(hash >> (32 - B), rank, timestamp);
+}
+
+void SlidingHyperLogLog::insertHash(uint64_t hash, uint64_t timestamp) {
+    uint64_t w = hash & ((1ULL << (64 - B)) - 1);
+    uint8_t rank = static_cast<uint8_t>(w ? __builtin_clzll(w) - B + 1 : 64 - B + 1);
+    insert(hash >> (64 - B), rank, timestamp);
+}
+
+void SlidingHyperLogLog::add(std::string_view item, uint64_t timestamp) {
+    if (hashBits(kind) == 64) {
+        insertHash(hasher.hash64(item, kind), timestamp);
+    } else {
+        insertHash(hasher.hash(item), timestamp);
+    }
+}
+
+void SlidingHyperLogLog::add(uint64_t key, uint64_t timestamp) {
+    if (hashBits(kind) == 64) {
+        insertHash(hasher.hash64(key, kind), timestamp);
+    } else {
+        insertHash(hasher.hash(key), timestamp);
+    }
+}
+
+uint64_t SlidingHyperLogLog::estimate(uint64_t window) const {
+    return estimate(window, latest);
+}
+
+uint64_t SlidingHyperLogLog::estimate(uint64_t window, uint64_t now) const {
+    if (window == 0 || window > window_max) {
+        throw std::invalid_argument("Window must be between 1 and window_max");
+    }
+    if (!empty && now < latest) {
+        throw std::invalid_argument("Query time must not precede the last insertion");
+    }
+    if (empty) {
+        return 0;
+    }
+
+    // Значение регистра - ранг первой пары внутри окна: ранги убывают,
+    // поэтому она же максимальная
+    double harmonic_sum = 0.0;
+    size_t zero_count = 0;
+    for (size_t j = 0; j < m; ++j) {
+        const uint64_t* list = &entries[j * capacity];
+        const size_t length = lengths[j];
+        size_t i = 0;
+        while (i < length && entryTime(list[i]) + window <= now) {
+            ++i;
+        }
+        if (i == length) {
+            harmonic_sum += 1.0;
+            ++zero_count;
+        } else {
+            harmonic_sum += INV_POW2[entryRank(list[i])];
+        }
+    }
+    return estimateFromSums(m, harmonic_sum, zero_count, kind);
+}
+
+void SlidingHyperLogLog::clear() {
+    std::fill(lengths.begin(), lengths.end(), 0);
+    latest = 0;
+    empty = true;
+}
+
+size_t SlidingHyperLogLog::entryCount() const {
+    size_t total = 0;
+    for (uint8_t length : lengths) {
+        total += length;
+    }
+    return total;
+}
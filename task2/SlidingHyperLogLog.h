@@ -0,0 +1,78 @@
+#ifndef SLIDINGHYPERLOGLOG_H
+#define SLIDINGHYPERLOGLOG_H
+
+#include <vector>
+#include <cstdint>
+#include <string_view>
+#include "HashFuncGen.h"
+
+// HyperLogLog со скользящим окном (Chabchoub, Hébrail, "Sliding HyperLogLog").
+// Вместо одного максимума регистр j хранит список будущих возможных
+// максимумов (LPFM): пары (время, ранг), упорядоченные по возрастанию
+// времени со строго убывающим рангом. Пара удаляется, когда появляется
+// более поздняя пара с не меньшим рангом, - в любом окне, содержащем
+// старую пару, она уже не максимум. Значение регистра для окна длины w -
+// ранг первой пары со временем в (now - w, now].
+//
+// Время - произвольные целые единицы (секунды, миллисекунды) в [0, 2^58),
+// неубывающее от вызова к вызову. Окно запроса не больше window_max,
+// пары старше window_max удаляются при вставке.
+//
+// Память: ранги в списке строго убывают, поэтому в нем не больше
+// 33 - B (64 - B + 1 для 64-битного хеша) пар по 8 байт. Списки хранятся
+// в плоском массиве такой емкости, и объем фиксирован:
+//   m * (33 - B) * 8 + m байт, для B = 14 - 2.4 МБ (5.3 МБ для 64 бит).
+// Ожидаемая длина списка - около log2(n_w / m) + 1, где n_w - число
+// уникальных элементов в окне window_max
+class SlidingHyperLogLog {
+private:
+    uint8_t B;
+    size_t m;
+    uint64_t window_max;
+    HashFuncGen hasher;
+    HashKind kind;
+    size_t capacity;                 // Максимальная длина списка регистра
+    std::vector<uint64_t> entries;   // m списков по capacity пар (время << 6 | ранг)
+    std::vector<uint8_t> lengths;    // Длины списков
+    uint64_t latest;                 // Время последней вставки
+    bool empty;
+
+    // Вставка ранга rank в список регистра j в момент timestamp
+    void insert(size_t j, uint8_t rank, uint64_t timestamp);
+
+    void insertHash(uint32_t hash, uint64_t timestamp);
+    void insertHash(uint64_t hash, uint64_t timestamp);
+
+public:
+    // window_max - наибольшая длина окна запроса (в единицах времени)
+    SlidingHyperLogLog(uint8_t b = 14, uint64_t window_max = 3600, uint32_t seed = 42,
+                       HashKind kind = HashKind::Murmur3_32);
+
+    // Добавление элемента в момент timestamp (не меньше предыдущего)
+    void add(std::string_view item, uint64_t timestamp);
+    void add(uint64_t key, uint64_t timestamp);
+
+    // Оценка количества уникальных элементов со временем в (now - window, now],
+    // 1 <= window <= window_max. По умолчанию now - время последней вставки;
+    // now не может быть меньше него
+    uint64_t estimate(uint64_t window) const;
+    uint64_t estimate(uint64_t window, uint64_t now) const;
+
+    // Сброс всех списков
+    void clear();
+
+    size_t getM() const { return m; }
+    uint8_t getB() const { return B; }
+    uint64_t getWindowMax() const { return window_max; }
+    HashKind getHashKind() const { return kind; }
+
+    // Общее количество хранимых пар (для анализа заполнения)
+    size_t entryCount() const;
+
+    // Объем памяти в байтах (не зависит от потока, см. выше)
+    size_t memoryBytes() const {
+        return sizeof(*this) + entries.capacity() * sizeof(uint64_t) + lengths.capacity();
+    }
+};
+
+#endif // SLIDINGHYPERLOGLOG_H
@@ -0,0 +1,181 @@
+#include "StreamIngest.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <immintrin.h>
+
+namespace {
+
+// Ключ без завершающего '\r'; пустые ключи не добавляются
+inline void emitKey(const char* data, size_t length, std::string_view* keys, size_t& count) {
+    if (length > 0 && data[length - 1] == '\r') {
+        --length;
+    }
+    if (length > 0) {
+        keys[count++] = std::string_view(data, length);
+    }
+}
+
+// Разбиение [data, data + size) на строки, завершенные '\n', пока count < max.
+// Возвращает количество байт, занятых выданными строками
+size_t splitLinesScalar(const char* data, size_t size,
+                        std::string_view* keys, size_t max, size_t& count) {
+    size_t line_start = 0;
+    while (count < max) {
+        const void* newline = std::memchr(data + line_start, '\n', size - line_start);
+        if (newline == nullptr) {
+            break;
+        }
+        const size_t pos = static_cast<size_t>(static_cast<const char*>(newline) - data);
+        emitKey(data + line_start, pos - line_start, keys, count);
+        line_start = pos + 1;
+    }
+    return line_start;
+}
+
+// То же через маски переводов строк по 32 байта: при коротких ключах
+// вызов memchr на каждую строку стоит дороже самого поиска
+__attribute__((target("avx2,bmi")))
+size_t splitLinesAvx2(const char* data, size_t size,
+                      std::string_view* keys, size_t max, size_t& count) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    size_t line_start = 0;
+    size_t block = 0;
+    for (; block + 32 <= size && count < max; block += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + block));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, newline)));
+        // Переводы строк до line_start уже обработаны предыдущим вызовом
+        if (line_start > block) {
+            mask &= ~0U << (line_start - block);
+        }
+        while (mask != 0 && count < max) {
+            const size_t pos = block + _tzcnt_u32(mask);
+            mask = _blsr_u32(mask);
+            emitKey(data + line_start, pos - line_start, keys, count);
+            line_start = pos + 1;
+        }
+    }
+    if (count < max) {
+        line_start += splitLinesScalar(data + line_start, size - line_start, keys, max, count);
+    }
+    return line_start;
+}
+
+size_t splitLines(const char* data, size_t size,
+                  std::string_view* keys, size_t max, size_t& count) {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi");
+    return has_avx2 ? splitLinesAvx2(data, size, keys, max, count)
+                    : splitLinesScalar(data, size, keys, max, count);
+}
+
+} // namespace
+
+LineReader::LineReader(const std::string& path, bool use_mmap, size_t block_size)
+    : fd(-1), owns_fd(false), mapped(nullptr), mapped_size(0), position(0),
+      begin(0), end(0), eof(false), consumed(0) {
+    if (path == "-") {
+        fd = STDIN_FILENO;
+    } else {
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open " + path);
+        }
+        owns_fd = true;
+    }
+
+    struct stat st;
+    if (use_mmap && ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* addr = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            ::madvise(addr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+            mapped = static_cast<const char*>(addr);
+            mapped_size = static_cast<size_t>(st.st_size);
+            return;
+        }
+    }
+
+    // Каналы, терминалы и файлы, которые не удалось отобразить
+    buffer.resize(block_size);
+}
+
+LineReader::~LineReader() {
+    if (mapped != nullptr) {
+        ::munmap(const_cast<char*>(mapped), mapped_size);
+    }
+    if (owns_fd) {
+        ::close(fd);
+    }
+}
+
+bool LineReader::refill() {
+    if (eof) {
+        return false;
+    }
+
+    // Перенос хвоста в начало; строка длиннее буфера увеличивает его
+    const size_t tail = end - begin;
+    std::memmove(buffer.data(), buffer.data() + begin, tail);
+    begin = 0;
+    end = tail;
+    if (end == buffer.size()) {
+        buffer.resize(buffer.size() * 2);
+    }
+
+    while (true) {
+        ssize_t got = ::read(fd, buffer.data() + end, buffer.size() - end);
+        if (got > 0) {
+            end += static_cast<size_t>(got);
+            return true;
+        }
+        if (got == 0) {
+            eof = true;
+            return false;
+        }
+        if (errno != EINTR) {
+            throw std::runtime_error("Read error: " + std::string(std::strerror(errno)));
+        }
+    }
+}
+
+size_t LineReader::next(std::string_view* keys, size_t max) {
+    size_t count = 0;
+
+    if (mapped != nullptr) {
+        size_t used = splitLines(mapped + position, mapped_size - position, keys, max, count);
+        position += used;
+        // Остаток без '\n' в конце файла - последняя строка
+        if (count < max && position < mapped_size) {
+            used += mapped_size - position;
+            emitKey(mapped + position, mapped_size - position, keys, count);
+            position = mapped_size;
+        }
+        consumed += used;
+        return count;
+    }
+
+    // Буфер дочитывается, только пока не выдано ни одного ключа, иначе
+    // перенос хвоста сделал бы выданные ключи недействительными
+    while (count == 0) {
+        size_t used = splitLines(buffer.data() + begin, end - begin, keys, max, count);
+        begin += used;
+        consumed += used;
+        if (count != 0) {
+            break;
+        }
+        if (!eof) {
+            refill();
+        } else if (begin < end) {
+            // Последняя строка без '\n' в конце ввода
+            consumed += end - begin;
+            emitKey(buffer.data() + begin, end - begin, keys, count);
+            begin = end;
+        } else {
+            break;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,95 @@
+#ifndef STREAMINGEST_H
+#define STREAMINGEST_H
+
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+// Чтение ключей, разделенных '\n', из файла или стандартного ввода без
+// загрузки всего потока в память. Обычный файл отображается в память
+// (mmap с MADV_SEQUENTIAL), канал и терминал читаются блоками read().
+// Ключи выдаются как std::string_view прямо в отображение или буфер,
+// поэтому память под отдельные ключи не выделяется.
+// Завершающий '\r' отбрасывается, пустые строки пропускаются
+class LineReader {
+private:
+    int fd;
+    bool owns_fd;
+
+    // Режим mmap: весь файл и текущая позиция
+    const char* mapped;
+    size_t mapped_size;
+    size_t position;
+
+    // Режим read(): необработанные данные лежат в buffer[begin, end)
+    std::vector<char> buffer;
+    size_t begin;
+    size_t end;
+    bool eof;
+
+    uint64_t consumed;
+
+    // Дочитывание блока; необработанный хвост переносится в начало буфера.
+    // Возвращает false, если данных больше нет
+    bool refill();
+
+public:
+    static constexpr size_t DEFAULT_BLOCK = 4 << 20;
+
+    // path "-" - стандартный ввод. use_mmap = false включает чтение
+    // блоками read() и для обычных файлов.
+    // При ошибке открытия выбрасывается std::runtime_error
+    explicit LineReader(const std::string& path, bool use_mmap = true,
+                        size_t block_size = DEFAULT_BLOCK);
+    ~LineReader();
+
+    LineReader(const LineReader&) = delete;
+    LineReader& operator=(const LineReader&) = delete;
+
+    // Запись в keys не более max следующих ключей. Возвращает количество
+    // ключей, 0 - конец ввода. Ключи действительны до следующего вызова
+    size_t next(std::string_view* keys, size_t max);
+
+    // Количество обработанных байт входа
+    uint64_t bytesConsumed() const { return consumed; }
+
+    // Читается ли вход через mmap
+    bool isMapped() const { return mapped != nullptr; }
+};
+
+// Вставка всех ключей reader в sketch пакетами addBatch.
+// Каждые checkpoint_every ключей (0 - без контрольных точек) вызывается
+// on_checkpoint(records, estimate). Возвращает общее количество ключей
+template <typename Sketch, typename Checkpoint>
+uint64_t ingestLines(LineReader& reader, Sketch& sketch,
+                     uint64_t checkpoint_every, Checkpoint on_checkpoint) {
+    constexpr size_t BATCH = 1024;
+    std::string_view keys[BATCH];
+    uint64_t records = 0;
+
+    while (true) {
+        // Пакет не переходит через контрольную точку
+        size_t limit = BATCH;
+        if (checkpoint_every != 0) {
+            limit = static_cast<size_t>(std::min<uint64_t>(
+                BATCH, checkpoint_every - records % checkpoint_every));
+        }
+
+        size_t n = reader.next(keys, limit);
+        if (n == 0) {
+            break;
+        }
+        sketch.addBatch(keys, n);
+        records += n;
+
+        if (checkpoint_every != 0 && records % checkpoint_every == 0) {
+            on_checkpoint(records, sketch.estimate());
+        }
+    }
+    return records;
+}
+
+#endif // STREAMINGEST_H
@@ -0,0 +1,46 @@
+#ifndef SYNTHETICHASHES_H
+#define SYNTHETICHASHES_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Равномерно распределенные значения хеша для моделирования без строк:
+// ключу с номером i соответствует splitmix64(seed + (i + 1) * GAMMA).
+// При нечетном GAMMA номер -> состояние и финализатор splitmix64 взаимно
+// однозначны на 2^64 значениях, поэтому номера 0..n-1 дают n различных
+// 64-битных хешей: точное количество уникальных равно n по построению,
+// без генерации ключей и множества для точного подсчета. 32-битный хеш -
+// старшие 32 бита; у него, как у настоящего 32-битного хеша n различных
+// ключей, возможны совпадения. Значение зависит только от seed и i,
+// поэтому диапазоны номеров можно генерировать независимо
+class SyntheticHashes {
+public:
+    static constexpr uint64_t GAMMA = 0x9E3779B97F4A7C15ULL;
+
+    explicit SyntheticHashes(uint64_t seed) : seed(seed) {}
+
+    uint64_t operator()(uint64_t index) const {
+        uint64_t z = seed + (index + 1) * GAMMA;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // out[k] - хеш ключа first + k
+    void fill(uint64_t first, uint64_t* out, size_t count) const {
+        for (size_t k = 0; k < count; ++k) {
+            out[k] = (*this)(first + k);
+        }
+    }
+
+    void fill(uint64_t first, uint32_t* out, size_t count) const {
+        for (size_t k = 0; k < count; ++k) {
+            out[k] = static_cast<uint32_t>((*this)(first + k) >> 32);
+        }
+    }
+
+private:
+    uint64_t seed;
+};
+
+#endif // SYNTHETICHASHES_H
@@ -0,0 +1,125 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+namespace {
+
+// Пул и номер очереди текущего рабочего потока (nullptr вне пула)
+thread_local const WorkStealingPool* current_pool = nullptr;
+thread_local unsigned current_worker = 0;
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(unsigned threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::unique_lock<std::mutex> lock(state_mutex);
+        all_done.wait(lock, [this] { return pending == 0; });
+        stopping = true;
+    }
+    work_available.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task) {
+    const unsigned target = current_pool == this
+        ? current_worker
+        : static_cast<unsigned>(next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size());
+    {
+        // queued увеличивается под state_mutex до публикации задачи:
+        // поток, проверяющий queued перед сном, не пропустит уведомление,
+        // а счетчик не уходит в минус, если задачу сразу заберут
+        std::lock_guard<std::mutex> lock(state_mutex);
+        ++pending;
+        queued.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    work_available.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(state_mutex);
+    all_done.wait(lock, [this] { return pending == 0; });
+    if (error) {
+        std::exception_ptr first = error;
+        error = nullptr;
+        std::rethrow_exception(first);
+    }
+}
+
+bool WorkStealingPool::popLocal(unsigned id, Task& task) {
+    Queue& queue = *queues[id];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return true;
+}
+
+bool WorkStealingPool::steal(unsigned id, Task& task) {
+    const size_t count = queues.size();
+    for (size_t k = 1; k < count; ++k) {
+        Queue& victim = *queues[(id + k) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            stolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::finish(std::exception_ptr task_error) {
+    std::lock_guard<std::mutex> lock(state_mutex);
+    if (task_error && !error) {
+        error = task_error;
+    }
+    if (--pending == 0) {
+        all_done.notify_all();
+    }
+}
+
+void WorkStealingPool::workerLoop(unsigned id) {
+    current_pool = this;
+    current_worker = id;
+    for (;;) {
+        Task task;
+        if (popLocal(id, task) || steal(id, task)) {
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            std::exception_ptr task_error;
+            try {
+                task();
+            } catch (...) {
+                task_error = std::current_exception();
+            }
+            finish(task_error);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(state_mutex);
+        work_available.wait(lock, [this] {
+            return stopping || queued.load(std::memory_order_relaxed) > 0;
+        });
+        if (stopping && queued.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+    }
+}
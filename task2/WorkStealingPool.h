@@ -0,0 +1,76 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул потоков с перехватом задач (work stealing). У каждого потока своя
+// очередь: владелец берет задачи из начала, свободный поток забирает
+// задачу из конца чужой очереди. Задачи выполняются примерно в порядке
+// добавления, и потребитель, которому результаты нужны по порядку
+// (ExperimentRunner), получает их без долгого ожидания первых; перехват
+// забирает задачи, нужные позже всех. Задачи извне раскладываются по
+// очередям по кругу, задачи, добавленные из задачи, - в очередь текущего
+// потока. Неравные по стоимости задачи (потоки разной длины) не оставляют
+// потоки без работы, как при статическом делении на части в parallelIngest.
+// Очереди защищены собственными мьютексами: задачи здесь длятся
+// миллисекунды и дольше, и lock-free дек не дал бы заметного выигрыша
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    // threads = 0 - std::thread::hardware_concurrency()
+    explicit WorkStealingPool(unsigned threads = 0);
+
+    // Дожидается выполнения всех задач и останавливает потоки
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(Task task);
+
+    // Ожидание выполнения всех добавленных задач. Первое исключение,
+    // выброшенное задачей, пробрасывается отсюда
+    void wait();
+
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+    // Количество задач, выполненных не тем потоком, в чью очередь они попали
+    uint64_t stolenCount() const { return stolen.load(std::memory_order_relaxed); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex state_mutex;
+    std::condition_variable work_available;
+    std::condition_variable all_done;
+    std::atomic<size_t> queued{0};   // Задачи в очередях
+    size_t pending = 0;              // Добавленные и еще не выполненные задачи
+    bool stopping = false;
+    std::exception_ptr error;
+
+    std::atomic<size_t> next_queue{0};
+    std::atomic<uint64_t> stolen{0};
+
+    void workerLoop(unsigned id);
+    bool popLocal(unsigned id, Task& task);
+    bool steal(unsigned id, Task& task);
+    void finish(std::exception_ptr task_error);
+};
+
+#endif // WORKSTEALINGPOOL_H
@@ -0,0 +1,126 @@
+#include "ConcurrentHyperLogLog.h"
+#include "HyperLogLog.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+// Один общий скетч и много пишущих потоков: ConcurrentHyperLogLog
+// (add и addBatch) против HyperLogLog под мьютексом и против копии скетча
+// на поток с объединением в конце. Во время вставки отдельный поток
+// непрерывно вызывает estimate() общего скетча.
+// Использование: ./bench_concurrent [ключей] [максимум потоков]
+
+template <typename Fn>
+double runThreads(unsigned threads, Fn fn) {
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back(fn, t);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? std::stoul(argv[1]) : 20000000;
+    const unsigned max_threads = argc > 2 ? std::stoul(argv[2]) : 64;
+    
+    std::mt19937_64 rng(5);
+    std::vector<uint64_t> keys(count);
+    for (auto& key : keys) {
+        key = rng() % (count / 2);
+    }
+    HyperLogLog reference(14, 42);
+    reference.addBatch(keys.data(), keys.size());
+    
+    std::cout << "\n=== Общий скетч, " << count << " ключей (ядер: "
+              << std::thread::hardware_concurrency() << ") ===" << std::endl;
+    std::cout << "Последовательная оценка: " << reference.estimate() << std::endl;
+    std::cout << std::setw(8) << "Threads"
+              << std::setw(14) << "add, M/s"
+              << std::setw(16) << "addBatch, M/s"
+              << std::setw(14) << "mutex, M/s"
+              << std::setw(16) << "per-thread, M/s"
+              << std::setw(10) << "Queries"
+              << std::setw(8) << "Equal" << std::endl;
+    std::cout << std::string(86, '-') << std::endl;
+    
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        auto range = [&](unsigned t, size_t& begin, size_t& end) {
+            begin = count * t / threads;
+            end = count * (t + 1) / threads;
+        };
+        
+        ConcurrentHyperLogLog shared(14, 42);
+        double add_sec = runThreads(threads, [&](unsigned t) {
+            size_t begin, end;
+            range(t, begin, end);
+            for (size_t i = begin; i < end; ++i) {
+                shared.add(keys[i]);
+            }
+        });
+        
+        // addBatch с параллельными запросами оценки
+        ConcurrentHyperLogLog batched(14, 42);
+        std::atomic<bool> done(false);
+        uint64_t queries = 0;
+        std::thread reader([&] {
+            while (!done.load(std::memory_order_relaxed)) {
+                volatile uint64_t estimate = batched.estimate();
+                (void)estimate;
+                ++queries;
+            }
+        });
+        double batch_sec = runThreads(threads, [&](unsigned t) {
+            size_t begin, end;
+            range(t, begin, end);
+            batched.addBatch(keys.data() + begin, end - begin);
+        });
+        done = true;
+        reader.join();
+        
+        HyperLogLog locked(14, 42);
+        std::mutex lock;
+        double mutex_sec = runThreads(threads, [&](unsigned t) {
+            size_t begin, end;
+            range(t, begin, end);
+            for (size_t i = begin; i < end; ++i) {
+                std::lock_guard<std::mutex> guard(lock);
+                locked.add(keys[i]);
+            }
+        });
+        
+        std::vector<HyperLogLog> copies(threads, HyperLogLog(14, 42));
+        HyperLogLog merged(14, 42);
+        double copies_sec = runThreads(threads, [&](unsigned t) {
+            size_t begin, end;
+            range(t, begin, end);
+            copies[t].addBatch(keys.data() + begin, end - begin);
+        });
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& copy : copies) {
+            merged.merge(copy);
+        }
+        copies_sec += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        
+        bool equal = shared.snapshot().estimate() == reference.estimate() &&
+                     batched.estimate() == reference.estimate() &&
+                     locked.estimate() == reference.estimate() &&
+                     merged.estimate() == reference.estimate();
+        std::cout << std::setw(8) << threads
+                  << std::setw(14) << std::fixed << std::setprecision(1) << count / add_sec / 1e6
+                  << std::setw(16) << count / batch_sec / 1e6
+                  << std::setw(14) << count / mutex_sec / 1e6
+                  << std::setw(16) << count / copies_sec / 1e6
+                  << std::setw(10) << queries
+                  << std::setw(8) << (equal ? "yes" : "no") << std::endl;
+    }
+    
+    return 0;
+}
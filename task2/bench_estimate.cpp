@@ -0,0 +1,89 @@
+#include "HyperLogLog.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <string>
+
+// Прежняя реализация estimate(): полный проход по регистрам с std::pow
+uint64_t legacyEstimate(const HyperLogLog& hll) {
+    const auto& registers = hll.getRegisters();
+    const double m = static_cast<double>(hll.getM());
+    
+    double sum = 0.0;
+    int zero_count = 0;
+    for (uint8_t reg : registers) {
+        sum += std::pow(2.0, -static_cast<double>(reg));
+        if (reg == 0) {
+            zero_count++;
+        }
+    }
+    
+    double alpha;
+    switch (hll.getM()) {
+        case 16:    alpha = 0.673; break;
+        case 32:    alpha = 0.697; break;
+        case 64:    alpha = 0.709; break;
+        default:    alpha = 0.7213 / (1.0 + 1.079 / m);
+    }
+    
+    double estimate = alpha * m * m / sum;
+    if (estimate <= 2.5 * m && zero_count != 0) {
+        estimate = m * std::log(m / zero_count);
+    }
+    const double pow_32 = 4294967296.0;
+    if (estimate > pow_32 / 30.0) {
+        estimate = -pow_32 * std::log(1.0 - estimate / pow_32);
+    }
+    return static_cast<uint64_t>(estimate);
+}
+
+// Среднее время одного вызова fn в наносекундах.
+// Число повторов удваивается, пока замер не займет не менее 0.1 с
+template <typename Fn>
+double measureNs(Fn fn) {
+    volatile uint64_t sink = 0;
+    for (size_t iterations = 1; ; iterations *= 2) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            sink = sink + fn();
+        }
+        double sec = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        if (sec >= 0.1) {
+            return sec * 1e9 / iterations;
+        }
+    }
+}
+
+int main() {
+    std::cout << "=== Задержка estimate(): O(m) проход с pow против O(1) ===" << std::endl;
+    std::cout << std::setw(4) << "B"
+              << std::setw(10) << "m"
+              << std::setw(16) << "pow loop, ns"
+              << std::setw(16) << "O(1), ns"
+              << std::setw(12) << "Speedup"
+              << std::setw(12) << "Equal" << std::endl;
+    std::cout << std::string(70, '-') << std::endl;
+    
+    for (uint8_t B = 4; B <= 16; ++B) {
+        HyperLogLog hll(B, 42);
+        const size_t n = hll.getM() * 20;
+        for (size_t i = 0; i < n; ++i) {
+            hll.add("key-" + std::to_string(i));
+        }
+        
+        double legacy_ns = measureNs([&] { return legacyEstimate(hll); });
+        double fast_ns = measureNs([&] { return hll.estimate(); });
+        bool same = legacyEstimate(hll) == hll.estimate();
+        
+        std::cout << std::setw(4) << static_cast<int>(B)
+                  << std::setw(10) << hll.getM()
+                  << std::setw(16) << std::fixed << std::setprecision(1) << legacy_ns
+                  << std::setw(16) << fast_ns
+                  << std::setw(11) << std::setprecision(0) << (legacy_ns / fast_ns) << "x"
+                  << std::setw(12) << (same ? "yes" : "NO") << std::endl;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include "RandomStreamGen.h"
+#include "HyperLogLog.h"
+#include "DistinctCounter.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <new>
+#include <cstdlib>
+#include <unordered_set>
+
+// Точный подсчет уникальных элементов на потоках test_stage2:
+// std::unordered_set<std::string> (прежний exactCount) против
+// DistinctCounter в режимах Fingerprint и Verified.
+// Использование: ./bench_exact [потоков] [размер потока]
+
+static size_t allocated_bytes = 0;
+
+void* operator new(size_t size) {
+    allocated_bytes += size;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+struct Result {
+    double sec = 0.0;
+    size_t bytes = 0;
+    uint64_t distinct = 0;
+};
+
+// Время и суммарный объем выделений при построении множества
+// (для DistinctCounter включает таблицы, освобожденные при росте)
+template <typename Fn>
+void measure(Result& result, Fn fn) {
+    size_t before = allocated_bytes;
+    auto start = std::chrono::steady_clock::now();
+    result.distinct += fn();
+    result.sec += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.bytes = std::max(result.bytes, allocated_bytes - before);
+}
+
+int main(int argc, char* argv[]) {
+    const size_t num_streams = argc > 1 ? std::stoul(argv[1]) : 10;
+    const size_t stream_size = argc > 2 ? std::stoul(argv[2]) : 1000000;
+    
+    Result legacy, fingerprint, verified;
+    for (size_t stream_idx = 0; stream_idx < num_streams; ++stream_idx) {
+        RandomStreamGen streamGen(stream_size, 1000 + stream_idx * 100);
+        streamGen.generateStream();
+        const auto& stream = streamGen.getFullStream();
+        
+        measure(legacy, [&] {
+            std::unordered_set<std::string> unique_elements(stream.begin(), stream.end());
+            return unique_elements.size();
+        });
+        measure(fingerprint, [&] {
+            DistinctCounter counter(DistinctCounter::Mode::Fingerprint);
+            for (const auto& item : stream) {
+                counter.insert(item);
+            }
+            return counter.size();
+        });
+        measure(verified, [&] {
+            DistinctCounter counter(DistinctCounter::Mode::Verified);
+            for (const auto& item : stream) {
+                counter.insert(item);
+            }
+            return counter.size();
+        });
+    }
+    
+    std::cout << "\n=== Точный подсчет: " << num_streams << " потоков по "
+              << stream_size << " элементов ===" << std::endl;
+    std::cout << std::setw(26) << "Method"
+              << std::setw(10) << "Time, s"
+              << std::setw(12) << "Keys, M/s"
+              << std::setw(14) << "Alloc, MB"
+              << std::setw(14) << "Sum distinct" << std::endl;
+    std::cout << std::string(76, '-') << std::endl;
+    
+    auto print = [&](const std::string& name, const Result& r) {
+        std::cout << std::setw(26) << name
+                  << std::setw(10) << std::fixed << std::setprecision(2) << r.sec
+                  << std::setw(12) << num_streams * stream_size / r.sec / 1e6
+                  << std::setw(14) << r.bytes / 1048576.0
+                  << std::setw(14) << r.distinct << std::endl;
+    };
+    print("unordered_set<string>", legacy);
+    print("DistinctCounter/finger", fingerprint);
+    print("DistinctCounter/verified", verified);
+    
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include "FixedHyperLogLog.h"
+#include "HyperLogLog.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <string_view>
+
+// FixedHyperLogLog<B, Kind> (параметры при компиляции) против HyperLogLog
+// (параметры во время работы) для нескольких B: поэлементная и пакетная
+// вставка целочисленных и строковых ключей, время оценки.
+// Использование: ./bench_fixed [количество ключей]
+
+template <typename Fn>
+double rate(size_t count, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return count / sec / 1e6;
+}
+
+struct Workload {
+    std::vector<uint64_t> integers;
+    std::vector<std::string_view> strings;
+};
+
+template <uint8_t B, HashKind Kind>
+void compare(const Workload& work) {
+    const size_t count = work.integers.size();
+    HyperLogLog dynamic_add(B, 42, Kind), dynamic_batch(B, 42, Kind), dynamic_str(B, 42, Kind);
+    FixedHyperLogLog<B, Kind> fixed_add(42), fixed_batch(42), fixed_str(42);
+    
+    double d_add = rate(count, [&] { for (uint64_t x : work.integers) dynamic_add.add(x); });
+    double f_add = rate(count, [&] { for (uint64_t x : work.integers) fixed_add.add(x); });
+    double d_batch = rate(count, [&] { dynamic_batch.addBatch(work.integers.data(), count); });
+    double f_batch = rate(count, [&] { fixed_batch.addBatch(work.integers.data(), count); });
+    double d_str = rate(count, [&] { for (auto s : work.strings) dynamic_str.add(s); });
+    double f_str = rate(count, [&] { for (auto s : work.strings) fixed_str.add(s); });
+    
+    const int repeats = 1000;
+    uint64_t sink = 0;
+    double d_est = rate(repeats, [&] { for (int r = 0; r < repeats; ++r) sink += dynamic_add.estimate(); });
+    double f_est = rate(repeats, [&] { for (int r = 0; r < repeats; ++r) sink += fixed_add.estimate(); });
+    
+    bool same = fixed_str.estimate() == dynamic_str.estimate() && sink != 0;
+    for (size_t j = 0; j < dynamic_batch.getM(); ++j) {
+        same = same && fixed_batch.getRegisters()[j] == dynamic_batch.getRegisters().get(j);
+    }
+    std::cout << std::setw(4) << static_cast<int>(B)
+              << std::setw(6) << (Kind == HashKind::Murmur3_32 ? 32 : 64)
+              << std::fixed << std::setprecision(1)
+              << std::setw(10) << d_add << std::setw(9) << f_add
+              << std::setw(10) << d_batch << std::setw(9) << f_batch
+              << std::setw(10) << d_str << std::setw(9) << f_str
+              << std::setw(10) << 1000.0 / d_est << std::setw(9) << 1000.0 / f_est
+              << std::setw(7) << (same ? "yes" : "no") << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? std::stoul(argv[1]) : 20000000;
+    
+    std::mt19937_64 rng(3);
+    Workload work;
+    work.integers.resize(count);
+    for (auto& x : work.integers) {
+        x = rng() % (count / 2);
+    }
+    std::string buffer;
+    std::vector<size_t> lengths;
+    for (size_t i = 0; i < count; ++i) {
+        size_t length = 8 + rng() % 24;
+        lengths.push_back(length);
+        for (size_t k = 0; k < length; ++k) {
+            buffer.push_back(static_cast<char>('a' + rng() % 26));
+        }
+    }
+    for (size_t i = 0, offset = 0; i < count; offset += lengths[i++]) {
+        work.strings.emplace_back(buffer.data() + offset, lengths[i]);
+    }
+    
+    std::cout << "\n=== Параметры при компиляции и во время работы, " << count
+              << " ключей ===" << std::endl;
+    std::cout << "Скорость вставки в млн ключей/с (dyn - HyperLogLog, fix - FixedHyperLogLog),"
+              << " оценка в нс" << std::endl;
+    std::cout << std::setw(4) << "B" << std::setw(6) << "Hash"
+              << std::setw(10) << "add dyn" << std::setw(9) << "fix"
+              << std::setw(10) << "batch dyn" << std::setw(9) << "fix"
+              << std::setw(10) << "str dyn" << std::setw(9) << "fix"
+              << std::setw(10) << "est dyn" << std::setw(9) << "fix"
+              << std::setw(7) << "Same" << std::endl;
+    std::cout << std::string(84, '-') << std::endl;
+    
+    compare<10, HashKind::Murmur3_32>(work);
+    compare<12, HashKind::Murmur3_32>(work);
+    compare<14, HashKind::Murmur3_32>(work);
+    compare<16, HashKind::Murmur3_32>(work);
+    compare<14, HashKind::Murmur3_128>(work);
+    compare<16, HashKind::Murmur3_128>(work);
+    compare<17, HashKind::Murmur3_128>(work);
+    compare<18, HashKind::Murmur3_128>(work);
+    
+    return 0;
+}
@@ -0,0 +1,258 @@
+#include "HashPolicies.h"
+#include "HyperLogLog.h"
+#include "RandomStreamGen.h"
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Сравнение хеш-функций (HashPolicy<Kind>) по скорости и качеству:
+//   - нс на ключ и ГБ/с для длин 1..30 (как у RandomStreamGen) и пакетное
+//     хеширование смешанного потока RandomStreamGen (hashBatch / hashBatch64);
+//   - равномерность: chi^2 / df по 1024 корзинам старших бит для случайных
+//     строк и последовательных "key<номер>" (около 1 - норма);
+//   - лавинный эффект: средняя вероятность смены выходного бита при смене
+//     одного входного (идеал 0.5) и худшее отклонение |p - 0.5| по парам бит;
+//   - смещение и RMSE оценки HyperLogLog(14, seed, kind) по нескольким seed.
+// Использование: ./bench_hashes [ключей на замер скорости]
+
+namespace {
+
+const char CHARSET[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+constexpr size_t LENGTHS[] = {1, 2, 4, 8, 12, 16, 20, 24, 30};
+constexpr size_t POOL = 4096;
+constexpr uint32_t SEED = 42;
+constexpr size_t BATCH_CHUNK = 1024;
+
+std::vector<std::string> randomKeys(size_t count, size_t length, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::string> keys(count, std::string(length, ' '));
+    for (auto& key : keys) {
+        for (auto& c : key) {
+            c = CHARSET[rng() % (sizeof(CHARSET) - 1)];
+        }
+    }
+    return keys;
+}
+
+template <HashKind Kind>
+uint64_t hashOf(std::string_view key, uint32_t seed) {
+    return HashPolicy<Kind>::hash(key.data(), key.size(), seed);
+}
+
+template <HashKind Kind>
+double nsPerKey(const std::vector<std::string>& pool, size_t count) {
+    uint64_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        sink += hashOf<Kind>(pool[i & (POOL - 1)], SEED);
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    asm volatile("" : : "r"(sink));
+    return sec * 1e9 / count;
+}
+
+// Пакетное хеширование потока тем же путем, что и в HyperLogLog::addBatch:
+// кусками по BATCH_CHUNK ключей в буфер, который остается в кэше
+double batchKeysPerSecond(const std::vector<std::string_view>& stream, HashKind kind) {
+    HashFuncGen hasher(SEED);
+    std::vector<uint64_t> out64(BATCH_CHUNK);
+    std::vector<uint32_t> out32(BATCH_CHUNK);
+    uint64_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < 5; ++r) {
+        for (size_t offset = 0; offset < stream.size(); offset += BATCH_CHUNK) {
+            size_t n = std::min(BATCH_CHUNK, stream.size() - offset);
+            if (hashBits(kind) == 64) {
+                hasher.hashBatch64(stream.data() + offset, n, out64.data(), kind);
+                sink += out64[n - 1];
+            } else {
+                hasher.hashBatch(stream.data() + offset, n, out32.data());
+                sink += out32[n - 1];
+            }
+        }
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    asm volatile("" : : "r"(sink));
+    return 5.0 * stream.size() / sec;
+}
+
+template <HashKind Kind>
+double chiSquarePerDf(const std::vector<std::string>& keys) {
+    constexpr int BUCKET_BITS = 10;
+    constexpr int BITS = hashBits(Kind);
+    std::vector<uint64_t> buckets(size_t(1) << BUCKET_BITS);
+    for (const auto& key : keys) {
+        ++buckets[hashOf<Kind>(key, SEED) >> (BITS - BUCKET_BITS)];
+    }
+    const double expected = static_cast<double>(keys.size()) / buckets.size();
+    double chi2 = 0.0;
+    for (uint64_t count : buckets) {
+        chi2 += (count - expected) * (count - expected) / expected;
+    }
+    return chi2 / (buckets.size() - 1);
+}
+
+struct Avalanche {
+    double mean;    // Средняя вероятность смены выходного бита
+    double worst;   // max |p - 0.5| по парам (входной бит, выходной бит)
+};
+
+template <HashKind Kind>
+Avalanche avalanche(size_t length, size_t samples) {
+    constexpr int BITS = hashBits(Kind);
+    const size_t input_bits = length * 8;
+    std::vector<uint32_t> flips(input_bits * BITS);
+    std::mt19937_64 rng(length);
+    std::string key(length, '\0');
+    for (size_t s = 0; s < samples; ++s) {
+        for (auto& c : key) {
+            c = static_cast<char>(rng());
+        }
+        const uint64_t base = hashOf<Kind>(key, SEED);
+        for (size_t bit = 0; bit < input_bits; ++bit) {
+            key[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+            uint64_t diff = base ^ hashOf<Kind>(key, SEED);
+            key[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+            for (int out = 0; out < BITS; ++out) {
+                flips[bit * BITS + out] += (diff >> out) & 1;
+            }
+        }
+    }
+    Avalanche result{0.0, 0.0};
+    for (uint32_t count : flips) {
+        double p = static_cast<double>(count) / samples;
+        result.mean += p;
+        result.worst = std::max(result.worst, std::fabs(p - 0.5));
+    }
+    result.mean /= flips.size();
+    return result;
+}
+
+template <HashKind Kind>
+void printSpeedRow(const std::vector<std::vector<std::string>>& pools, size_t count) {
+    std::cout << std::left << std::setw(13) << HashPolicy<Kind>::NAME << std::right;
+    double ns = 0.0;
+    for (const auto& pool : pools) {
+        ns = nsPerKey<Kind>(pool, count);
+        std::cout << std::setw(7) << std::fixed << std::setprecision(2) << ns;
+    }
+    std::cout << std::setw(9) << std::setprecision(2) << pools.back()[0].size() / ns << std::endl;
+}
+
+template <HashKind Kind>
+void printQualityRow(const std::vector<std::string>& random_keys,
+                     const std::vector<std::string>& sequential_keys) {
+    Avalanche a8 = avalanche<Kind>(8, 20000);
+    Avalanche a16 = avalanche<Kind>(16, 20000);
+    std::cout << std::left << std::setw(13) << HashPolicy<Kind>::NAME << std::right
+              << std::fixed << std::setprecision(3)
+              << std::setw(10) << chiSquarePerDf<Kind>(random_keys)
+              << std::setw(10) << chiSquarePerDf<Kind>(sequential_keys)
+              << std::setprecision(4)
+              << std::setw(10) << a8.mean << std::setw(10) << a8.worst
+              << std::setw(10) << a16.mean << std::setw(10) << a16.worst << std::endl;
+}
+
+void printBiasRow(HashKind kind, const std::vector<std::string_view>& items,
+                  const std::vector<size_t>& sizes, unsigned seeds) {
+    std::cout << std::left << std::setw(13) << hashKindName(kind) << std::right;
+    for (size_t n : sizes) {
+        double sum = 0.0, sum_sq = 0.0;
+        for (unsigned s = 0; s < seeds; ++s) {
+            HyperLogLog hll(14, 1000 + s, kind);
+            hll.addBatch(items.data(), n);
+            double error = (static_cast<double>(hll.estimate()) - n) / n;
+            sum += error;
+            sum_sq += error * error;
+        }
+        std::cout << std::showpos << std::fixed << std::setprecision(2)
+                  << std::setw(9) << 100.0 * sum / seeds << std::noshowpos
+                  << std::setw(7) << 100.0 * std::sqrt(sum_sq / seeds);
+    }
+    std::cout << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? std::stoul(argv[1]) : 20000000;
+
+    std::cout << "=== Скорость: нс на ключ по длине ключа (последний столбец - ГБ/с при 30 байтах) ==="
+              << std::endl;
+    std::vector<std::vector<std::string>> pools;
+    std::cout << std::left << std::setw(13) << "hash" << std::right;
+    for (size_t length : LENGTHS) {
+        pools.push_back(randomKeys(POOL, length, length));
+        std::cout << std::setw(7) << length;
+    }
+    std::cout << std::setw(9) << "GB/s" << std::endl;
+    std::cout << std::string(13 + 7 * pools.size() + 9, '-') << std::endl;
+    printSpeedRow<HashKind::Murmur3_32>(pools, count);
+    printSpeedRow<HashKind::Murmur3_128>(pools, count);
+    printSpeedRow<HashKind::XXH64>(pools, count);
+    printSpeedRow<HashKind::WyHash>(pools, count);
+    printSpeedRow<HashKind::Crc32c>(pools, count);
+
+    std::cout << "\n=== Пакетное хеширование потока RandomStreamGen (длины 1..30) ===" << std::endl;
+    RandomStreamGen gen(1000000, 7);
+    ArenaStream arena = gen.generateArena(1);
+    std::vector<std::string_view> stream = arena.views();
+    size_t stream_bytes = 0;
+    for (auto key : stream) {
+        stream_bytes += key.size();
+    }
+    std::cout << std::left << std::setw(13) << "hash" << std::right
+              << std::setw(12) << "M keys/s" << std::setw(10) << "GB/s" << std::endl;
+    std::cout << std::string(35, '-') << std::endl;
+    for (size_t k = 0; k < HASH_KIND_COUNT; ++k) {
+        HashKind kind = static_cast<HashKind>(k);
+        double rate = batchKeysPerSecond(stream, kind);
+        std::cout << std::left << std::setw(13) << hashKindName(kind) << std::right
+                  << std::fixed << std::setprecision(1) << std::setw(12) << rate / 1e6
+                  << std::setprecision(2) << std::setw(10)
+                  << rate * stream_bytes / stream.size() / 1e9 << std::endl;
+    }
+
+    std::cout << "\n=== Равномерность (chi^2/df, 1024 корзины, 10^6 ключей) и лавинный эффект ==="
+              << std::endl;
+    std::vector<std::string> random_keys = randomKeys(1000000, 12, 99);
+    std::vector<std::string> sequential_keys;
+    sequential_keys.reserve(1000000);
+    for (size_t i = 0; i < 1000000; ++i) {
+        sequential_keys.push_back("key" + std::to_string(i));
+    }
+    std::cout << std::left << std::setw(13) << "hash" << std::right
+              << std::setw(10) << "random" << std::setw(10) << "key<i>"
+              << std::setw(10) << "aval8" << std::setw(10) << "worst8"
+              << std::setw(10) << "aval16" << std::setw(10) << "worst16" << std::endl;
+    std::cout << std::string(73, '-') << std::endl;
+    printQualityRow<HashKind::Murmur3_32>(random_keys, sequential_keys);
+    printQualityRow<HashKind::Murmur3_128>(random_keys, sequential_keys);
+    printQualityRow<HashKind::XXH64>(random_keys, sequential_keys);
+    printQualityRow<HashKind::WyHash>(random_keys, sequential_keys);
+    printQualityRow<HashKind::Crc32c>(random_keys, sequential_keys);
+
+    const unsigned seeds = 20;
+    const std::vector<size_t> sizes = {1000, 10000, 100000, 1000000};
+    std::cout << "\n=== HyperLogLog B = 14, ключи key<i>: смещение и RMSE, % (" << seeds
+              << " seed) ===" << std::endl;
+    std::vector<std::string_view> items(sequential_keys.begin(), sequential_keys.end());
+    std::cout << std::left << std::setw(13) << "hash" << std::right;
+    for (size_t n : sizes) {
+        std::cout << std::setw(9) << ("bias 1e" + std::to_string(std::lround(std::log10(n))))
+                  << std::setw(7) << "rmse";
+    }
+    std::cout << std::endl << std::string(13 + 16 * sizes.size(), '-') << std::endl;
+    for (size_t k = 0; k < HASH_KIND_COUNT; ++k) {
+        printBiasRow(static_cast<HashKind>(k), items, sizes, seeds);
+    }
+    std::cout << "Теоретическая стандартная ошибка 1.04/sqrt(2^14) = "
+              << std::setprecision(2) << 104.0 / 128.0 << "%" << std::endl;
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include "HyperLogLog.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <new>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+// Вставка ключей, лежащих в общем буфере: через временный std::string на
+// каждый ключ против string_view, (указатель, длина) и целочисленных ключей.
+// Считаются выделения памяти во время вставки.
+// Использование: ./bench_keys [количество ключей]
+
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    ++allocations;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+template <typename Fn>
+void run(const std::string& name, size_t count, Fn fn) {
+    HyperLogLog sketch(14, 42);
+    size_t before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    fn(sketch);
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::setw(30) << name
+              << std::setw(12) << std::fixed << std::setprecision(2) << count / sec / 1e6
+              << std::setw(14) << allocations - before
+              << std::setw(12) << sketch.estimate() << std::endl;
+}
+
+void printHeader() {
+    std::cout << std::setw(30) << "Method"
+              << std::setw(12) << "Keys, M/s"
+              << std::setw(14) << "Allocations"
+              << std::setw(12) << "Estimate" << std::endl;
+    std::cout << std::string(68, '-') << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? std::stoul(argv[1]) : 10000000;
+
+    // Строковые ключи - срезы одного буфера длиной 16..47 байт (ключи
+    // длиннее 15 символов не помещаются в SSO и требуют выделения)
+    std::mt19937_64 rng(7);
+    std::string buffer;
+    std::vector<std::string_view> slices;
+    std::vector<size_t> offsets;
+    std::vector<size_t> lengths;
+    buffer.reserve(count * 32);
+    for (size_t i = 0; i < count; ++i) {
+        size_t length = 16 + rng() % 32;
+        offsets.push_back(buffer.size());
+        lengths.push_back(length);
+        for (size_t k = 0; k < length; ++k) {
+            buffer.push_back(static_cast<char>('a' + rng() % 26));
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        slices.emplace_back(buffer.data() + offsets[i], lengths[i]);
+    }
+
+    std::vector<uint64_t> integers(count);
+    for (auto& x : integers) {
+        x = rng() % (count / 2);
+    }
+
+    std::cout << "\n=== Ключи без выделения памяти, " << count << " ключей ===" << std::endl;
+    std::cout << "\n--- Срезы строкового буфера ---" << std::endl;
+    printHeader();
+    run("add(std::string(slice))", count, [&](HyperLogLog& sketch) {
+        for (size_t i = 0; i < count; ++i) {
+            sketch.add(std::string(buffer.data() + offsets[i], lengths[i]));
+        }
+    });
+    run("add(string_view)", count, [&](HyperLogLog& sketch) {
+        for (const auto& slice : slices) {
+            sketch.add(slice);
+        }
+    });
+    run("add(ptr, len)", count, [&](HyperLogLog& sketch) {
+        for (size_t i = 0; i < count; ++i) {
+            sketch.add(buffer.data() + offsets[i], lengths[i]);
+        }
+    });
+    run("addBatch(string_view*)", count, [&](HyperLogLog& sketch) {
+        sketch.addBatch(slices.data(), slices.size());
+    });
+
+    std::cout << "\n--- Целочисленные ключи ---" << std::endl;
+    printHeader();
+    run("add(std::to_string(x))", count, [&](HyperLogLog& sketch) {
+        for (uint64_t x : integers) {
+            sketch.add(std::to_string(x));
+        }
+    });
+    run("add(&x, sizeof(x))", count, [&](HyperLogLog& sketch) {
+        for (const uint64_t& x : integers) {
+            sketch.add(&x, sizeof(x));
+        }
+    });
+    run("add(uint64_t)", count, [&](HyperLogLog& sketch) {
+        for (uint64_t x : integers) {
+            sketch.add(x);
+        }
+    });
+    run("addBatch(uint64_t*)", count, [&](HyperLogLog& sketch) {
+        sketch.addBatch(integers.data(), integers.size());
+    });
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include "MicroBench.h"
+#include "HashFuncGen.h"
+#include "HyperLogLog.h"
+#include "RandomStreamGen.h"
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+// Микробенчмарки основных операций: хеширование по длине ключа,
+// HyperLogLog::add и estimate для каждого B, exactCount и генерация
+// потока. Результаты - в stdout (таблица, CSV или JSON), ход - в stderr.
+// Использование: ./bench_micro [--format=table|csv|json] [--filter=подстрока]
+//                              [--min-time=секунды] [--repetitions=N] [--list]
+// make bench записывает JSON в bench_micro.json
+
+namespace {
+
+constexpr size_t KEY_POOL = 1 << 16;
+
+std::vector<std::string> randomKeys(size_t count, size_t length, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::string> keys(count);
+    for (auto& key : keys) {
+        key.resize(length);
+        for (auto& c : key) {
+            c = static_cast<char>('a' + rng() % 26);
+        }
+    }
+    return keys;
+}
+
+void registerHash(MicroBench& bench) {
+    for (size_t length : {4, 8, 16, 32, 64, 256, 1024}) {
+        auto keys = std::make_shared<const std::vector<std::string>>(randomKeys(1024, length, length));
+        bench.add("hash/" + std::to_string(length), [length, keys](BenchState& state) {
+            HashFuncGen hasher(42);
+            uint32_t sink = 0;
+            for (size_t i = 0; i < state.iterations(); ++i) {
+                sink ^= hasher.hash((*keys)[i & 1023]);
+            }
+            doNotOptimize(sink);
+            state.setItemsProcessed(state.iterations());
+            state.setBytesProcessed(state.iterations() * length);
+        });
+        bench.add("hash64/" + std::to_string(length), [length, keys](BenchState& state) {
+            HashFuncGen hasher(42);
+            uint64_t sink = 0;
+            for (size_t i = 0; i < state.iterations(); ++i) {
+                sink ^= hasher.hash64((*keys)[i & 1023]);
+            }
+            doNotOptimize(sink);
+            state.setItemsProcessed(state.iterations());
+            state.setBytesProcessed(state.iterations() * length);
+        });
+    }
+}
+
+void registerHyperLogLog(MicroBench& bench, const std::vector<std::string>& keys) {
+    for (uint8_t B = MIN_PRECISION; B <= 16; ++B) {
+        bench.add("hll_add/" + std::to_string(B), [B, &keys](BenchState& state) {
+            HyperLogLog hll(B);
+            for (size_t i = 0; i < state.iterations(); ++i) {
+                hll.add(keys[i & (KEY_POOL - 1)]);
+            }
+            doNotOptimize(hll.getRegisters().data());
+            state.setItemsProcessed(state.iterations());
+        });
+    }
+    for (uint8_t B = MIN_PRECISION; B <= 16; ++B) {
+        auto filled = std::make_shared<HyperLogLog>(B);
+        filled->addBatch(keys.data(), keys.size());
+        bench.add("hll_estimate/" + std::to_string(B), [filled](BenchState& state) {
+            uint64_t sink = 0;
+            for (size_t i = 0; i < state.iterations(); ++i) {
+                sink += filled->estimate();
+                doNotOptimize(*filled);
+            }
+            doNotOptimize(sink);
+            state.setItemsProcessed(state.iterations());
+        });
+        bench.add("hll_estimate_improved/" + std::to_string(B), [filled](BenchState& state) {
+            uint64_t sink = 0;
+            for (size_t i = 0; i < state.iterations(); ++i) {
+                sink += filled->estimate(Estimator::Improved);
+                doNotOptimize(*filled);
+            }
+            doNotOptimize(sink);
+            state.setItemsProcessed(state.iterations());
+        });
+    }
+}
+
+void registerExactAndStream(MicroBench& bench) {
+    for (size_t n : {10000, 100000, 1000000}) {
+        RandomStreamGen gen(n, 7);
+        gen.generateStream();
+        auto items = std::make_shared<const std::vector<std::string>>(gen.getFullStream());
+        bench.add("exact_count/" + std::to_string(n), [n, items](BenchState& state) {
+            uint64_t sink = 0;
+            for (size_t i = 0; i < state.iterations(); ++i) {
+                sink += exactCount(items->data(), items->size());
+            }
+            doNotOptimize(sink);
+            state.setItemsProcessed(state.iterations() * n);
+        });
+    }
+    for (size_t n : {10000, 100000}) {
+        bench.add("generate_stream/" + std::to_string(n), [n](BenchState& state) {
+            for (size_t i = 0; i < state.iterations(); ++i) {
+                RandomStreamGen gen(n, static_cast<unsigned>(i));
+                gen.generateStream();
+                doNotOptimize(gen.getFullStream().data());
+            }
+            state.setItemsProcessed(state.iterations() * n);
+        });
+        bench.add("generate_arena/" + std::to_string(n), [n](BenchState& state) {
+            for (size_t i = 0; i < state.iterations(); ++i) {
+                RandomStreamGen gen(n, static_cast<unsigned>(i));
+                ArenaStream arena = gen.generateArena(1);
+                doNotOptimize(arena.size());
+            }
+            state.setItemsProcessed(state.iterations() * n);
+        });
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    try {
+        options = MicroBench::parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    // generateStream() сообщает о ходе генерации в std::cout; до вывода
+    // результатов он перенаправляется в stderr, чтобы не портить CSV и JSON
+    std::streambuf* stdout_buffer = std::cout.rdbuf(std::cerr.rdbuf());
+
+    const std::vector<std::string> keys = randomKeys(KEY_POOL, 16, 1);
+    MicroBench bench;
+    registerHash(bench);
+    registerHyperLogLog(bench, keys);
+    registerExactAndStream(bench);
+
+    if (options.list_only) {
+        std::cout.rdbuf(stdout_buffer);
+        for (const auto& name : bench.names()) {
+            std::cout << name << "\n";
+        }
+        return 0;
+    }
+
+    auto results = bench.run(options, std::cerr);
+    std::cout.rdbuf(stdout_buffer);
+    MicroBench::print(results, options.format, std::cout);
+    return 0;
+}
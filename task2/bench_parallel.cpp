@@ -0,0 +1,66 @@
+#include "RandomStreamGen.h"
+#include "HyperLogLog.h"
+#include "ParallelIngest.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+
+// Масштабирование параллельной вставки от 1 до N потоков
+// на потоке из 1 000 000 элементов (как в test_stage2).
+// Использование: ./bench_parallel [N]
+int main(int argc, char* argv[]) {
+    const uint8_t B = 14;
+    const size_t stream_size = 1000000;
+    unsigned max_threads = std::max(1U, std::thread::hardware_concurrency());
+    if (argc > 1) {
+        max_threads = static_cast<unsigned>(std::atoi(argv[1]));
+    }
+    
+    RandomStreamGen streamGen(stream_size, 1000);
+    streamGen.generateStream();
+    const auto& stream = streamGen.getFullStream();
+    
+    HyperLogLog sequential(B, 42);
+    for (const auto& item : stream) {
+        sequential.add(item);
+    }
+    
+    std::cout << "\n=== Параллельная вставка, " << stream_size << " элементов, B = "
+              << static_cast<int>(B) << " ===" << std::endl;
+    std::cout << "Аппаратных потоков: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::setw(8) << "Threads"
+              << std::setw(12) << "Time, ms"
+              << std::setw(14) << "Mitems/s"
+              << std::setw(10) << "Speedup"
+              << std::setw(12) << "Identical" << std::endl;
+    std::cout << std::string(56, '-') << std::endl;
+    
+    double base_ms = 0.0;
+    for (unsigned threads = 1; threads <= max_threads; ++threads) {
+        // Лучшее из трех запусков
+        double best_ms = 1e100;
+        bool identical = true;
+        for (int rep = 0; rep < 3; ++rep) {
+            auto start = std::chrono::steady_clock::now();
+            HyperLogLog hll = parallelIngest(stream, threads, B, 42);
+            double ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            best_ms = std::min(best_ms, ms);
+            identical = identical && hll.getRegisters() == sequential.getRegisters() &&
+                        hll.estimate() == sequential.estimate();
+        }
+        if (threads == 1) {
+            base_ms = best_ms;
+        }
+        
+        std::cout << std::setw(8) << threads
+                  << std::setw(12) << std::fixed << std::setprecision(2) << best_ms
+                  << std::setw(14) << (stream_size / best_ms / 1e3)
+                  << std::setw(9) << (base_ms / best_ms) << "x"
+                  << std::setw(12) << (identical ? "yes" : "NO") << std::endl;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include "RandomStreamGen.h"
+#include "HyperLogLog.h"
+#include "PrefixEvaluator.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+// Оценка на 10 префиксах: копия каждого префикса с новым скетчем и
+// exactCount (прежняя схема test_stage2) против PrefixEvaluator.
+// Использование: ./bench_prefix [потоков] [размер потока]
+
+int main(int argc, char* argv[]) {
+    const size_t num_streams = argc > 1 ? std::stoul(argv[1]) : 10;
+    const size_t stream_size = argc > 2 ? std::stoul(argv[2]) : 1000000;
+    const std::vector<double> percentages = {10, 20, 30, 40, 50, 60, 70, 80, 90, 100};
+    PrefixEvaluator evaluator(percentages, 14, 42);
+    
+    double legacy_sec = 0.0;
+    double single_pass_sec = 0.0;
+    size_t mismatches = 0;
+    
+    for (size_t stream_idx = 0; stream_idx < num_streams; ++stream_idx) {
+        RandomStreamGen streamGen(stream_size, 1000 + stream_idx * 100);
+        streamGen.generateStream();
+        
+        auto start = std::chrono::steady_clock::now();
+        std::vector<uint64_t> exact;
+        std::vector<uint64_t> estimates;
+        for (double pct : percentages) {
+            auto part = streamGen.getStreamPart(pct);
+            exact.push_back(exactCount(part));
+            HyperLogLog hll(14, 42);
+            for (const auto& item : part) {
+                hll.add(item);
+            }
+            estimates.push_back(hll.estimate());
+        }
+        legacy_sec += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        
+        start = std::chrono::steady_clock::now();
+        auto snapshots = evaluator.evaluate(streamGen.getFullStream());
+        single_pass_sec += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        
+        for (size_t i = 0; i < snapshots.size(); ++i) {
+            mismatches += snapshots[i].exact_count != exact[i] ||
+                          snapshots[i].hll_estimate != estimates[i];
+        }
+    }
+    
+    std::cout << "\n=== Оценка префиксов: " << num_streams << " потоков по "
+              << stream_size << " элементов ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Копии префиксов + новые скетчи: " << legacy_sec << " с" << std::endl;
+    std::cout << "PrefixEvaluator (один проход):  " << single_pass_sec << " с" << std::endl;
+    std::cout << "Ускорение: x" << legacy_sec / single_pass_sec << std::endl;
+    std::cout << "Несовпадающих результатов: " << mismatches << std::endl;
+    
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include "RandomStreamGen.h"
+#include "HyperLogLog.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+
+// Сравнение способов хранения регистров: память на скетч,
+// скорость вставки и объединения, совпадение с байтовой раскладкой.
+// Использование: ./bench_registers [B]
+
+template <typename Fn>
+double measureSec(Fn fn) {
+    double best = 1e100;
+    for (int rep = 0; rep < 3; ++rep) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+template <typename Sketch>
+void runLayout(const std::string& name, uint8_t B,
+               const std::vector<std::string>& stream, const HyperLogLog& reference) {
+    Sketch sketch(B, 42);
+    double add_sec = measureSec([&] {
+        sketch.clear();
+        for (const auto& item : stream) {
+            sketch.add(item);
+        }
+    });
+    
+    Sketch batch(B, 42);
+    double batch_sec = measureSec([&] {
+        batch.clear();
+        batch.addBatch(stream);
+    });
+    
+    // Объединение двух скетчей половин потока
+    Sketch left(B, 42);
+    Sketch right(B, 42);
+    left.addBatch(stream.data(), stream.size() / 2);
+    right.addBatch(stream.data() + stream.size() / 2, stream.size() - stream.size() / 2);
+    const int merges = 1000;
+    double merge_sec = measureSec([&] {
+        for (int i = 0; i < merges; ++i) {
+            left.merge(right);
+        }
+    });
+    
+    // Количество регистров, отличающихся от байтовой раскладки,
+    // после вставки и после объединения
+    size_t differ = 0;
+    size_t merge_differ = 0;
+    for (size_t j = 0; j < sketch.getM(); ++j) {
+        differ += sketch.getRegisters()[j] != reference.getRegisters()[j];
+        merge_differ += left.getRegisters()[j] != reference.getRegisters()[j];
+    }
+    
+    std::cout << std::setw(10) << name
+              << std::setw(10) << sketch.getRegisters().bytes()
+              << std::setw(10) << sketch.memoryBytes()
+              << std::setw(12) << std::fixed << std::setprecision(2)
+              << (stream.size() / add_sec / 1e6)
+              << std::setw(14) << (stream.size() / batch_sec / 1e6)
+              << std::setw(12) << (merge_sec / merges * 1e6)
+              << std::setw(12) << sketch.estimate()
+              << std::setw(9) << differ
+              << std::setw(11) << merge_differ << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    const uint8_t B = argc > 1 ? static_cast<uint8_t>(std::stoi(argv[1])) : 14;
+    const size_t stream_size = 1000000;
+    
+    RandomStreamGen streamGen(stream_size, 2000);
+    streamGen.generateStream();
+    const auto& stream = streamGen.getFullStream();
+    
+    HyperLogLog reference(B, 42);
+    reference.addBatch(stream);
+    
+    std::cout << "\n=== Хранение регистров, B = " << static_cast<int>(B)
+              << ", " << stream_size << " элементов ===" << std::endl;
+    std::cout << std::setw(10) << "Layout"
+              << std::setw(10) << "Reg, B"
+              << std::setw(10) << "Total, B"
+              << std::setw(12) << "add, M/s"
+              << std::setw(14) << "batch, M/s"
+              << std::setw(12) << "merge, us"
+              << std::setw(12) << "Estimate"
+              << std::setw(9) << "Differ"
+              << std::setw(11) << "MergeDiff" << std::endl;
+    std::cout << std::string(100, '-') << std::endl;
+    
+    runLayout<HyperLogLog>("byte", B, stream, reference);
+    runLayout<PackedHyperLogLog>("packed6", B, stream, reference);
+    runLayout<TailCutHyperLogLog>("tailcut4", B, stream, reference);
+    
+    return 0;
+}
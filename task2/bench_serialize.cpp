@@ -0,0 +1,103 @@
+#include "HyperLogLog.h"
+#include "SketchIO.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+// Загрузка и объединение большого числа сериализованных скетчей:
+// чтение файла в память с десериализацией против HyperLogLogView
+// поверх mmap. Использование: ./bench_serialize [count] [B]
+
+const char* const SKETCH_FILE = "bench_sketches.bin";
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void printRow(const std::string& name, double sec, size_t count, uint64_t estimate, uint64_t expected) {
+    std::cout << std::setw(22) << name
+              << std::setw(12) << std::fixed << std::setprecision(1) << sec * 1e3
+              << std::setw(14) << std::setprecision(2) << count / sec / 1e6
+              << std::setw(12) << estimate
+              << std::setw(8) << (estimate == expected ? "yes" : "NO") << std::endl;
+}
+
+void runRepresentation(const std::string& name, Representation representation,
+                       size_t count, uint8_t B) {
+    // Скетч i содержит 100 ключей из общего пула в 10^6 ключей
+    const size_t keys_per_sketch = 100;
+    const size_t pool = 1000000;
+    HyperLogLog reference(B, 42);
+    std::vector<uint8_t> buffer;
+    std::vector<std::string> keys(keys_per_sketch);
+    for (size_t i = 0; i < count; ++i) {
+        HyperLogLog sketch(B, 42, HashKind::Murmur3_32, representation);
+        for (size_t k = 0; k < keys_per_sketch; ++k) {
+            keys[k] = "key-" + std::to_string((i * 7919 + k * 104729) % pool);
+        }
+        sketch.addBatch(keys);
+        sketch.serialize(buffer);
+        reference.merge(sketch);
+    }
+    const uint64_t expected = reference.estimate();
+
+    {
+        std::ofstream file(SKETCH_FILE, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    }
+
+    std::cout << "\n--- " << name << ": " << count << " скетчей, файл "
+              << std::fixed << std::setprecision(2) << buffer.size() / 1048576.0
+              << " МБ, " << buffer.size() / count << " Б на скетч ---" << std::endl;
+    std::cout << std::setw(22) << "Method"
+              << std::setw(12) << "Time, ms"
+              << std::setw(14) << "Sketches, M/s"
+              << std::setw(12) << "Estimate"
+              << std::setw(8) << "Match" << std::endl;
+    std::cout << std::string(68, '-') << std::endl;
+
+    // 1. Чтение файла в память и десериализация каждого скетча
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::ifstream file(SKETCH_FILE, std::ios::binary);
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)),
+                                  std::istreambuf_iterator<char>());
+        HyperLogLog total(B, 42);
+        size_t offset = 0;
+        while (offset < data.size()) {
+            HyperLogLogView view(data.data() + offset, data.size() - offset);
+            total.merge(HyperLogLog::fromView(view));
+            offset += view.recordBytes();
+        }
+        printRow("read + deserialize", secondsSince(start), count, total.estimate(), expected);
+    }
+
+    // 2. mmap и объединение напрямую из отображенного файла
+    for (bool verify : {true, false}) {
+        auto start = std::chrono::steady_clock::now();
+        MappedFile file(SKETCH_FILE);
+        HyperLogLog total(B, 42);
+        for (const auto& view : readSketchViews(file.data(), file.size(), verify)) {
+            total.merge(view);
+        }
+        printRow(verify ? "mmap view (crc)" : "mmap view (no crc)",
+                 secondsSince(start), count, total.estimate(), expected);
+    }
+
+    std::remove(SKETCH_FILE);
+}
+
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const uint8_t B = argc > 2 ? static_cast<uint8_t>(std::stoi(argv[2])) : 10;
+
+    std::cout << "\n=== Сериализация, B = " << static_cast<int>(B) << " ===" << std::endl;
+    std::cout << "Файл только что записан и находится в page cache" << std::endl;
+    runRepresentation("dense", Representation::Dense, count, B);
+    runRepresentation("sparse", Representation::Sparse, count, B);
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include "SetOps.h"
+#include "HyperLogLog.h"
+#include <iostream>
+#include <atomic>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <thread>
+
+// Оценка пересечений: точность включений-исключений, совместной ML-оценки
+// и явной оценки по D+/D- на парах с известным пересечением, затем
+// скорость pairwiseSimilarity на всех парах N скетчей.
+// Использование: ./bench_setops [N скетчей] [B]
+
+struct Error {
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    size_t count = 0;
+
+    void add(double estimate, double truth) {
+        double relative = (estimate - truth) / truth;
+        sum += relative;
+        sum_sq += relative * relative;
+        ++count;
+    }
+    double bias() const { return 100.0 * sum / count; }
+    double rmse() const { return 100.0 * std::sqrt(sum_sq / count); }
+};
+
+JointEstimate fastPair(const HyperLogLog& a, const HyperLogLog& b) {
+    PairwiseOptions options;
+    options.method = PairwiseMethod::Fast;
+    JointEstimate result{};
+    pairwiseSimilarity({a.getRegisters().data(), b.getRegisters().data()}, a.getB(), a.getHashKind(),
+                       [&](size_t, size_t, const JointEstimate& e) { result = e; }, options);
+    return result;
+}
+
+void accuracy(uint8_t B, size_t only_a, size_t only_b, size_t intersection, int trials) {
+    Error ie, ml, fast;
+    uint64_t next_key = 0;
+    for (int t = 0; t < trials; ++t) {
+        HyperLogLog a(B), b(B);
+        for (size_t i = 0; i < only_a; ++i) a.add(next_key++);
+        for (size_t i = 0; i < only_b; ++i) b.add(next_key++);
+        for (size_t i = 0; i < intersection; ++i) {
+            a.add(next_key);
+            b.add(next_key++);
+        }
+        a.toDense();
+        b.toDense();
+        // Для пустого пересечения ошибка считается относительно |A ∪ B|
+        double truth = intersection > 0 ? intersection : only_a + only_b;
+        double shift = intersection > 0 ? 0.0 : truth;
+        ie.add(inclusionExclusion(a, b).intersection + shift, truth);
+        ml.add(estimateJoint(a, b).intersection + shift, truth);
+        fast.add(fastPair(a, b).intersection + shift, truth);
+    }
+    std::cout << std::setw(9) << only_a << std::setw(9) << only_b << std::setw(9) << intersection
+              << std::fixed << std::setprecision(2)
+              << std::setw(9) << ie.bias() << std::setw(8) << ie.rmse()
+              << std::setw(9) << ml.bias() << std::setw(8) << ml.rmse()
+              << std::setw(9) << fast.bias() << std::setw(8) << fast.rmse() << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? std::stoul(argv[1]) : 10000;
+    const uint8_t B = argc > 2 ? static_cast<uint8_t>(std::stoul(argv[2])) : 14;
+    const int trials = 100;
+
+    std::cout << "\n=== Точность оценки |A ∩ B|, B = 12, " << trials << " повторов ===" << std::endl;
+    std::cout << "Относительные смещение и RMSE в % (при пустом пересечении - доля |A ∪ B|)"
+              << std::endl;
+    std::cout << std::setw(9) << "|A\\B|" << std::setw(9) << "|B\\A|" << std::setw(9) << "|A∩B|"
+              << std::setw(9) << "IE bias" << std::setw(8) << "RMSE"
+              << std::setw(9) << "ML bias" << std::setw(8) << "RMSE"
+              << std::setw(9) << "D± bias" << std::setw(8) << "RMSE" << std::endl;
+    std::cout << std::string(69, '-') << std::endl;
+    accuracy(12, 1000, 1000, 1000, trials);
+    accuracy(12, 50000, 50000, 0, trials);
+    accuracy(12, 50000, 50000, 50000, trials);
+    accuracy(12, 90000, 90000, 10000, trials);
+    accuracy(12, 99000, 99000, 1000, trials);
+    accuracy(12, 500000, 20000, 5000, trials);
+
+    // Скетчи - объединения 8 случайных из 64 базовых по 20000 ключей,
+    // так что у пар есть пересечения разного размера
+    std::cout << "\n=== Все пары " << count << " скетчей, B = " << static_cast<int>(B)
+              << " ===" << std::endl;
+    std::vector<HyperLogLog> base;
+    for (uint64_t s = 0; s < 64; ++s) {
+        HyperLogLog sketch(B);
+        for (uint64_t k = 0; k < 20000; ++k) {
+            sketch.add(s * 20000 + k);
+        }
+        sketch.toDense();
+        base.push_back(std::move(sketch));
+    }
+    std::mt19937_64 rng(7);
+    std::vector<HyperLogLog> sketches;
+    sketches.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        HyperLogLog sketch = base[rng() % 64];
+        for (int k = 1; k < 8; ++k) {
+            sketch.merge(base[rng() % 64]);
+        }
+        sketches.push_back(std::move(sketch));
+    }
+
+    const size_t pairs = count * (count - 1) / 2;
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::pair<unsigned, size_t>> configs = {{1u, 1}, {1u, 16}};
+    if (hardware > 1) {
+        configs.emplace_back(hardware, 16);
+    }
+    for (auto [threads, tile] : configs) {
+        PairwiseOptions options;
+        options.method = PairwiseMethod::Fast;
+        options.tile = tile;
+        options.threads = threads;
+        // callback вызывается из нескольких потоков: только счетчик похожих пар
+        std::atomic<size_t> similar(0);
+        auto start = std::chrono::steady_clock::now();
+        pairwiseSimilarity(sketches, [&](size_t, size_t, const JointEstimate& e) {
+            if (e.jaccard() > 0.5) {
+                similar.fetch_add(1, std::memory_order_relaxed);
+            }
+        }, options);
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "D±, потоков " << std::setw(3) << threads << ", блок " << std::setw(3) << tile
+                  << ": " << std::fixed << std::setprecision(2) << sec << " с, "
+                  << std::setprecision(1) << pairs / sec / 1e6 << " млн пар/с"
+                  << " (пар с J > 0.5: " << similar.load() << ")" << std::endl;
+    }
+
+    // Совместная ML-оценка на первых скетчах
+    const size_t subset = std::min<size_t>(count, 200);
+    std::vector<HyperLogLog> first(sketches.begin(), sketches.begin() + subset);
+    PairwiseOptions options;
+    options.method = PairwiseMethod::JointML;
+    double sum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    pairwiseSimilarity(first, [&](size_t, size_t, const JointEstimate& e) { sum += e.jaccard(); }, options);
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t ml_pairs = subset * (subset - 1) / 2;
+    std::cout << "ML, " << ml_pairs << " пар: " << std::fixed << std::setprecision(1)
+              << ml_pairs / sec / 1e3 << " тыс. пар/с (средний Жаккар "
+              << std::setprecision(4) << sum / ml_pairs << ")" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include "SlidingHyperLogLog.h"
+#include "HyperLogLog.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <unordered_set>
+#include <algorithm>
+
+// Уникальные элементы в скользящем окне: SlidingHyperLogLog против
+// скетча на каждую секунду с объединением последних w скетчей при запросе.
+// Использование: ./bench_sliding [секунд] [событий в секунду]
+
+template <typename Fn>
+double seconds(Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    const uint64_t duration = argc > 1 ? std::stoull(argv[1]) : 3600;
+    const uint64_t rate = argc > 2 ? std::stoull(argv[2]) : 2000;
+    const uint64_t key_space = 5000000;
+    const uint8_t B = 14;
+    const std::vector<uint64_t> windows = {1, 10, 60, 600, 3600};
+    
+    std::mt19937_64 rng(11);
+    std::vector<uint64_t> keys(duration * rate);
+    for (auto& key : keys) {
+        key = rng() % key_space;
+    }
+    
+    SlidingHyperLogLog sliding(B, duration, 42);
+    std::vector<HyperLogLog> buckets;
+    buckets.reserve(duration);
+    
+    double sliding_ingest = seconds([&] {
+        for (uint64_t t = 0; t < duration; ++t) {
+            for (uint64_t i = 0; i < rate; ++i) {
+                sliding.add(keys[t * rate + i], t);
+            }
+        }
+    });
+    double buckets_ingest = seconds([&] {
+        for (uint64_t t = 0; t < duration; ++t) {
+            buckets.emplace_back(B, 42);
+            buckets.back().addBatch(&keys[t * rate], rate);
+        }
+    });
+    size_t buckets_memory = 0;
+    for (const auto& bucket : buckets) {
+        buckets_memory += bucket.memoryBytes();
+    }
+    
+    std::cout << "\n=== Скользящее окно: " << duration << " с по " << rate
+              << " событий, B = " << static_cast<int>(B) << " ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Вставка: sliding " << sliding_ingest << " с, по секундам "
+              << buckets_ingest << " с" << std::endl;
+    std::cout << "Память: sliding " << sliding.memoryBytes() / 1048576.0 << " МБ (пар: "
+              << sliding.entryCount() << ", в среднем " << std::setprecision(2)
+              << static_cast<double>(sliding.entryCount()) / sliding.getM()
+              << " на регистр), по секундам " << buckets_memory / 1048576.0 << " МБ" << std::endl;
+    
+    std::cout << std::setw(8) << "Window"
+              << std::setw(10) << "Exact"
+              << std::setw(10) << "Sliding"
+              << std::setw(9) << "Err, %"
+              << std::setw(12) << "Query, us"
+              << std::setw(10) << "Merged"
+              << std::setw(9) << "Err, %"
+              << std::setw(12) << "Query, us" << std::endl;
+    std::cout << std::string(80, '-') << std::endl;
+    
+    const int repeats = 20;
+    size_t mismatches = 0;
+    for (uint64_t window : windows) {
+        if (window > duration) {
+            continue;
+        }
+        const uint64_t now = duration - 1;
+        
+        std::unordered_set<uint64_t> exact(keys.end() - window * rate, keys.end());
+        
+        uint64_t sliding_estimate = 0;
+        double sliding_sec = seconds([&] {
+            for (int r = 0; r < repeats; ++r) {
+                sliding_estimate = sliding.estimate(window, now);
+            }
+        }) / repeats;
+        
+        uint64_t merged_estimate = 0;
+        double merged_sec = seconds([&] {
+            for (int r = 0; r < repeats; ++r) {
+                HyperLogLog merged(B, 42);
+                for (uint64_t t = now + 1 - window; t <= now; ++t) {
+                    merged.merge(buckets[t]);
+                }
+                merged_estimate = merged.estimate();
+            }
+        }) / repeats;
+        
+        mismatches += sliding_estimate != merged_estimate;
+        auto error = [&](uint64_t estimate) {
+            return std::abs(static_cast<double>(estimate) - exact.size()) / exact.size() * 100.0;
+        };
+        std::cout << std::setw(8) << window
+                  << std::setw(10) << exact.size()
+                  << std::setw(10) << sliding_estimate
+                  << std::setw(9) << error(sliding_estimate)
+                  << std::setw(12) << sliding_sec * 1e6
+                  << std::setw(10) << merged_estimate
+                  << std::setw(9) << error(merged_estimate)
+                  << std::setw(12) << merged_sec * 1e6 << std::endl;
+    }
+    // Регистры окна совпадают с поэлементным максимумом скетчей по секундам
+    std::cout << "Оценки, отличные от объединения: " << mismatches << std::endl;
+    
+    return 0;
+}
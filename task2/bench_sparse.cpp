@@ -0,0 +1,72 @@
+#include "HyperLogLog.h"
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <string>
+
+// Разреженное представление на малых мощностях: объем памяти и ошибка
+// по сравнению с плотным скетчем, совпадение регистров после перехода.
+// Использование: ./bench_sparse [B]
+
+template <typename Sketch>
+void runKind(const std::string& name, uint8_t B, HashKind kind,
+             const std::vector<std::string>& stream) {
+    std::cout << "\n--- " << name << " ---" << std::endl;
+    std::cout << std::setw(10) << "n"
+              << std::setw(8) << "Mode"
+              << std::setw(12) << "Sparse, B"
+              << std::setw(12) << "Dense, B"
+              << std::setw(12) << "Sparse est"
+              << std::setw(12) << "Dense est"
+              << std::setw(11) << "Sparse err"
+              << std::setw(11) << "Dense err" << std::endl;
+    std::cout << std::string(88, '-') << std::endl;
+    
+    for (size_t n = 10; n <= stream.size(); n *= 10) {
+        Sketch sparse(B, 42, kind, Representation::Sparse);
+        Sketch dense(B, 42, kind);
+        sparse.addBatch(stream.data(), n);
+        dense.addBatch(stream.data(), n);
+        
+        const double sparse_est = static_cast<double>(sparse.estimate());
+        const double dense_est = static_cast<double>(dense.estimate());
+        std::cout << std::setw(10) << n
+                  << std::setw(8) << (sparse.isSparse() ? "sparse" : "dense")
+                  << std::setw(12) << sparse.memoryBytes()
+                  << std::setw(12) << dense.memoryBytes()
+                  << std::setw(12) << static_cast<uint64_t>(sparse_est)
+                  << std::setw(12) << static_cast<uint64_t>(dense_est)
+                  << std::setw(10) << std::fixed << std::setprecision(2)
+                  << std::fabs(sparse_est - n) / n * 100 << "%"
+                  << std::setw(10) << std::fabs(dense_est - n) / n * 100 << "%" << std::endl;
+        
+        // После перехода регистры должны совпасть с плотным скетчем
+        sparse.toDense();
+        size_t differ = 0;
+        for (size_t j = 0; j < dense.getM(); ++j) {
+            differ += sparse.getRegisters()[j] != dense.getRegisters()[j];
+        }
+        if (differ != 0) {
+            std::cout << "  ОШИБКА: после toDense() отличается регистров: " << differ << std::endl;
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const uint8_t B = argc > 1 ? static_cast<uint8_t>(std::stoi(argv[1])) : 14;
+    
+    // Поток из уникальных элементов: мощность префикса равна его длине
+    std::vector<std::string> stream;
+    stream.reserve(1000000);
+    for (size_t i = 0; i < 1000000; ++i) {
+        stream.push_back("key-" + std::to_string(i));
+    }
+    
+    std::cout << "\n=== Разреженное представление, B = " << static_cast<int>(B)
+              << " ===" << std::endl;
+    runKind<HyperLogLog>("byte, 32-bit", B, HashKind::Murmur3_32, stream);
+    runKind<HyperLogLog>("byte, 64-bit", B, HashKind::Murmur3_128, stream);
+    runKind<PackedHyperLogLog>("packed6, 64-bit", B, HashKind::Murmur3_128, stream);
+    
+    return 0;
+}
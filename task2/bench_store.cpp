@@ -0,0 +1,117 @@
+#include "SketchStore.h"
+#include "HyperLogLog.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <malloc.h>
+#include <unistd.h>
+
+// Миллион именованных скетчей: SketchStore (слабы регистров и плоский
+// индекс имен) против std::unordered_map<std::string, HyperLogLog>.
+// События - пары (имя скетча, 64-битный ключ) с равномерно выбранным
+// именем. Выводятся скорость вставки и прирост RSS процесса.
+// Использование: ./bench_store [скетчей] [событий] [B]
+
+// Резидентная память процесса в МБ (/proc/self/statm). Освобожденная
+// предыдущими замерами память сначала возвращается системе
+double residentMb() {
+    malloc_trim(0);
+    std::ifstream statm("/proc/self/statm");
+    size_t total = 0, resident = 0;
+    statm >> total >> resident;
+    return resident * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1 << 20);
+}
+
+template <typename Fn>
+double rate(size_t count, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return count / sec / 1e6;
+}
+
+void report(const char* name, double mevents, double rss_mb, size_t sketches) {
+    std::cout << std::left << std::setw(30) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << mevents
+              << std::setprecision(0) << std::setw(10) << rss_mb
+              << std::setprecision(1) << std::setw(12) << rss_mb * (1 << 20) / sketches << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t sketches = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const size_t events = argc > 2 ? std::stoul(argv[2]) : 20000000;
+    const uint8_t B = argc > 3 ? static_cast<uint8_t>(std::stoul(argv[3])) : 10;
+
+    std::vector<std::string> names(sketches);
+    for (size_t i = 0; i < sketches; ++i) {
+        names[i] = "user:" + std::to_string(i * 7919 % 100000007);
+    }
+    std::mt19937_64 rng(11);
+    std::vector<std::string_view> event_keys(events);
+    std::vector<uint64_t> items(events);
+    for (size_t i = 0; i < events; ++i) {
+        event_keys[i] = names[rng() % sketches];
+        items[i] = rng() % (sketches * 64);
+    }
+
+    std::cout << "\n=== " << sketches << " скетчей, B = " << static_cast<int>(B) << ", "
+              << events << " событий ===" << std::endl;
+    std::cout << "Способ                             млн/с   RSS, МБ  байт/скетч" << std::endl;
+    std::cout << std::string(62, '-') << std::endl;
+
+    std::vector<uint8_t> reference;
+    {
+        double before = residentMb();
+        SketchStore store(B);
+        double speed = rate(events, [&] {
+            for (size_t i = 0; i < events; ++i) {
+                store.add(event_keys[i], items[i]);
+            }
+        });
+        report("SketchStore::add", speed, residentMb() - before, store.size());
+        reference.assign(store.registers(0), store.registers(0) + store.getM());
+    }
+    bool same = true;
+    {
+        double before = residentMb();
+        SketchStore store(B, 42, HashKind::Murmur3_32, sketches);
+        double speed = rate(events, [&] { store.addBatch(event_keys.data(), items.data(), events); });
+        report("SketchStore::addBatch", speed, residentMb() - before, store.size());
+        std::cout << "  memoryBytes: " << store.memoryBytes() / (1 << 20) << " МБ" << std::endl;
+        for (size_t j = 0; j < store.getM(); ++j) {
+            same = same && store.registers(0)[j] == reference[j];
+        }
+    }
+    for (Representation representation : {Representation::Dense, Representation::Sparse}) {
+        double before = residentMb();
+        std::unordered_map<std::string, HyperLogLog> map;
+        double speed = rate(events, [&] {
+            for (size_t i = 0; i < events; ++i) {
+                auto it = map.find(std::string(event_keys[i]));
+                if (it == map.end()) {
+                    it = map.emplace(std::string(event_keys[i]),
+                                     HyperLogLog(B, 42, HashKind::Murmur3_32, representation)).first;
+                }
+                it->second.add(items[i]);
+            }
+        });
+        report(representation == Representation::Dense ? "unordered_map, HLL Dense"
+                                                       : "unordered_map, HLL Sparse",
+               speed, residentMb() - before, map.size());
+
+        // Первый скетч add() - первое имя из событий
+        HyperLogLog first = map.at(std::string(event_keys[0]));
+        first.toDense();
+        for (size_t j = 0; j < first.getM(); ++j) {
+            same = same && first.getRegisters().get(j) == reference[j];
+        }
+    }
+    std::cout << "Регистры совпадают: " << (same ? "да" : "нет") << std::endl;
+
+    return 0;
+}
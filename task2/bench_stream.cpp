@@ -0,0 +1,109 @@
+#include "HyperLogLog.h"
+#include "StreamIngest.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include <string>
+
+// Скорость потоковой вставки из файла: генерируется файл ключей заданного
+// размера, затем он читается через mmap и read() с вставкой в скетч.
+// Использование: ./bench_stream [ГБ] [файл]
+
+const uint64_t DISTINCT = 10000000;
+
+// Файл из строк "key-<x>", x = i * 0x9E3779B1 mod DISTINCT; множитель взаимно
+// прост с DISTINCT, поэтому первые DISTINCT строк попарно различны
+uint64_t writeKeys(const std::string& path, uint64_t target_bytes) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        throw std::runtime_error("Cannot create " + path);
+    }
+    std::vector<char> block(1 << 20);
+    size_t used = 0;
+    uint64_t written = 0;
+    uint64_t lines = 0;
+    while (written + used < target_bytes) {
+        if (block.size() - used < 32) {
+            std::fwrite(block.data(), 1, used, file);
+            written += used;
+            used = 0;
+        }
+        uint64_t x = (lines++ * 0x9E3779B1ULL) % DISTINCT;
+        std::memcpy(block.data() + used, "key-", 4);
+        char* end = std::to_chars(block.data() + used + 4, block.data() + block.size(), x).ptr;
+        *end++ = '\n';
+        used = static_cast<size_t>(end - block.data());
+    }
+    std::fwrite(block.data(), 1, used, file);
+    std::fclose(file);
+    return lines;
+}
+
+template <typename Fn>
+void run(const std::string& name, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    uint64_t bytes = 0;
+    uint64_t records = 0;
+    uint64_t estimate = fn(bytes, records);
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::setw(20) << name
+              << std::setw(10) << std::fixed << std::setprecision(2) << sec
+              << std::setw(10) << bytes / sec / 1e9
+              << std::setw(12) << records / sec / 1e6
+              << std::setw(12) << estimate << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    const double gigabytes = argc > 1 ? std::stod(argv[1]) : 2.0;
+    const std::string path = argc > 2 ? argv[2] : "bench_stream_keys.txt";
+
+    std::cout << "\n=== Потоковая вставка ===" << std::endl;
+    uint64_t lines = writeKeys(path, static_cast<uint64_t>(gigabytes * 1e9));
+    std::cout << "Файл: " << path << ", " << gigabytes << " ГБ, " << lines
+              << " строк, уникальных " << std::min(lines, DISTINCT) << std::endl;
+    std::cout << "Файл только что записан и находится в page cache" << std::endl;
+
+    std::cout << std::setw(20) << "Mode"
+              << std::setw(10) << "Time, s"
+              << std::setw(10) << "GB/s"
+              << std::setw(12) << "Keys, M/s"
+              << std::setw(12) << "Estimate" << std::endl;
+    std::cout << std::string(64, '-') << std::endl;
+
+    // Только разбиение на строки: верхняя граница для вставки
+    for (bool use_mmap : {true, false}) {
+        run(use_mmap ? "scan (mmap)" : "scan (read)", [&](uint64_t& bytes, uint64_t& records) {
+            LineReader reader(path, use_mmap);
+            std::string_view keys[1024];
+            size_t n;
+            while ((n = reader.next(keys, 1024)) != 0) {
+                records += n;
+            }
+            bytes = reader.bytesConsumed();
+            return uint64_t(0);
+        });
+    }
+
+    for (HashKind kind : {HashKind::Murmur3_32, HashKind::Murmur3_128}) {
+        for (bool use_mmap : {true, false}) {
+            std::string name = std::string(kind == HashKind::Murmur3_32 ? "hll32" : "hll64") +
+                               (use_mmap ? " (mmap)" : " (read)");
+            run(name, [&](uint64_t& bytes, uint64_t& records) {
+                LineReader reader(path, use_mmap);
+                HyperLogLog sketch(14, 42, kind);
+                records = ingestLines(reader, sketch, 10000000, [](uint64_t, uint64_t) {});
+                bytes = reader.bytesConsumed();
+                return sketch.estimate();
+            });
+        }
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include "RandomStreamGen.h"
+#include "PrefixEvaluator.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+
+// Генерация потоков test_stage2: generateStream() (mt19937_64, строка на
+// элемент) против generateArena() с разным числом потоков, затем оценка
+// префиксов по каждому варианту.
+// Использование: ./bench_streamgen [потоков генерации] [размер потока]
+
+template <typename Fn>
+double seconds(Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    const unsigned max_threads = argc > 1 ? std::stoul(argv[1]) : 8;
+    const size_t stream_size = argc > 2 ? std::stoul(argv[2]) : 1000000;
+    const size_t num_streams = 10;
+    const std::vector<double> percentages = {10, 20, 30, 40, 50, 60, 70, 80, 90, 100};
+    PrefixEvaluator evaluator(percentages, 14, 42);
+    
+    std::cout << "\n=== Генерация " << num_streams << " потоков по " << stream_size
+              << " элементов (ядер: " << std::thread::hardware_concurrency() << ") ===" << std::endl;
+    std::cout << std::setw(24) << "Generator"
+              << std::setw(12) << "Gen, s"
+              << std::setw(12) << "Eval, s"
+              << std::setw(14) << "Memory, MB" << std::endl;
+    std::cout << std::string(62, '-') << std::endl;
+    
+    // Вывод прогресса generateStream() подавляется
+    std::streambuf* saved = std::cout.rdbuf(nullptr);
+    double gen_sec = 0.0;
+    double eval_sec = 0.0;
+    size_t memory = 0;
+    for (size_t idx = 0; idx < num_streams; ++idx) {
+        RandomStreamGen streamGen(stream_size, 1000 + idx * 100);
+        gen_sec += seconds([&] { streamGen.generateStream(); });
+        eval_sec += seconds([&] { evaluator.evaluate(streamGen.getFullStream()); });
+        memory = 0;
+        for (const auto& item : streamGen.getFullStream()) {
+            memory += sizeof(std::string) + (item.capacity() > 15 ? item.capacity() + 1 : 0);
+        }
+    }
+    std::cout.rdbuf(saved);
+    std::cout << std::setw(24) << "generateStream()"
+              << std::setw(12) << std::fixed << std::setprecision(2) << gen_sec
+              << std::setw(12) << eval_sec
+              << std::setw(14) << memory / 1048576.0 << std::endl;
+    
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        gen_sec = 0.0;
+        eval_sec = 0.0;
+        for (size_t idx = 0; idx < num_streams; ++idx) {
+            RandomStreamGen streamGen(stream_size, 1000 + idx * 100);
+            ArenaStream arena;
+            gen_sec += seconds([&] { arena = streamGen.generateArena(threads); });
+            eval_sec += seconds([&] {
+                auto views = arena.views();
+                evaluator.evaluate(views.data(), views.size());
+            });
+            memory = arena.chars.size() + arena.offsets.size() * sizeof(uint64_t);
+        }
+        std::cout << std::setw(24) << ("generateArena(" + std::to_string(threads) + ")")
+                  << std::setw(12) << gen_sec
+                  << std::setw(12) << eval_sec
+                  << std::setw(14) << memory / 1048576.0 << std::endl;
+    }
+    
+    return 0;
+}
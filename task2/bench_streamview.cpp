@@ -0,0 +1,129 @@
+#include "RandomStreamGen.h"
+#include "HyperLogLog.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <unordered_set>
+#include <algorithm>
+
+// Доступ к префиксам потока: getStreamPart() (копия строк) против
+// getStreamView() (представление без копирования) на нагрузках тестовых
+// программ, плюс вставка в скетч пакетами chunks().
+// Использование: ./bench_streamview [потоков] [размер потока]
+
+template <typename Fn>
+double seconds(Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void printRow(const std::string& name, double copy_sec, double view_sec) {
+    std::cout << std::setw(34) << name
+              << std::setw(10) << std::fixed << std::setprecision(3) << copy_sec
+              << std::setw(10) << view_sec
+              << std::setw(4) << "x" << std::setprecision(1) << copy_sec / view_sec
+              << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t num_streams = argc > 1 ? std::stoul(argv[1]) : 10;
+    const size_t stream_size = argc > 2 ? std::stoul(argv[2]) : 1000000;
+    const std::vector<int> steps = {10, 20, 30, 40, 50, 60, 70, 80, 90, 100};
+    
+    double access_copy = 0.0, access_view = 0.0;
+    double stage1_copy = 0.0, stage1_view = 0.0;
+    double stage2_copy = 0.0, stage2_view = 0.0;
+    double batch_copy = 0.0, batch_chunks = 0.0;
+    uint64_t checksum_copy = 0, checksum_view = 0;
+    
+    std::streambuf* saved = std::cout.rdbuf(nullptr);
+    for (size_t idx = 0; idx < num_streams; ++idx) {
+        RandomStreamGen streamGen(stream_size, 1000 + idx * 100);
+        streamGen.generateStream();
+        
+        // Только получение префиксов
+        access_copy += seconds([&] {
+            for (int step : steps) {
+                checksum_copy += streamGen.getStreamPart(step).size();
+            }
+        });
+        access_view += seconds([&] {
+            for (int step : steps) {
+                checksum_view += streamGen.getStreamView(step).size();
+            }
+        });
+        
+        // test_stage1, тест 6: unordered_set по каждому префиксу
+        if (idx == 0) {
+            stage1_copy += seconds([&] {
+                for (int step : steps) {
+                    auto part = streamGen.getStreamPart(step);
+                    std::unordered_set<std::string> unique_strings(part.begin(), part.end());
+                    checksum_copy += unique_strings.size();
+                }
+            });
+            stage1_view += seconds([&] {
+                for (int step : steps) {
+                    StreamView part = streamGen.getStreamView(step);
+                    std::unordered_set<std::string> unique_strings(part.begin(), part.end());
+                    checksum_view += unique_strings.size();
+                }
+            });
+        }
+        
+        // Прежний цикл test_stage2: точный подсчет и скетч по каждому префиксу
+        stage2_copy += seconds([&] {
+            for (int step : steps) {
+                auto part = streamGen.getStreamPart(step);
+                HyperLogLog hll(14, 42);
+                hll.addBatch(part);
+                checksum_copy += exactCount(part) + hll.estimate();
+            }
+        });
+        stage2_view += seconds([&] {
+            for (int step : steps) {
+                StreamView part = streamGen.getStreamView(step);
+                HyperLogLog hll(14, 42);
+                hll.addBatch(part.data(), part.size());
+                checksum_view += exactCount(part.data(), part.size()) + hll.estimate();
+            }
+        });
+        
+        // Конвейерный потребитель: вставка пакетами по 4096 строк
+        // (копия каждого пакета против chunks())
+        batch_copy += seconds([&] {
+            HyperLogLog hll(14, 42);
+            const auto& stream = streamGen.getFullStream();
+            for (size_t offset = 0; offset < stream.size(); offset += 4096) {
+                size_t end = std::min(offset + 4096, stream.size());
+                std::vector<std::string> batch(stream.begin() + offset, stream.begin() + end);
+                hll.addBatch(batch);
+            }
+            checksum_copy += hll.estimate();
+        });
+        batch_chunks += seconds([&] {
+            HyperLogLog hll(14, 42);
+            for (StreamView batch : streamGen.getStreamView(100).chunks(4096)) {
+                hll.addBatch(batch.data(), batch.size());
+            }
+            checksum_view += hll.estimate();
+        });
+    }
+    std::cout.rdbuf(saved);
+    
+    std::cout << "\n=== Префиксы потока: " << num_streams << " потоков по "
+              << stream_size << " элементов ===" << std::endl;
+    std::cout << std::setw(34) << "Workload"
+              << std::setw(10) << "Copy, s"
+              << std::setw(10) << "View, s"
+              << std::setw(8) << "Gain" << std::endl;
+    std::cout << std::string(62, '-') << std::endl;
+    printRow("10 prefixes, access only", access_copy, access_view);
+    printRow("test_stage1 unique (1 stream)", stage1_copy, stage1_view);
+    printRow("prefix exact + HLL", stage2_copy, stage2_view);
+    printRow("batches of 4096", batch_copy, batch_chunks);
+    std::cout << "Результаты совпадают: " << (checksum_copy == checksum_view ? "да" : "нет") << std::endl;
+    
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include "HyperLogLog.h"
+#include "BiasTables.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+
+// Генерация таблиц смещения HLL++ (BiasTables.cpp): для B = 4..18 и
+// мощностей n = 5m * i / POINTS (без повторов) моделируется вставка случайных 64-битных
+// хешей, усредняются сырая оценка alpha_m * m^2 / sum 2^(-M[j]) и ее
+// смещение относительно n. Результат детерминирован.
+// Использование: ./gen_bias_tables > BiasTables.cpp
+
+const int POINTS = 100;
+
+inline uint64_t splitmix64(uint64_t& state) {
+    uint64_t x = (state += 0x9E3779B97F4A7C15ULL);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+int main() {
+    std::printf("// Сгенерировано gen_bias_tables, не редактировать вручную.\n");
+    std::printf("// Средняя сырая оценка и ее смещение для n = 5m * i / %d, i = 1..%d\n", POINTS, POINTS);
+    std::printf("#include \"BiasTables.h\"\n\nnamespace {\n\n");
+
+    for (int B = BIAS_TABLE_MIN_B; B <= BIAS_TABLE_MAX_B; ++B) {
+        const size_t m = size_t(1) << B;
+        const uint64_t mask = (uint64_t(1) << (64 - B)) - 1;
+        const double alpha = alphaFor(m);
+        // Примерно 5 * 2^24 вставок на каждое B
+        const size_t runs = std::max<size_t>(64, (size_t(1) << 24) / m);
+
+        // Для малых m часть мощностей 5m * i / POINTS совпадает
+        std::vector<uint64_t> targets;
+        for (int i = 1; i <= POINTS; ++i) {
+            uint64_t target = 5 * m * i / POINTS;
+            if (targets.empty() || targets.back() != target) {
+                targets.push_back(target);
+            }
+        }
+        const size_t points = targets.size();
+        
+        std::vector<double> raw_sum(points, 0.0);
+        std::vector<double> bias_sum(points, 0.0);
+        std::vector<uint8_t> registers(m);
+        uint64_t state = 0x5EED0000ULL + B;
+
+        for (size_t run = 0; run < runs; ++run) {
+            std::fill(registers.begin(), registers.end(), 0);
+            double harmonic_sum = static_cast<double>(m);
+            uint64_t n = 0;
+            for (size_t i = 0; i < points; ++i) {
+                const uint64_t target = targets[i];
+                for (; n < target; ++n) {
+                    uint64_t hash = splitmix64(state);
+                    size_t j = hash >> (64 - B);
+                    uint64_t w = hash & mask;
+                    uint8_t rank = static_cast<uint8_t>(w ? __builtin_clzll(w) - B + 1 : 64 - B + 1);
+                    if (rank > registers[j]) {
+                        harmonic_sum += 1.0 / static_cast<double>(uint64_t(1) << rank) -
+                                        1.0 / static_cast<double>(uint64_t(1) << registers[j]);
+                        registers[j] = rank;
+                    }
+                }
+                double raw = alpha * m * m / harmonic_sum;
+                raw_sum[i] += raw;
+                bias_sum[i] += raw - static_cast<double>(target);
+            }
+        }
+
+        std::printf("const double RAW_B%d[] = {", B);
+        for (size_t i = 0; i < points; ++i) {
+            std::printf("%s%.2f", i % 8 == 0 ? "\n    " : " ", raw_sum[i] / runs);
+            std::printf(i + 1 < points ? "," : "\n");
+        }
+        std::printf("};\n\nconst double BIAS_B%d[] = {", B);
+        for (size_t i = 0; i < points; ++i) {
+            std::printf("%s%.3f", i % 8 == 0 ? "\n    " : " ", bias_sum[i] / runs);
+            std::printf(i + 1 < points ? "," : "\n");
+        }
+        std::printf("};\n\n");
+        std::fprintf(stderr, "B = %d: %zu прогонов\n", B, runs);
+    }
+
+    std::printf("const BiasTable TABLES[] = {\n");
+    for (int B = BIAS_TABLE_MIN_B; B <= BIAS_TABLE_MAX_B; ++B) {
+        std::printf("    {RAW_B%d, BIAS_B%d, sizeof(RAW_B%d) / sizeof(double)},\n", B, B, B);
+    }
+    std::printf("};\n\n} // namespace\n\n");
+    std::printf("const BiasTable& biasTable(uint8_t B) {\n");
+    std::printf("    return TABLES[B - BIAS_TABLE_MIN_B];\n}\n");
+    return 0;
+}
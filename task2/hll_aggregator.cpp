@@ -0,0 +1,115 @@
+#include "SketchAggregator.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <atomic>
+#include <string>
+#include <csignal>
+#include <cstdlib>
+
+// Сервер-агрегатор скетчей (SketchAggregator.h): принимает записи скетчей
+// по Unix- или TCP-сокету, объединяет их в именованные скетчи по
+// интервалам времени и отвечает на запросы оценки. Работает до SIGINT или
+// SIGTERM; счетчики печатаются в stderr каждые --report секунд и при выходе.
+// Использование: ./hll_aggregator [--listen адрес] [-b B] [-s seed] [--hash имя]
+//                                 [--bucket секунды] [--retention N] [--report секунды]
+//   --listen   unix:/путь или хост:порт (по умолчанию unix:/tmp/hll_aggregator.sock)
+//   -b, -s     параметры скетчей, как у клиентов (по умолчанию 14 и 42)
+//   --hash     murmur3_32, murmur3_128, xxh64, wyhash или crc32c
+//   --bucket   длина интервала (по умолчанию 60 с)
+//   --retention хранить последние N интервалов по времени сервера, более
+//              старые удалять, записи старше окна отбрасывать (по
+//              умолчанию 0 - хранить все)
+//   --report   период вывода счетчиков (по умолчанию 10 с, 0 - только при выходе)
+
+std::atomic<bool> stop_requested{false};
+
+void onSignal(int) {
+    stop_requested.store(true);
+}
+
+void usage() {
+    std::cerr << "Usage: hll_aggregator [--listen endpoint] [-b B] [-s seed] [--hash name] "
+                 "[--bucket seconds] [--retention buckets] [--report seconds]" << std::endl;
+    std::exit(1);
+}
+
+void report(const SketchAggregator& aggregator) {
+    const AggregatorStats& s = aggregator.getStats();
+    std::cerr << "Соединений: " << s.connections << ", кадров: " << s.frames
+              << ", объединено: " << s.merged << " (пакетов " << s.merge_batches
+              << ", в среднем " << std::fixed << std::setprecision(1)
+              << (s.merge_batches ? static_cast<double>(s.merged) / s.merge_batches : 0.0)
+              << "), отброшено: " << s.rejected << ", удалено интервалов: " << s.evicted
+              << ", запросов: " << s.queries
+              << ", ошибок формата: " << s.protocol_errors
+              << ", скетчей: " << aggregator.sketchCount()
+              << ", память: " << aggregator.memoryBytes() / (1 << 20) << " МБ" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string endpoint = "unix:/tmp/hll_aggregator.sock";
+    uint8_t B = 14;
+    uint32_t seed = 42;
+    HashKind kind = HashKind::Murmur3_32;
+    uint64_t bucket_seconds = 60;
+    uint64_t retention_buckets = 0;
+    double report_seconds = 10;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--listen" && i + 1 < argc) {
+            endpoint = argv[++i];
+        } else if (arg == "-b" && i + 1 < argc) {
+            B = static_cast<uint8_t>(std::stoi(argv[++i]));
+        } else if (arg == "-s" && i + 1 < argc) {
+            seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--hash" && i + 1 < argc) {
+            std::string name = argv[++i];
+            size_t k = 0;
+            while (k < HASH_KIND_COUNT && name != hashKindName(static_cast<HashKind>(k))) {
+                ++k;
+            }
+            if (k == HASH_KIND_COUNT) {
+                usage();
+            }
+            kind = static_cast<HashKind>(k);
+        } else if (arg == "--bucket" && i + 1 < argc) {
+            bucket_seconds = std::stoull(argv[++i]);
+        } else if (arg == "--retention" && i + 1 < argc) {
+            retention_buckets = std::stoull(argv[++i]);
+        } else if (arg == "--report" && i + 1 < argc) {
+            report_seconds = std::stod(argv[++i]);
+        } else {
+            usage();
+        }
+    }
+
+    try {
+        SketchAggregator aggregator(endpoint, B, seed, kind, bucket_seconds, retention_buckets);
+        std::signal(SIGINT, onSignal);
+        std::signal(SIGTERM, onSignal);
+        std::cerr << "Агрегатор: " << endpoint << ", B = " << static_cast<int>(B)
+                  << ", " << hashKindName(kind) << ", интервал " << bucket_seconds << " с";
+        if (retention_buckets != 0) {
+            std::cerr << ", хранятся " << retention_buckets << " последних интервалов";
+        }
+        std::cerr << std::endl;
+
+        auto last_report = std::chrono::steady_clock::now();
+        while (!stop_requested.load()) {
+            aggregator.poll(100);
+            auto now = std::chrono::steady_clock::now();
+            if (report_seconds > 0 &&
+                std::chrono::duration<double>(now - last_report).count() >= report_seconds) {
+                report(aggregator);
+                last_report = now;
+            }
+        }
+        report(aggregator);
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include "ExperimentRunner.h"
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <cstdlib>
+
+// Эксперимент Монте-Карло по сетке (B, хеш, оценщик, длина потока) с
+// trials потоками на каждую длину; испытания выполняются параллельно на
+// пуле с перехватом задач. Без параметров повторяет test_stage2.
+// Использование: ./hll_experiment [--config файл] [--threads N]
+//                                 [--trials-csv файл] [--summary-csv файл]
+//                                 [ключ=значение ...]
+//   ключи: b=10,12,14 или b=8..16; hash=murmur3_32,xxh64,...;
+//          estimator=classic,improved,ml,hllpp; size=100000,1000000,1e9;
+//          checkpoints=10,50,100; trials=N; stream_seed=S; hash_seed=S;
+//          source=strings|synthetic (synthetic - псевдослучайные хеши
+//          вместо строк, точное значение известно по построению: точки
+//          на 10^9 ключей без памяти под строки и множество)
+//   Параметры командной строки применяются после файла --config.
+// Строки испытаний пишутся в --trials-csv (experiment_trials.csv) по мере
+// готовности, сводка (среднее, std, смещение и RMSE относительной ошибки
+// по алгоритму Уэлфорда) - в --summary-csv (experiment_summary.csv) и в
+// stdout. Оба файла не зависят от --threads
+
+void usage() {
+    std::cerr << "Usage: hll_experiment [--config file] [--threads N] [--trials-csv file] "
+                 "[--summary-csv file] [key=value ...]" << std::endl;
+    std::exit(1);
+}
+
+int main(int argc, char* argv[]) {
+    ExperimentGrid grid;
+    unsigned threads = 0;
+    std::string trials_path = "experiment_trials.csv";
+    std::string summary_path = "experiment_summary.csv";
+
+    try {
+        std::vector<std::string> assignments;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--config" && i + 1 < argc) {
+                grid.loadFile(argv[++i]);
+            } else if (arg == "--threads" && i + 1 < argc) {
+                threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (arg == "--trials-csv" && i + 1 < argc) {
+                trials_path = argv[++i];
+            } else if (arg == "--summary-csv" && i + 1 < argc) {
+                summary_path = argv[++i];
+            } else if (arg.find('=') != std::string::npos && arg[0] != '-') {
+                assignments.push_back(arg);
+            } else {
+                usage();
+            }
+        }
+        for (const auto& assignment : assignments) {
+            grid.setFromString(assignment);
+        }
+
+        ExperimentRunner runner(grid);
+        const size_t total = grid.trialCount();
+        const unsigned workers = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+        std::cerr << "Испытаний: " << total << ", строк на испытание: " << grid.recordsPerTrial()
+                  << ", потоков: " << workers << std::endl;
+
+        std::ofstream trials_file(trials_path);
+        if (!trials_file) {
+            throw std::runtime_error("Cannot open " + trials_path);
+        }
+        trials_file << "stream_size,trial,b,hash,estimator,percentage,prefix_size,exact,estimate,"
+                       "relative_error\n" << std::setprecision(10);
+
+        size_t finished = 0;
+        auto start = std::chrono::steady_clock::now();
+        auto summary = runner.run(threads, [&](const std::vector<TrialRecord>& records) {
+            for (const auto& r : records) {
+                trials_file << r.stream_size << "," << r.trial << "," << static_cast<int>(r.b) << ","
+                            << hashKindName(r.kind) << "," << estimatorName(r.estimator) << ","
+                            << r.percentage << "," << r.prefix_size << "," << r.exact << ","
+                            << r.estimate << "," << r.relativeError() << "\n";
+            }
+            trials_file.flush();
+            ++finished;
+            if (finished % std::max<size_t>(1, total / 20) == 0 || finished == total) {
+                double sec = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start).count();
+                std::cerr << "  " << finished << "/" << total << " (" << std::fixed
+                          << std::setprecision(1) << sec << " с)" << std::endl;
+            }
+        });
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::ofstream summary_file(summary_path);
+        if (!summary_file) {
+            throw std::runtime_error("Cannot open " + summary_path);
+        }
+        summary_file << "stream_size,b,hash,estimator,percentage,trials,mean_exact,mean_estimate,"
+                        "std_estimate,mean_error,std_error,rmse\n" << std::setprecision(10);
+
+        std::cout << std::setw(9) << "Size" << std::setw(4) << "B" << std::setw(13) << "Hash"
+                  << std::setw(10) << "Estimator" << std::setw(6) << "%"
+                  << std::setw(12) << "Mean exact" << std::setw(12) << "Mean est"
+                  << std::setw(10) << "Std est" << std::setw(9) << "Bias,%" << std::setw(9) << "RMSE,%"
+                  << std::endl;
+        std::cout << std::string(94, '-') << std::endl << std::fixed;
+        for (const auto& row : summary) {
+            summary_file << row.stream_size << "," << static_cast<int>(row.b) << ","
+                         << hashKindName(row.kind) << "," << estimatorName(row.estimator) << ","
+                         << row.percentage << "," << row.estimate.count() << ","
+                         << row.exact.mean() << "," << row.estimate.mean() << ","
+                         << row.estimate.stddev() << "," << row.error.mean() << ","
+                         << row.error.stddev() << "," << row.error.rootMeanSquare() << "\n";
+            std::cout << std::setw(9) << row.stream_size << std::setw(4) << static_cast<int>(row.b)
+                      << std::setw(13) << hashKindName(row.kind)
+                      << std::setw(10) << estimatorName(row.estimator)
+                      << std::setw(6) << std::defaultfloat << std::setprecision(4) << row.percentage
+                      << std::fixed
+                      << std::setw(12) << static_cast<uint64_t>(row.exact.mean())
+                      << std::setw(12) << static_cast<uint64_t>(row.estimate.mean())
+                      << std::setw(10) << static_cast<uint64_t>(row.estimate.stddev())
+                      << std::setprecision(3) << std::showpos
+                      << std::setw(9) << 100.0 * row.error.mean() << std::noshowpos
+                      << std::setw(9) << 100.0 * row.error.rootMeanSquare() << std::endl;
+        }
+        std::cerr << "Время: " << std::setprecision(2) << sec << " с; испытания - " << trials_path
+                  << ", сводка - " << summary_path << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,236 @@
+#include "SketchAggregator.h"
+#include "HyperLogLog.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdlib>
+
+// Генератор нагрузки для hll_aggregator. --connections клиентов (по потоку
+// на клиента) отправляют по --frames записей скетчей: кадр g идет в имя
+// k = g % names и интервал (g / names) % buckets, запись - скетч
+// (g / names + k) % sketches из заранее построенного набора (по --items
+// ключей, соседние скетчи пересекаются наполовину). Затем один клиент
+// выполняет --queries запросов оценки по всем интервалам случайного имени.
+// Использование: ./hll_loadgen [--endpoint адрес] [--self] [--connections N]
+//                              [--frames N] [--names K] [--buckets T]
+//                              [--sketches P] [--items N] [--sparse]
+//                              [--queries Q] [-b B] [-s seed] [--hash имя]
+//   --self    запустить агрегатор в этом же процессе (отдельный поток):
+//             проверка целиком на localhost без второго процесса
+//   --sparse  записи в разреженном представлении (маленькие кадры)
+// Вывод: кадры/с и МБ/с отправки до ответа Stats (с объединением на
+// сервере), задержки запросов (медиана, 99%, максимум) и сверка оценки
+// сервера для первых имен с локальным объединением тех же скетчей
+
+void usage() {
+    std::cerr << "Usage: hll_loadgen [--endpoint addr] [--self] [--connections N] [--frames N] "
+                 "[--names K] [--buckets T] [--sketches P] [--items N] [--sparse] [--queries Q] "
+                 "[-b B] [-s seed] [--hash name]" << std::endl;
+    std::exit(1);
+}
+
+int main(int argc, char* argv[]) {
+    std::string endpoint = "unix:/tmp/hll_aggregator.sock";
+    bool self = false;
+    unsigned connections = 4;
+    size_t frames = 20000;
+    size_t names = 1000;
+    size_t bucket_count = 4;
+    size_t sketches = 64;
+    size_t items = 10000;
+    bool sparse = false;
+    size_t query_count = 10000;
+    uint8_t B = 14;
+    uint32_t seed = 42;
+    HashKind kind = HashKind::Murmur3_32;
+    const uint64_t bucket_seconds = 60;
+    const uint64_t base_time = 1700000040;   // Кратно bucket_seconds
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--endpoint" && i + 1 < argc) {
+            endpoint = argv[++i];
+        } else if (arg == "--self") {
+            self = true;
+        } else if (arg == "--connections" && i + 1 < argc) {
+            connections = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--frames" && i + 1 < argc) {
+            frames = std::stoull(argv[++i]);
+        } else if (arg == "--names" && i + 1 < argc) {
+            names = std::stoull(argv[++i]);
+        } else if (arg == "--buckets" && i + 1 < argc) {
+            bucket_count = std::stoull(argv[++i]);
+        } else if (arg == "--sketches" && i + 1 < argc) {
+            sketches = std::stoull(argv[++i]);
+        } else if (arg == "--items" && i + 1 < argc) {
+            items = std::stoull(argv[++i]);
+        } else if (arg == "--sparse") {
+            sparse = true;
+        } else if (arg == "--queries" && i + 1 < argc) {
+            query_count = std::stoull(argv[++i]);
+        } else if (arg == "-b" && i + 1 < argc) {
+            B = static_cast<uint8_t>(std::stoi(argv[++i]));
+        } else if (arg == "-s" && i + 1 < argc) {
+            seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--hash" && i + 1 < argc) {
+            std::string name = argv[++i];
+            size_t k = 0;
+            while (k < HASH_KIND_COUNT && name != hashKindName(static_cast<HashKind>(k))) {
+                ++k;
+            }
+            if (k == HASH_KIND_COUNT) {
+                usage();
+            }
+            kind = static_cast<HashKind>(k);
+        } else {
+            usage();
+        }
+    }
+    if (connections == 0 || names == 0 || bucket_count == 0 || sketches == 0) {
+        usage();
+    }
+
+    try {
+        // Набор скетчей и их записей
+        std::vector<HyperLogLog> pool;
+        std::vector<std::vector<uint8_t>> records;
+        std::vector<uint64_t> keys(items);
+        for (size_t p = 0; p < sketches; ++p) {
+            for (size_t k = 0; k < items; ++k) {
+                keys[k] = p * (items / 2) + k;
+            }
+            pool.emplace_back(B, seed, kind, sparse ? Representation::Sparse : Representation::Dense);
+            pool.back().addBatch(keys.data(), keys.size());
+            records.push_back(pool.back().serialize());
+        }
+        std::vector<std::string> name_list;
+        for (size_t k = 0; k < names; ++k) {
+            name_list.push_back("name" + std::to_string(k));
+        }
+        size_t record_bytes = 0;
+        for (const auto& record : records) {
+            record_bytes += record.size();
+        }
+        std::cerr << "Записей: " << sketches << " по " << items << " ключей, средний размер "
+                  << record_bytes / sketches << " байт (" << (sparse ? "sparse" : "dense") << ")"
+                  << std::endl;
+
+        auto sketch_of = [&](size_t g) { return (g / names + g % names) % sketches; };
+
+        std::unique_ptr<SketchAggregator> server;
+        std::atomic<bool> stop{false};
+        std::thread server_thread;
+        if (self) {
+            server = std::make_unique<SketchAggregator>(endpoint, B, seed, kind, bucket_seconds);
+            server_thread = std::thread([&] { server->run(stop, 10); });
+        }
+
+        // 1. Поток записей: время до ответа Stats, т.е. до объединения
+        //    всех кадров сервером
+        std::atomic<uint64_t> bytes_sent{0};
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> clients;
+        std::vector<std::string> errors(connections);
+        for (unsigned c = 0; c < connections; ++c) {
+            clients.emplace_back([&, c] {
+                try {
+                    AggregatorClient client(endpoint, 1 << 18);
+                    uint64_t sent = 0;
+                    for (size_t i = 0; i < frames; ++i) {
+                        const size_t g = c * frames + i;
+                        const size_t round = g / names;
+                        const auto& record = records[sketch_of(g)];
+                        client.merge(name_list[g % names], record,
+                                     base_time + (round % bucket_count) * bucket_seconds);
+                        sent += sizeof(FrameHeader) + name_list[g % names].size() + record.size();
+                    }
+                    client.stats();
+                    bytes_sent += sent;
+                } catch (const std::exception& e) {
+                    errors[c] = e.what();
+                }
+            });
+        }
+        for (auto& client : clients) {
+            client.join();
+        }
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        for (const auto& error : errors) {
+            if (!error.empty()) {
+                throw std::runtime_error(error);
+            }
+        }
+
+        AggregatorClient client(endpoint);
+        ReplyFrame totals = client.stats();
+        const uint64_t total_frames = static_cast<uint64_t>(connections) * frames;
+        std::cout << "Кадров: " << total_frames << " по " << connections << " соединениям за "
+                  << std::fixed << std::setprecision(3) << sec << " с: "
+                  << std::setprecision(0) << total_frames / sec << " кадров/с, "
+                  << std::setprecision(1) << bytes_sent.load() / sec / 1e6 << " МБ/с; "
+                  << "объединено сервером: " << totals.value << ", отброшено: " << totals.value2
+                  << std::endl;
+
+        // 2. Задержка запросов
+        std::mt19937_64 rng(7);
+        std::vector<double> latency;
+        latency.reserve(query_count);
+        uint64_t checksum = 0;
+        for (size_t q = 0; q < query_count; ++q) {
+            const std::string& name = name_list[rng() % names];
+            auto t0 = std::chrono::steady_clock::now();
+            checksum += client.query(name);
+            latency.push_back(std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - t0).count());
+        }
+        if (!latency.empty()) {
+            std::sort(latency.begin(), latency.end());
+            std::cout << "Запросов: " << query_count << ", задержка, мкс: медиана "
+                      << std::setprecision(1) << latency[latency.size() / 2]
+                      << ", 99% " << latency[latency.size() * 99 / 100]
+                      << ", максимум " << latency.back()
+                      << " (сумма оценок " << checksum << ")" << std::endl;
+        }
+
+        // 3. Сверка с локальным объединением тех же записей
+        size_t checked = std::min<size_t>(names, 4);
+        size_t matched = 0;
+        for (size_t k = 0; k < checked; ++k) {
+            HyperLogLog expected(B, seed, kind);
+            bool any = false;
+            for (size_t g = k; g < total_frames; g += names) {
+                expected.merge(pool[sketch_of(g)]);
+                any = true;
+            }
+            uint64_t local = any ? expected.estimate(Estimator::Classic) : 0;
+            uint64_t remote = client.query(name_list[k]);
+            matched += (local == remote);
+            std::cout << "  " << name_list[k] << ": сервер " << remote << ", локально " << local
+                      << (local == remote ? " - совпадает" : " - РАСХОЖДЕНИЕ") << std::endl;
+        }
+
+        if (self) {
+            stop = true;
+            server_thread.join();
+            const AggregatorStats& s = server->getStats();
+            std::cout << "Сервер: пакетов объединения " << s.merge_batches << ", в среднем "
+                      << std::setprecision(1)
+                      << (s.merge_batches ? static_cast<double>(s.merged) / s.merge_batches : 0.0)
+                      << " записей; скетчей " << server->sketchCount() << ", память "
+                      << server->memoryBytes() / (1 << 20) << " МБ" << std::endl;
+        }
+        if (matched != checked) {
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
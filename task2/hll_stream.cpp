@@ -0,0 +1,125 @@
+#include "HyperLogLog.h"
+#include "StreamIngest.h"
+#include "Metrics.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <cstdlib>
+#include <stdexcept>
+
+// Оценка количества уникальных строк файла или стандартного ввода.
+// Использование: ./hll_stream [-b B] [-s seed] [-k K] [--hash64] [--hash имя] [--read]
+//                             [--metrics prom|json] [файл|-]
+//   -b B       количество бит индекса, 4..16 (с 64-битным хешем 4..18, по
+//              умолчанию 14)
+//   -s seed    seed хеш-функции (по умолчанию 42)
+//   -k K       контрольная оценка каждые K строк (по умолчанию 0 - нет)
+//   --hash64   64-битный хеш MurmurHash3 x64_128
+//   --hash имя murmur3_32, murmur3_128, xxh64, wyhash или crc32c
+//   --read     чтение блоками read() вместо mmap
+//   --metrics  в конце вывести в stdout счетчики (Metrics.h) и гистограмму
+//              регистров скетча в формате Prometheus или JSON; счетчики и
+//              время операций ненулевые только при сборке make METRICS=1
+// Контрольные точки выводятся в stdout как "records,estimate",
+// итог и скорость - в stderr
+
+void usage() {
+    std::cerr << "Usage: hll_stream [-b B] [-s seed] [-k K] [--hash64] [--hash name] [--read] "
+                 "[--metrics prom|json] [file|-]"
+              << std::endl;
+    std::exit(1);
+}
+
+int main(int argc, char* argv[]) {
+    int b_arg = 14;
+    unsigned long seed_arg = 42;
+    uint64_t checkpoint_every = 0;
+    HashKind kind = HashKind::Murmur3_32;
+    bool use_mmap = true;
+    std::string metrics_format;
+    std::string path = "-";
+
+    // Нечисловые и выходящие за диапазон значения (std::invalid_argument,
+    // std::out_of_range из std::sto*) - ошибка использования
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "-b" && i + 1 < argc) {
+                b_arg = std::stoi(argv[++i]);
+            } else if (arg == "-s" && i + 1 < argc) {
+                seed_arg = std::stoul(argv[++i]);
+            } else if (arg == "-k" && i + 1 < argc) {
+                checkpoint_every = std::stoull(argv[++i]);
+            } else if (arg == "--hash64") {
+                kind = HashKind::Murmur3_128;
+            } else if (arg == "--hash" && i + 1 < argc) {
+                std::string name = argv[++i];
+                size_t k = 0;
+                while (k < HASH_KIND_COUNT && name != hashKindName(static_cast<HashKind>(k))) {
+                    ++k;
+                }
+                if (k == HASH_KIND_COUNT) {
+                    usage();
+                }
+                kind = static_cast<HashKind>(k);
+            } else if (arg == "--read") {
+                use_mmap = false;
+            } else if (arg == "--metrics" && i + 1 < argc) {
+                metrics_format = argv[++i];
+                if (metrics_format != "prom" && metrics_format != "json") {
+                    usage();
+                }
+            } else if (arg.size() > 1 && arg[0] == '-') {
+                usage();
+            } else {
+                path = arg;
+            }
+        }
+    } catch (const std::logic_error&) {
+        usage();
+    }
+    // Диапазон проверяется до приведения к uint8_t / uint32_t
+    if (b_arg < MIN_PRECISION || b_arg > maxPrecision(kind) || seed_arg > UINT32_MAX) {
+        usage();
+    }
+    const uint8_t B = static_cast<uint8_t>(b_arg);
+    const uint32_t seed = static_cast<uint32_t>(seed_arg);
+
+    try {
+        HyperLogLog sketch(B, seed, kind);
+        LineReader reader(path, use_mmap);
+
+        if (checkpoint_every != 0) {
+            std::cout << "records,estimate" << std::endl;
+        }
+        auto start = std::chrono::steady_clock::now();
+        uint64_t records = ingestLines(reader, sketch, checkpoint_every,
+                                       [](uint64_t n, uint64_t estimate) {
+            std::cout << n << "," << estimate << "\n";
+        });
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const double gb = reader.bytesConsumed() / 1e9;
+        std::cerr << "Строк: " << records
+                  << ", оценка: " << sketch.estimate()
+                  << ", прочитано: " << std::fixed << std::setprecision(3) << gb << " ГБ"
+                  << " (" << (reader.isMapped() ? "mmap" : "read") << ")"
+                  << ", время: " << sec << " с"
+                  << ", " << (sec > 0 ? gb / sec : 0.0) << " ГБ/с" << std::endl;
+
+        if (!metrics_format.empty()) {
+            std::vector<SketchGauges> gauges = {Metrics::sketchGauges(path, sketch)};
+            if (metrics_format == "prom") {
+                Metrics::writePrometheus(std::cout, Metrics::snapshot(), gauges);
+            } else {
+                Metrics::writeJson(std::cout, Metrics::snapshot(), gauges);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,21 +1,21 @@
 #include "RandomStreamGen.h"
 #include "HashFuncGen.h"
 #include "HyperLogLog.h"
+#include "SketchIO.h"
+#include "PrefixEvaluator.h"
+#include "SketchAggregator.h"
 #include <iostream>
 #include <fstream>
 #include <iomanip>
 #include <vector>
 #include <cmath>
 #include <map>
-
-// Структура для хранения результатов одного теста
-struct TestResult {
-    size_t stream_size;
-    double percentage;
-    uint64_t exact_count;
-    uint64_t hll_estimate;
-    double relative_error;
-};
+#include <chrono>
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 // Структура для хранения статистики по нескольким потокам
 struct Statistics {
@@ -50,6 +50,48 @@ Statistics computeStatistics(const std::vector<uint64_t>& estimates, uint64_t ex
     return stats;
 }
 
+// Запись с заголовком record, данными payload и entry_count записями
+// (для плотных - m) и правильной контрольной суммой: проверка того, что
+// содержимое проверяется отдельно от CRC
+std::vector<uint8_t> forgeRecord(const std::vector<uint8_t>& record,
+                                 const std::vector<uint8_t>& payload, uint32_t entry_count) {
+    SketchHeader header = loadSketchHeader(record.data());
+    header.payload_bytes = static_cast<uint32_t>(payload.size());
+    header.entry_count = entry_count;
+    std::vector<uint8_t> forged(sizeof(header) + payload.size());
+    storeSketchHeader(header, forged.data());
+    std::copy(payload.begin(), payload.end(), forged.begin() + sizeof(header));
+    uint32_t crc = crc32c(forged.data(), SKETCH_CHECKSUM_OFFSET);
+    crc = crc32c(forged.data() + sizeof(header), payload.size(), crc);
+    storeLittleEndian(forged.data() + SKETCH_CHECKSUM_OFFSET, crc, sizeof(crc));
+    return forged;
+}
+
+// Записи с правильной CRC, но недопустимым содержимым: регистр 200,
+// индекс разреженной записи 2^26 - 1, неверное число записей, корректный
+// разреженный список длиннее плотных регистров
+std::vector<std::vector<uint8_t>> forgedRecords(uint8_t B) {
+    HyperLogLog dense(B, 42);
+    dense.add("x");
+    std::vector<uint8_t> dense_record = dense.serialize();
+    std::vector<uint8_t> registers(dense_record.begin() + sizeof(SketchHeader), dense_record.end());
+    registers[0] = 200;
+
+    HyperLogLog sparse(B, 42, HashKind::Murmur3_32, Representation::Sparse);
+    sparse.add("x");
+    std::vector<uint8_t> sparse_record = sparse.serialize();
+    std::vector<uint8_t> list(sparse_record.begin() + sizeof(SketchHeader), sparse_record.end());
+    const std::vector<uint8_t> far_entry = {0xC1, 0xFF, 0xFF, 0xFF, 0x0F};   // (2^26 - 1) << 6 | 1
+    // Записи (i << 6) | 1 для i = 0..m: первая запись и m разностей по 64
+    std::vector<uint8_t> long_list((size_t(1) << B) + 1, 0x40);
+    long_list[0] = 0x41;
+
+    return {forgeRecord(dense_record, registers, static_cast<uint32_t>(registers.size())),
+            forgeRecord(sparse_record, far_entry, 1),
+            forgeRecord(sparse_record, list, uint32_t(1) << 25),
+            forgeRecord(sparse_record, long_list, static_cast<uint32_t>(long_list.size()))};
+}
+
 int main() {
     std::cout << "=== Этап 2: Реализация и оценка HyperLogLog ===" << std::endl;
     
@@ -76,12 +118,16 @@ int main() {
     std::vector<double> percentages = {10, 20, 30, 40, 50, 60, 70, 80, 90, 100};
     
     // Хранилище для результатов
-    std::vector<std::vector<TestResult>> all_results(num_streams);
+    std::vector<std::vector<PrefixSnapshot>> all_results(num_streams);
     
     // Для каждого шага храним оценки от всех потоков
     std::map<double, std::vector<uint64_t>> estimates_by_step;
     std::map<double, uint64_t> exact_by_step;
     
+    // Все префиксы потока оцениваются за один проход
+    PrefixEvaluator evaluator(percentages, B, 42);
+    double evaluation_sec = 0.0;
+    
     std::cout << "\n--- Генерация и тестирование потоков ---" << std::endl;
     
     for (size_t stream_idx = 0; stream_idx < num_streams; ++stream_idx) {
@@ -91,46 +137,29 @@ int main() {
         RandomStreamGen streamGen(stream_size, 1000 + stream_idx * 100);
         streamGen.generateStream();
         
-        // Тестируем на каждом шаге
-        for (double pct : percentages) {
-            auto part = streamGen.getStreamPart(pct);
-            
-            // Точный подсчет
-            uint64_t exact = exactCount(part);
-            
-            // HyperLogLog оценка
-            HyperLogLog hll(B, 42);
-            for (const auto& item : part) {
-                hll.add(item);
-            }
-            uint64_t estimate = hll.estimate();
-            
-            // Относительная ошибка
-            double error = std::abs(static_cast<double>(estimate) - exact) / exact;
-            
-            // Сохраняем результат
-            TestResult result;
-            result.stream_size = part.size();
-            result.percentage = pct;
-            result.exact_count = exact;
-            result.hll_estimate = estimate;
-            result.relative_error = error;
-            all_results[stream_idx].push_back(result);
-            
+        auto start = std::chrono::steady_clock::now();
+        all_results[stream_idx] = evaluator.evaluate(streamGen.getFullStream());
+        evaluation_sec += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        
+        for (const auto& result : all_results[stream_idx]) {
             // Добавляем в общую статистику
-            estimates_by_step[pct].push_back(estimate);
+            estimates_by_step[result.percentage].push_back(result.hll_estimate);
             if (stream_idx == 0) {
-                exact_by_step[pct] = exact;
+                exact_by_step[result.percentage] = result.exact_count;
             }
             
-            std::cout << std::setw(5) << pct << "%: " 
-                      << "Exact=" << std::setw(7) << exact
-                      << ", HLL=" << std::setw(7) << estimate
+            std::cout << std::setw(5) << result.percentage << "%: " 
+                      << "Exact=" << std::setw(7) << result.exact_count
+                      << ", HLL=" << std::setw(7) << result.hll_estimate
                       << ", Error=" << std::fixed << std::setprecision(2) 
-                      << std::setw(6) << (error * 100) << "%" << std::endl;
+                      << std::setw(6) << (result.relative_error * 100) << "%" << std::endl;
         }
     }
     
+    std::cout << "\nВремя оценки префиксов (без генерации): " << std::fixed
+              << std::setprecision(2) << evaluation_sec << " с" << std::endl;
+    
     // Вычисляем и выводим статистику
     std::cout << "\n=== Статистика по всем потокам ===" << std::endl;
     std::cout << std::setw(8) << "Step" 
@@ -168,7 +197,7 @@ int main() {
     detail_file << "percentage,stream_size,exact_count,hll_estimate,error\n";
     for (const auto& result : all_results[0]) {
         detail_file << result.percentage << ","
-                    << result.stream_size << ","
+                    << result.prefix_size << ","
                     << result.exact_count << ","
                     << result.hll_estimate << ","
                     << result.relative_error << "\n";
@@ -186,26 +215,221 @@ int main() {
         hll_analysis.add(item);
     }
     
-    const auto& registers = hll_analysis.getRegisters();
-    std::vector<int> value_counts(33, 0);  // Максимум 32 ведущих нуля + 1
-    
-    for (uint8_t val : registers) {
-        if (val < value_counts.size()) {
-            value_counts[val]++;
-        }
-    }
+    const RegisterHistogram histogram = hll_analysis.registerHistogram();
     
     std::cout << "Распределение значений в регистрах:" << std::endl;
-    for (size_t i = 0; i < value_counts.size(); ++i) {
-        if (value_counts[i] > 0) {
-            double pct = (value_counts[i] * 100.0) / registers.size();
+    for (size_t i = 0; i < histogram.size(); ++i) {
+        if (histogram[i] > 0) {
+            double pct = (histogram[i] * 100.0) / hll_analysis.getM();
             std::cout << "Значение " << std::setw(2) << i << ": "
-                      << std::setw(6) << value_counts[i]
+                      << std::setw(6) << histogram[i]
                       << " (" << std::fixed << std::setprecision(2)
                       << std::setw(5) << pct << "%)" << std::endl;
         }
     }
     
+    // Сравнение скорости поэлементной и пакетной вставки
+    // для 32- и 64-битного хеша
+    std::cout << "\n=== Пропускная способность вставки ===" << std::endl;
+    std::cout << "Реализация addBatch: " << HashFuncGen::batchBackend() << std::endl;
+    
+    const auto& full = test_stream.getFullStream();
+    
+    for (HashKind kind : {HashKind::Murmur3_32, HashKind::Murmur3_128}) {
+        auto start = std::chrono::steady_clock::now();
+        HyperLogLog hll_scalar(B, 42, kind);
+        for (const auto& item : full) {
+            hll_scalar.add(item);
+        }
+        double scalar_sec = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        
+        start = std::chrono::steady_clock::now();
+        HyperLogLog hll_batch(B, 42, kind);
+        hll_batch.addBatch(full);
+        double batch_sec = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        
+        bool identical = hll_scalar.getRegisters() == hll_batch.getRegisters();
+        
+        std::cout << "\nХеш " << (kind == HashKind::Murmur3_32 ? "32" : "64")
+                  << " бит, оценка: " << hll_batch.estimate() << std::endl;
+        std::cout << "add():      " << std::fixed << std::setprecision(2)
+                  << (full.size() / scalar_sec / 1e6) << " млн элементов/с" << std::endl;
+        std::cout << "addBatch(): " << (full.size() / batch_sec / 1e6)
+                  << " млн элементов/с (ускорение x" << (scalar_sec / batch_sec) << ")" << std::endl;
+        std::cout << "Регистры совпадают: " << (identical ? "да" : "НЕТ") << std::endl;
+    }
+    
+    // Объединение скетчей двух половин потока
+    std::cout << "\n=== Объединение скетчей ===" << std::endl;
+    HyperLogLog first_half(B, 42);
+    HyperLogLog second_half(B, 42);
+    first_half.addBatch(full.data(), full.size() / 2);
+    second_half.addBatch(full.data() + full.size() / 2, full.size() - full.size() / 2);
+    first_half |= second_half;
+    std::cout << "Оценка объединения: " << first_half.estimate()
+              << ", оценка всего потока: " << hll_analysis.estimate() << std::endl;
+    std::cout << "Регистры совпадают: "
+              << (first_half.getRegisters() == hll_analysis.getRegisters() ? "да" : "НЕТ")
+              << std::endl;
+    
+    // Сериализация: восстановление скетча, view без копирования и
+    // отказ от поврежденной записи
+    std::cout << "\n=== Сериализация ===" << std::endl;
+    std::vector<uint8_t> record = hll_analysis.serialize();
+    HyperLogLog restored = HyperLogLog::deserialize(record.data(), record.size());
+    HyperLogLogView view(record.data(), record.size());
+    std::cout << "Размер записи: " << record.size() << " байт" << std::endl;
+    std::cout << "Восстановленные регистры совпадают: "
+              << (restored.getRegisters() == hll_analysis.getRegisters() ? "да" : "НЕТ")
+              << ", оценка view: " << view.estimate() << std::endl;
+    record[record.size() / 2] ^= 1;
+    try {
+        HyperLogLog::deserialize(record.data(), record.size());
+        std::cout << "Поврежденная запись НЕ обнаружена" << std::endl;
+    } catch (const std::invalid_argument& e) {
+        std::cout << "Поврежденная запись отклонена: " << e.what() << std::endl;
+    }
+    size_t forged_rejected = 0;
+    const auto forged = forgedRecords(B);
+    for (const auto& bad : forged) {
+        try {
+            HyperLogLog::deserialize(bad.data(), bad.size());
+        } catch (const std::invalid_argument&) {
+            ++forged_rejected;
+        }
+    }
+    std::cout << "Записи с верной CRC и недопустимым содержимым отклонены: " << forged_rejected
+              << " из " << forged.size() << std::endl;
+    
+    // Агрегатор (SketchAggregator.h) отбрасывает те же записи, не объединяя
+    // их: одна правильная запись и недопустимые для того же имени
+    std::cout << "\n=== Агрегатор: недопустимые записи ===" << std::endl;
+    {
+        const std::string endpoint = "unix:/tmp/hll_test_stage2.sock";
+        SketchAggregator server(endpoint, B, 42);
+        std::atomic<bool> stop{false};
+        std::thread server_thread([&] { server.run(stop, 10); });
+        try {
+            HyperLogLog valid(B, 42);
+            valid.addBatch(full.data(), 1000);
+            AggregatorClient client(endpoint);
+            client.merge("stream", valid.serialize());
+            for (const auto& bad : forged) {
+                client.merge("stream", bad);
+            }
+            ReplyFrame totals = client.stats();
+            uint64_t remote = client.query("stream");
+            std::cout << "Объединено: " << totals.value << ", отброшено: " << totals.value2
+                      << " из " << forged.size() << ", оценка: " << remote
+                      << (remote == valid.estimate() ? " (совпадает с правильной записью)"
+                                                     : " (РАСХОЖДЕНИЕ)") << std::endl;
+        } catch (const std::exception& e) {
+            std::cout << "Ошибка агрегатора: " << e.what() << std::endl;
+        }
+        stop = true;
+        server_thread.join();
+    }
+    
+    // Окно хранения: интервалы по 1 с, хранятся 2 последних. Запись старше
+    // окна отбрасывается, прошедшие интервалы удаляются вместе со скетчами
+    std::cout << "\n=== Агрегатор: окно хранения ===" << std::endl;
+    {
+        const std::string endpoint = "unix:/tmp/hll_test_stage2.sock";
+        SketchAggregator server(endpoint, B, 42, HashKind::Murmur3_32, 1, 2);
+        std::atomic<bool> stop{false};
+        std::thread server_thread([&] { server.run(stop, 10); });
+        try {
+            HyperLogLog sketch(B, 42);
+            sketch.addBatch(full.data(), 1000);
+            const uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+            AggregatorClient client(endpoint);
+            client.merge("window", sketch.serialize());
+            client.merge("window", sketch.serialize(), now - 60);
+            ReplyFrame totals = client.stats();
+            uint64_t before = client.query("window");
+            std::this_thread::sleep_for(std::chrono::milliseconds(3100));
+            uint64_t after = client.query("window");
+            std::cout << "Объединено: " << totals.value << ", отброшено (старше окна): " << totals.value2
+                      << ", оценка в окне: " << before << ", через 3 с: " << after << std::endl;
+        } catch (const std::exception& e) {
+            std::cout << "Ошибка агрегатора: " << e.what() << std::endl;
+        }
+        stop = true;
+        server_thread.join();
+        std::cout << "Удалено интервалов: " << server.getStats().evicted
+                  << ", скетчей осталось: " << server.sketchCount() << std::endl;
+    }
+    
+    // Смещение и RMSE оценщиков (Estimators.h) по всему диапазону мощностей,
+    // включая переход к линейному счету около 2.5m = 40960
+    std::cout << "\n=== Сравнение оценщиков (B = " << static_cast<int>(B) << ") ===" << std::endl;
+    const std::vector<uint64_t> cardinalities = {
+        100, 1000, 10000, 20000, 30000, 40000, 45000, 50000, 60000, 80000,
+        100000, 300000, 1000000, 3000000, 10000000
+    };
+    const std::vector<Estimator> estimators = {
+        Estimator::Classic, Estimator::Improved, Estimator::MaxLikelihood, Estimator::BiasCorrected
+    };
+    const size_t estimator_runs = 10;
+    // relative_errors[точка][оценщик] - относительные ошибки по прогонам
+    std::vector<std::vector<std::vector<double>>> relative_errors(
+        cardinalities.size(), std::vector<std::vector<double>>(estimators.size()));
+    std::vector<double> estimator_sec(estimators.size(), 0.0);
+    std::vector<uint64_t> keys;
+    for (size_t run = 0; run < estimator_runs; ++run) {
+        HyperLogLog sketch(B, 42);
+        uint64_t inserted = 0;
+        for (size_t p = 0; p < cardinalities.size(); ++p) {
+            keys.clear();
+            for (; inserted < cardinalities[p]; ++inserted) {
+                keys.push_back((run << 40) | inserted);
+            }
+            sketch.addBatch(keys.data(), keys.size());
+            for (size_t e = 0; e < estimators.size(); ++e) {
+                auto start = std::chrono::steady_clock::now();
+                uint64_t estimate = sketch.estimate(estimators[e]);
+                estimator_sec[e] += std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start).count();
+                relative_errors[p][e].push_back(
+                    (static_cast<double>(estimate) - cardinalities[p]) / cardinalities[p]);
+            }
+        }
+    }
+    std::cout << "Смещение / RMSE относительной ошибки, %, по " << estimator_runs
+              << " прогонам" << std::endl;
+    std::cout << std::setw(10) << "n";
+    for (Estimator estimator : estimators) {
+        std::cout << std::setw(16) << estimatorName(estimator);
+    }
+    std::cout << std::endl << std::string(10 + 16 * estimators.size(), '-') << std::endl;
+    for (size_t p = 0; p < cardinalities.size(); ++p) {
+        std::cout << std::setw(10) << cardinalities[p];
+        for (size_t e = 0; e < estimators.size(); ++e) {
+            double bias = 0.0;
+            double squares = 0.0;
+            for (double error : relative_errors[p][e]) {
+                bias += error;
+                squares += error * error;
+            }
+            bias /= estimator_runs;
+            double rmse = std::sqrt(squares / estimator_runs);
+            std::ostringstream cell;
+            cell << std::fixed << std::setprecision(2) << bias * 100 << "/" << rmse * 100;
+            std::cout << std::setw(16) << cell.str();
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "Время оценки, мкс:";
+    for (size_t e = 0; e < estimators.size(); ++e) {
+        std::cout << " " << estimatorName(estimators[e]) << " "
+                  << std::setprecision(2)
+                  << estimator_sec[e] / (estimator_runs * cardinalities.size()) * 1e6;
+    }
+    std::cout << std::endl;
+    
     std::cout << "\n=== Обоснование выбора B = " << static_cast<int>(B) << " ===" << std::endl;
     std::cout << "1. Количество регистров: " << (1 << B) << std::endl;
     std::cout << "2. Память: " << (1 << B) << " байт ≈ " 